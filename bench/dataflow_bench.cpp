@@ -0,0 +1,154 @@
+// DATAFLOW_BENCH.CPP : Micro-benchmark des analyses de flot de données (Dataflow.h)
+// Construit des fonctions synthétiques de plus en plus grosses (dizaines de milliers de blocs et de
+// temporaires, avec des if/else et des boucles) et mesure le temps de chaque analyse.
+// Le temps par bloc de chaque analyse reste à peu près constant quand la taille double : la vivacité et les
+// expressions disponibles ne numérotent que ce qui traverse un bloc, et les définitions atteignantes sont
+// représentées variable par variable (une jonction par frontière de dominance) plutôt qu'en ensembles de
+// toutes les écritures (ici deux par région, qui atteignent presque toute la suite de la fonction).
+//   make bench-dataflow
+//   ./compiler/build/dataflow_bench [nombre_de_régions...]
+
+#include "IR.h"
+#include "DefFonction.h"
+#include "Dataflow.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::to_string;
+using std::vector;
+
+static const int variableCount = 256;
+
+// Relie un bloc à la suite du programme (sortie de boucle si le bloc reboucle déjà)
+static void link(BasicBlock *from, BasicBlock *to)
+{
+    if (from->exit_true)
+        from->exit_false = to;
+    else
+        from->exit_true = to;
+}
+
+// Une région = un if/else suivi d'un bloc de jonction ; toutes les 16 régions, la jonction reboucle
+// sur le début du groupe (boucle) pour que le solveur ait plusieurs itérations à faire
+static CFG *build_function(int regions)
+{
+    CFG *cfg = new CFG(new DefFonction("bench", Type(INT), {}));
+    for (int v = 0; v < variableCount; v++)
+    {
+        cfg->add_to_symbol_table("v" + to_string(v), Type(INT));
+    }
+    auto var = [](int v) { return "!" + to_string(v % variableCount); };
+
+    BasicBlock *entry = new BasicBlock(cfg, "bench_BB_0");
+    for (int v = 0; v < variableCount; v++)
+    {
+        string t = cfg->create_new_tempvar(Type(INT));
+        entry->add_IRInstr(IRInstr::ldconst, Type(INT), {t, to_string(v)});
+        entry->add_IRInstr(IRInstr::wmem, Type(INT), {var(v), t});
+    }
+
+    BasicBlock *previous = entry;
+    BasicBlock *groupHead = nullptr;
+    for (int r = 0; r < regions; r++)
+    {
+        BasicBlock *head = new BasicBlock(cfg, "H" + to_string(r));
+        BasicBlock *thenBB = new BasicBlock(cfg, "T" + to_string(r));
+        BasicBlock *elseBB = new BasicBlock(cfg, "E" + to_string(r));
+        BasicBlock *join = new BasicBlock(cfg, "J" + to_string(r));
+        link(previous, head);
+        if (r % 16 == 0)
+            groupHead = head;
+
+        // Comme dans l'IR de VisitorIR, les temporaires ne vivent que dans leur bloc :
+        // seules les variables traversent les frontières de blocs
+        string t1 = cfg->create_new_tempvar(Type(INT));
+        string t2 = cfg->create_new_tempvar(Type(INT));
+        string t3 = cfg->create_new_tempvar(Type(INT));
+        string t4 = cfg->create_new_tempvar(Type(INT));
+        head->add_IRInstr(IRInstr::rmem, Type(INT), {t1, var(r)});
+        head->add_IRInstr(IRInstr::rmem, Type(INT), {t2, var(r + 7)});
+        head->add_IRInstr(IRInstr::add, Type(INT), {t3, t1, t2});
+        head->add_IRInstr(IRInstr::cmp_lt, Type(INT), {t4, t3, t1});
+        head->test_var_name = t4;
+        head->exit_true = thenBB;
+        head->exit_false = elseBB;
+
+        string t5 = cfg->create_new_tempvar(Type(INT));
+        string t6 = cfg->create_new_tempvar(Type(INT));
+        string t7 = cfg->create_new_tempvar(Type(INT));
+        thenBB->add_IRInstr(IRInstr::rmem, Type(INT), {t5, var(r + 1)});
+        thenBB->add_IRInstr(IRInstr::rmem, Type(INT), {t6, var(r)});
+        thenBB->add_IRInstr(IRInstr::add, Type(INT), {t7, t5, t6});
+        thenBB->add_IRInstr(IRInstr::wmem, Type(INT), {var(r + 1), t7});
+        thenBB->exit_true = join;
+
+        string t9 = cfg->create_new_tempvar(Type(INT));
+        string t10 = cfg->create_new_tempvar(Type(INT));
+        string t11 = cfg->create_new_tempvar(Type(INT));
+        elseBB->add_IRInstr(IRInstr::rmem, Type(INT), {t9, var(r)});
+        elseBB->add_IRInstr(IRInstr::rmem, Type(INT), {t10, var(r + 7)});
+        elseBB->add_IRInstr(IRInstr::add, Type(INT), {t11, t9, t10});
+        elseBB->add_IRInstr(IRInstr::wmem, Type(INT), {var(r + 2), t11});
+        elseBB->exit_true = join;
+
+        string t8 = cfg->create_new_tempvar(Type(INT));
+        join->add_IRInstr(IRInstr::rmem, Type(INT), {t8, var(r + 2)});
+        if (r % 16 == 15)
+        {
+            join->test_var_name = t8;
+            join->exit_true = groupHead; // exit_false : sortie de boucle vers la région suivante
+        }
+        previous = join;
+    }
+
+    // Sortie de la dernière boucle vers le retour
+    BasicBlock *exitBB = new BasicBlock(cfg, "X");
+    string t = cfg->create_new_tempvar(Type(INT));
+    exitBB->add_IRInstr(IRInstr::rmem, Type(INT), {t, var(0)});
+    exitBB->add_IRInstr(IRInstr::ret, Type(INT), {t});
+    link(previous, exitBB);
+    return cfg;
+}
+
+template <typename F>
+static double time_ms(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+    vector<int> sizes;
+    for (int i = 1; i < argc; i++)
+        sizes.push_back(std::atoi(argv[i]));
+    if (sizes.empty())
+        sizes = {2500, 5000, 10000, 20000};
+
+    // En-tête écrit tel quel : std::setw compte les octets, et les accents en occupent deux en UTF-8
+    std::cout << "   blocs  symboles   vivacité ms  déf. att. ms  expr. disp. ms       ns/bloc  itérations" << std::endl;
+    for (int regions : sizes)
+    {
+        CFG *cfg = build_function(regions);
+        size_t blocks = cfg->get_bbs().size();
+        long iterations = 0; // itérations du solveur (les définitions atteignantes n'en ont pas)
+        double live = time_ms([&] { Liveness l(cfg); iterations += l.get_iterations(); });
+        double reach = time_ms([&] { ReachingDefinitions r(cfg); });
+        double avail = time_ms([&] { AvailableExpressions a(cfg); iterations += a.get_iterations(); });
+        double perBlock = (live + reach + avail) * 1e6 / blocks;
+        std::cout << std::setw(8) << blocks << std::setw(10) << cfg->get_symbol_count()
+                  << std::setw(14) << std::fixed << std::setprecision(2) << live
+                  << std::setw(14) << reach << std::setw(16) << avail
+                  << std::setw(14) << std::setprecision(0) << perBlock
+                  << std::setw(12) << iterations << std::endl;
+        delete cfg;
+    }
+    return 0;
+}
@@ -0,0 +1,58 @@
+#!/bin/bash
+# IFCONVERT_BENCH.SH : Mesure l'effet de la passe ifconvert sur les programmes de bench/programs :
+# ifcc -O2 contre le même pipeline sans ifconvert. Avec perf, le nombre d'erreurs de prédiction de
+# branchement est affiché ; sinon seul le temps d'exécution est comparé. Vérifie aussi que les deux
+# binaires ont la même sortie.
+#   make bench-ifconvert
+#   bench/ifconvert_bench.sh [programme.c...]
+# Variables : IFCC (défaut compiler/ifcc), RUNS (défaut 5, on garde le meilleur temps).
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+IFCC=${IFCC:-$ROOT/compiler/ifcc}
+RUNS=${RUNS:-5}
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+# Pipeline -O2 sans ifconvert (retirée par le driver : la référence suit le pipeline de PassManager.cpp)
+WITHOUT="-O2 --disable-pass=ifconvert"
+
+# Meilleur temps (en ms) sur RUNS exécutions ; la sortie de la dernière est gardée dans $1.out
+best_time() {
+    local best=
+    for ((i = 0; i < RUNS; i++)); do
+        local start=$(date +%s%N)
+        "$1" > "$1.out"
+        echo "exit $?" >> "$1.out"
+        local ms=$((($(date +%s%N) - start) / 1000000))
+        if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then best=$ms; fi
+    done
+    echo "$best"
+}
+
+# Erreurs de prédiction de branchement d'une exécution ("-" sans perf)
+branch_misses() {
+    if ! command -v perf > /dev/null; then echo "-"; return; fi
+    perf stat -x, -e branch-misses "$1" 2>&1 > /dev/null | awk -F, '/branch-misses/ { print $1 }'
+}
+
+programs=("$@")
+[ ${#programs[@]} -eq 0 ] && programs=("$ROOT"/bench/programs/*.c)
+
+printf "%-14s %10s %10s %9s %14s %14s\n" "programme" "sans(ms)" "avec(ms)" "speedup" "miss sans" "miss avec"
+status=0
+for src in "${programs[@]}"; do
+    name=$(basename "$src" .c)
+    if ! $IFCC $WITHOUT "$src" > "$WORK/$name.without.s" || ! gcc "$WORK/$name.without.s" -o "$WORK/$name.without" ||
+       ! $IFCC -O2 "$src" > "$WORK/$name.with.s" || ! gcc "$WORK/$name.with.s" -o "$WORK/$name.with"; then
+        echo "$name : échec de la compilation" >&2; status=1; continue
+    fi
+    without=$(best_time "$WORK/$name.without")
+    with=$(best_time "$WORK/$name.with")
+    if ! cmp -s "$WORK/$name.without.out" "$WORK/$name.with.out"; then
+        echo "$name : sorties différentes" >&2; status=1
+    fi
+    awk -v n="$name" -v a="$without" -v b="$with" -v ma="$(branch_misses "$WORK/$name.without")" \
+        -v mb="$(branch_misses "$WORK/$name.with")" \
+        'BEGIN { printf "%-14s %10d %10d %8.2fx %14s %14s\n", n, a, b, a / (b > 0 ? b : 1), ma, mb }'
+done
+exit $status
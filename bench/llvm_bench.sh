@@ -0,0 +1,59 @@
+#!/bin/bash
+# LLVM_BENCH.SH : Compare le temps d'exécution des binaires produits par le back-end natif
+# (ifcc -> assembleur -> gcc) et par le chemin LLVM (ifcc --emit=llvm -> clang -O2)
+# sur les programmes de bench/programs. Vérifie aussi que les deux binaires ont la même sortie.
+#   make bench-llvm
+#   bench/llvm_bench.sh [programme.c...]
+# Variables : IFCC (défaut compiler/ifcc), IFCC_ARGS (ex : -O2), RUNS (défaut 3, on garde le meilleur temps).
+# Sans clang, le .ll est compilé par llc -O2 puis assemblé par gcc.
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+IFCC=${IFCC:-$ROOT/compiler/ifcc}
+IFCC_ARGS=${IFCC_ARGS:-}
+RUNS=${RUNS:-3}
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+if command -v clang > /dev/null; then
+    llvm_build() { clang -O2 -w "$1" -o "$2"; }
+elif command -v llc > /dev/null; then
+    llvm_build() { llc -O2 -relocation-model=pic "$1" -o "$2.s" && gcc "$2.s" -o "$2"; }
+else
+    echo "ni clang ni llc : chemin LLVM indisponible" >&2
+    exit 1
+fi
+
+# Meilleur temps (en ms) sur RUNS exécutions ; la sortie de la dernière est gardée dans $1.out
+best_time() {
+    local best=
+    for ((i = 0; i < RUNS; i++)); do
+        local start=$(date +%s%N)
+        "$1" > "$1.out"
+        echo "exit $?" >> "$1.out"
+        local ms=$((($(date +%s%N) - start) / 1000000))
+        if [ -z "$best" ] || [ "$ms" -lt "$best" ]; then best=$ms; fi
+    done
+    echo "$best"
+}
+
+programs=("$@")
+[ ${#programs[@]} -eq 0 ] && programs=("$ROOT"/bench/programs/*.c)
+
+printf "%-14s %10s %10s %9s\n" "programme" "natif(ms)" "llvm(ms)" "speedup"
+status=0
+for src in "${programs[@]}"; do
+    name=$(basename "$src" .c)
+    if ! $IFCC $IFCC_ARGS "$src" > "$WORK/$name.s" || ! gcc "$WORK/$name.s" -o "$WORK/$name.native"; then
+        echo "$name : échec du back-end natif" >&2; status=1; continue
+    fi
+    if ! $IFCC $IFCC_ARGS --emit=llvm "$src" > "$WORK/$name.ll" || ! llvm_build "$WORK/$name.ll" "$WORK/$name.llvm"; then
+        echo "$name : échec du chemin LLVM" >&2; status=1; continue
+    fi
+    native=$(best_time "$WORK/$name.native")
+    llvm=$(best_time "$WORK/$name.llvm")
+    if ! cmp -s "$WORK/$name.native.out" "$WORK/$name.llvm.out"; then
+        echo "$name : sorties différentes" >&2; status=1
+    fi
+    awk -v n="$name" -v a="$native" -v b="$llvm" 'BEGIN { printf "%-14s %10d %10d %8.1fx\n", n, a, b, a / (b > 0 ? b : 1) }'
+done
+exit $status
@@ -0,0 +1,18 @@
+/* Récursion profonde et imbriquée (fonction d'Ackermann) */
+int ack(int m, int n)
+{
+    if (m == 0)
+    {
+        return n + 1;
+    }
+    if (n == 0)
+    {
+        return ack(m - 1, 1);
+    }
+    return ack(m - 1, ack(m, n - 1));
+}
+
+int main()
+{
+    return ack(3, 10) % 256;
+}
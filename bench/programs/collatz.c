@@ -0,0 +1,36 @@
+/* Arithmétique (division, modulo, multiplication) et branches peu prévisibles
+   (au-delà de 113382, une suite dépasse INT_MAX : la borne reste en dessous) */
+int steps(int n)
+{
+    if (n == 1)
+    {
+        return 0;
+    }
+    if (n % 2 == 0)
+    {
+        return 1 + steps(n / 2);
+    }
+    return 1 + steps(3 * n + 1);
+}
+
+int total(int from, int to)
+{
+    if (from > to)
+    {
+        return 0;
+    }
+    if (to - from < 64)
+    {
+        return steps(from) + total(from + 1, to);
+    }
+    int middle = (from + to) / 2;
+    return total(from, middle) + total(middle + 1, to);
+}
+
+int main()
+{
+    int t = total(1, 100000);
+    putchar(65 + t % 26);
+    putchar(10);
+    return t % 256;
+}
@@ -0,0 +1,54 @@
+/* Petits if/else sur des valeurs pseudo-aléatoires : max, min, valeur absolue et seuil,
+   des branchements imprévisibles que la passe ifconvert remplace par des cmov */
+int noise(int i)
+{
+    int s = (i * 75 + 74) % 65537;
+    s = (((s % 46340) * (s % 46340) + 12345) % 65537);
+    s = (((s % 46340) * (s % 46340) + 12345) % 65537);
+    return s - 32768;
+}
+
+int score(int i)
+{
+    int a = noise(i);
+    int b = noise(i + 40503);
+    int hi;
+    if (a > b)
+        hi = a;
+    else
+        hi = b;
+    int lo;
+    if (a < b)
+        lo = a;
+    else
+        lo = b;
+    int d = a + b;
+    if (d < 0)
+        d = -d;
+    int big = 0;
+    if (d > 16384)
+        big = 1;
+    return (hi - lo) % 1000 + d % 1000 + big;
+}
+
+int total(int from, int to)
+{
+    if (from > to)
+    {
+        return 0;
+    }
+    if (to - from < 64)
+    {
+        return score(from) + total(from + 1, to);
+    }
+    int middle = (from + to) / 2;
+    return total(from, middle) + total(middle + 1, to);
+}
+
+int main()
+{
+    int t = total(1, 1000000);
+    putchar(65 + t % 26);
+    putchar(10);
+    return t % 256;
+}
@@ -0,0 +1,634 @@
+// ANALYSES.CPP : Implémentation des analyses du middle-end (dominateurs, frontières de dominance, boucles,
+// probabilités des branchements, graphe d'appel, effets de bord des fonctions)
+
+#include "Analyses.h"
+#include "PassManager.h"
+#include <algorithm>
+#include <functional>
+
+using std::set;
+
+// ---------------------------------------------------------------------------
+// DominatorTree
+// ---------------------------------------------------------------------------
+
+// Algorithme itératif de Cooper, Harvey et Kennedy ("A Simple, Fast Dominance Algorithm")
+// Les blocs sont numérotés en reverse post-order ; on itère jusqu'au point fixe
+DominatorTree::DominatorTree(const CFG *cfg)
+{
+    rpo = cfg->compute_rpo();
+    int n = rpo.size();
+    for (int i = 0; i < n; i++)
+    {
+        index[rpo[i]] = i;
+    }
+
+    // Prédécesseurs de chaque bloc (en indices rpo)
+    vector<vector<int>> preds(n);
+    for (int i = 0; i < n; i++)
+    {
+        for (BasicBlock *succ : rpo[i]->get_successors())
+        {
+            preds[index[succ]].push_back(i);
+        }
+    }
+
+    idom.assign(n, -1);
+    if (n == 0)
+        return;
+    idom[0] = 0;
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (int b = 1; b < n; b++)
+        {
+            int newIdom = -1;
+            for (int p : preds[b])
+            {
+                if (idom[p] == -1)
+                    continue;
+                if (newIdom == -1)
+                {
+                    newIdom = p;
+                    continue;
+                }
+                // Intersection des deux chemins de dominateurs
+                int f1 = p, f2 = newIdom;
+                while (f1 != f2)
+                {
+                    while (f1 > f2)
+                        f1 = idom[f1];
+                    while (f2 > f1)
+                        f2 = idom[f2];
+                }
+                newIdom = f1;
+            }
+            if (idom[b] != newIdom)
+            {
+                idom[b] = newIdom;
+                changed = true;
+            }
+        }
+    }
+
+    children.assign(n, {});
+    for (int b = 1; b < n; b++)
+    {
+        children[idom[b]].push_back(rpo[b]);
+    }
+
+    // Numérotation pré/post-ordre de l'arbre (parcours itératif)
+    preorder.assign(n, 0);
+    postorder.assign(n, 0);
+    int pre = 0, post = 0;
+    vector<std::pair<int, size_t>> stack = {{0, 0}};
+    preorder[0] = pre++;
+    while (!stack.empty())
+    {
+        int b = stack.back().first;
+        size_t next = stack.back().second++;
+        if (next < children[b].size())
+        {
+            int c = index[children[b][next]];
+            preorder[c] = pre++;
+            stack.push_back({c, 0});
+        }
+        else
+        {
+            postorder[b] = post++;
+            stack.pop_back();
+        }
+    }
+}
+
+BasicBlock *DominatorTree::get_idom(BasicBlock *bb) const
+{
+    auto it = index.find(bb);
+    if (it == index.end() || it->second == 0)
+        return nullptr;
+    return rpo[idom[it->second]];
+}
+
+bool DominatorTree::dominates(BasicBlock *a, BasicBlock *b) const
+{
+    auto ia = index.find(a);
+    auto ib = index.find(b);
+    if (ia == index.end() || ib == index.end())
+        return false;
+    return preorder[ia->second] <= preorder[ib->second] && postorder[ib->second] <= postorder[ia->second];
+}
+
+const vector<BasicBlock *> &DominatorTree::get_children(BasicBlock *bb) const
+{
+    static const vector<BasicBlock *> none;
+    auto it = index.find(bb);
+    if (it == index.end())
+        return none;
+    return children[it->second];
+}
+
+// ---------------------------------------------------------------------------
+// DominanceFrontier
+// ---------------------------------------------------------------------------
+
+// Algorithme de Cooper, Harvey et Kennedy : pour chaque point de jonction B, on remonte l'arbre
+// des dominateurs depuis chaque prédécesseur jusqu'au dominateur immédiat de B ;
+// tous les blocs rencontrés ont B dans leur frontière
+DominanceFrontier::DominanceFrontier(const CFG *cfg, const DominatorTree &domTree)
+{
+    map<BasicBlock *, vector<BasicBlock *>> preds = cfg->compute_predecessors();
+    for (BasicBlock *bb : domTree.get_rpo())
+    {
+        frontier[bb];
+        if (preds[bb].size() < 2)
+            continue;
+        BasicBlock *idom = domTree.get_idom(bb);
+        for (BasicBlock *runner : preds[bb])
+        {
+            while (runner && runner != idom)
+            {
+                vector<BasicBlock *> &df = frontier[runner];
+                if (df.empty() || df.back() != bb)
+                    df.push_back(bb);
+                runner = domTree.get_idom(runner);
+            }
+        }
+    }
+}
+
+const vector<BasicBlock *> &DominanceFrontier::get_frontier(BasicBlock *bb) const
+{
+    static const vector<BasicBlock *> none;
+    auto it = frontier.find(bb);
+    return it != frontier.end() ? it->second : none;
+}
+
+vector<BasicBlock *> DominanceFrontier::get_iterated_frontier(const vector<BasicBlock *> &defs) const
+{
+    vector<BasicBlock *> result;
+    set<BasicBlock *> inResult;
+    vector<BasicBlock *> worklist(defs.begin(), defs.end());
+    set<BasicBlock *> visited(defs.begin(), defs.end());
+    while (!worklist.empty())
+    {
+        BasicBlock *bb = worklist.back();
+        worklist.pop_back();
+        for (BasicBlock *df : get_frontier(bb))
+        {
+            if (inResult.insert(df).second)
+                result.push_back(df);
+            if (visited.insert(df).second)
+                worklist.push_back(df);
+        }
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// LoopInfo
+// ---------------------------------------------------------------------------
+
+// Un arc B -> H est un arc retour si H domine B ; la boucle naturelle de H contient
+// tous les blocs qui atteignent B sans passer par H
+LoopInfo::LoopInfo(const CFG *cfg, const DominatorTree &domTree)
+{
+    map<BasicBlock *, vector<BasicBlock *>> preds = cfg->compute_predecessors();
+    map<BasicBlock *, int> loopOfHeader;
+
+    for (BasicBlock *bb : domTree.get_rpo())
+    {
+        for (BasicBlock *succ : bb->get_successors())
+        {
+            if (!domTree.dominates(succ, bb))
+                continue;
+
+            if (!loopOfHeader.count(succ))
+            {
+                loopOfHeader[succ] = loops.size();
+                loops.push_back(Loop{succ, {succ}, {}});
+            }
+            Loop &loop = loops[loopOfHeader[succ]];
+            loop.latches.push_back(bb);
+
+            vector<BasicBlock *> worklist;
+            if (loop.blocks.insert(bb).second)
+                worklist.push_back(bb);
+            while (!worklist.empty())
+            {
+                BasicBlock *cur = worklist.back();
+                worklist.pop_back();
+                for (BasicBlock *pred : preds[cur])
+                {
+                    if (loop.blocks.insert(pred).second)
+                        worklist.push_back(pred);
+                }
+            }
+        }
+    }
+
+    for (const Loop &loop : loops)
+    {
+        for (BasicBlock *bb : loop.blocks)
+        {
+            depth[bb]++;
+        }
+    }
+}
+
+int LoopInfo::get_loop_depth(BasicBlock *bb) const
+{
+    auto it = depth.find(bb);
+    return it != depth.end() ? it->second : 0;
+}
+
+// ---------------------------------------------------------------------------
+// BranchProbability
+// ---------------------------------------------------------------------------
+
+namespace
+{
+
+const double expectProbability = 0.999;
+const double errorReturnProbability = 0.02;
+const double returnProbability = 0.28;
+const double compareProbability = 0.25;
+const double loopProbability = 0.88;
+const double loopHeaderScale = 8;
+const double coldEdgeProbability = 0.01;
+
+// Combinaison de deux indices indépendants sur la même branche
+double combine(double a, double b)
+{
+    return a * b / (a * b + (1 - a) * (1 - b));
+}
+
+// Valeur constante d'un opérande : littéral, ou variable définie une seule fois par une constante
+bool constant_operand(const string &operand, const map<string, vector<IRInstr *>> &definitions, int32_t &value)
+{
+    if (IRInstr::is_constant(operand))
+    {
+        value = IRInstr::constant_value(operand);
+        return true;
+    }
+    auto it = definitions.find(operand);
+    if (it == definitions.end() || it->second.size() != 1)
+        return false;
+    IRInstr *def = it->second[0];
+    const vector<string> &p = def->get_params();
+    if ((def->get_op() != IRInstr::ldconst && def->get_op() != IRInstr::copy) || !IRInstr::is_constant(p[1]))
+        return false;
+    value = IRInstr::constant_value(p[1]);
+    return true;
+}
+
+// Vrai si bb termine la fonction en retournant une constante négative (code d'erreur)
+bool returns_error(BasicBlock *bb, const map<string, vector<IRInstr *>> &definitions)
+{
+    if (bb->exit_true || bb->instrs.empty() || bb->instrs.back()->get_op() != IRInstr::ret)
+        return false;
+    const vector<string> &p = bb->instrs.back()->get_params();
+    int32_t value;
+    return !p.empty() && constant_operand(p[0], definitions, value) && value < 0;
+}
+
+// Heuristique de comparaison : probabilité que le test de bb soit vrai (0.5 si rien n'est connu)
+double compare_probability(BasicBlock *bb, const map<string, vector<IRInstr *>> &definitions)
+{
+    auto it = definitions.find(bb->test_var_name);
+    if (it == definitions.end() || it->second.size() != 1)
+        return 0.5;
+    IRInstr *cmp = it->second[0];
+    const vector<string> &p = cmp->get_params();
+    int32_t value;
+    bool againstZero = p.size() == 3 && constant_operand(p[2], definitions, value) && value == 0;
+    switch (cmp->get_op())
+    {
+    case IRInstr::cmp_eq:
+        return compareProbability;
+    case IRInstr::cmp_ne:
+        return 1 - compareProbability;
+    case IRInstr::cmp_lt:
+    case IRInstr::cmp_le:
+        return againstZero ? compareProbability : 0.5;
+    case IRInstr::cmp_gt:
+    case IRInstr::cmp_ge:
+        return againstZero ? 1 - compareProbability : 0.5;
+    default:
+        return 0.5;
+    }
+}
+
+} // namespace
+
+BranchProbability::BranchProbability(const CFG *cfg, const DominatorTree &domTree, const LoopInfo &loops)
+{
+    map<string, vector<IRInstr *>> definitions;
+    for (BasicBlock *bb : cfg->get_bbs())
+    {
+        for (IRInstr *instr : bb->instrs)
+        {
+            string dest = instr->get_dest();
+            if (IRInstr::is_symbol(dest))
+                definitions[dest].push_back(instr);
+        }
+    }
+
+    for (BasicBlock *bb : domTree.get_rpo())
+    {
+        if (!bb->exit_false)
+            continue;
+        BasicBlock *t = bb->exit_true;
+        BasicBlock *f = bb->exit_false;
+        double p = 0.5;
+        if (bb->expected_branch == 1)
+            p = combine(p, expectProbability);
+        else if (bb->expected_branch == 0)
+            p = combine(p, 1 - expectProbability);
+
+        bool errorT = returns_error(t, definitions), errorF = returns_error(f, definitions);
+        if (errorT != errorF)
+            p = combine(p, errorT ? errorReturnProbability : 1 - errorReturnProbability);
+        bool returnT = t->exit_true == nullptr, returnF = f->exit_true == nullptr;
+        if (returnT != returnF)
+            p = combine(p, returnT ? returnProbability : 1 - returnProbability);
+        p = combine(p, compare_probability(bb, definitions));
+        for (const Loop &loop : loops.get_loops())
+        {
+            bool inT = loop.blocks.count(t) != 0, inF = loop.blocks.count(f) != 0;
+            if (loop.blocks.count(bb) && inT != inF)
+            {
+                p = combine(p, inT ? loopProbability : 1 - loopProbability);
+                break;
+            }
+        }
+        trueProbability[bb] = p;
+    }
+
+    // Fréquences et blocs froids, le long des arcs avant (un arc retour remonte vers un dominateur)
+    map<BasicBlock *, vector<BasicBlock *>> preds = cfg->compute_predecessors();
+    for (BasicBlock *bb : domTree.get_rpo())
+    {
+        if (bb == cfg->get_entry())
+        {
+            frequency[bb] = 1;
+            continue;
+        }
+        set<BasicBlock *> sources(preds[bb].begin(), preds[bb].end());
+        double freq = 0;
+        bool header = false, reachedHot = false;
+        for (BasicBlock *pred : sources)
+        {
+            if (domTree.dominates(bb, pred))
+            {
+                header = true;
+                continue;
+            }
+            double edge = get_edge_probability(pred, bb);
+            freq += frequency[pred] * edge;
+            if (!cold.count(pred) && edge >= coldEdgeProbability)
+                reachedHot = true;
+        }
+        frequency[bb] = header ? freq * loopHeaderScale : freq;
+        if (!reachedHot)
+            cold.insert(bb);
+    }
+}
+
+double BranchProbability::get_edge_probability(BasicBlock *from, BasicBlock *to) const
+{
+    if (!from->exit_false)
+        return from->exit_true == to ? 1 : 0;
+    auto it = trueProbability.find(from);
+    double p = it != trueProbability.end() ? it->second : 0.5;
+    return (from->exit_true == to ? p : 0) + (from->exit_false == to ? 1 - p : 0);
+}
+
+double BranchProbability::get_frequency(BasicBlock *bb) const
+{
+    auto it = frequency.find(bb);
+    return it != frequency.end() ? it->second : 0;
+}
+
+// ---------------------------------------------------------------------------
+// CallGraph
+// ---------------------------------------------------------------------------
+
+CallGraph::CallGraph(const Module &module)
+{
+    for (const auto &pair : module)
+    {
+        defined.insert(pair.first);
+    }
+    for (const auto &pair : module)
+    {
+        const string &caller = pair.first;
+        callees[caller];
+        for (BasicBlock *bb : pair.second->get_bbs())
+        {
+            for (IRInstr *instr : bb->instrs)
+            {
+                if (instr->get_op() != IRInstr::call)
+                    continue;
+                const string &callee = instr->get_params()[0];
+                callees[caller].insert(callee);
+                callers[callee].insert(caller);
+                callSites[callee]++;
+            }
+        }
+    }
+    compute_sccs();
+}
+
+// Tarjan : une composante est complète quand on revient à sa racine, après toutes celles qu'elle
+// atteint ; elles sortent donc d'elles-mêmes dans l'ordre de bas en haut
+void CallGraph::compute_sccs()
+{
+    map<string, int> index, lowlink;
+    vector<string> stack;
+    set<string> onStack;
+    int next = 0;
+
+    std::function<void(const string &)> visit = [&](const string &f)
+    {
+        index[f] = lowlink[f] = next++;
+        stack.push_back(f);
+        onStack.insert(f);
+        for (const string &g : get_callees(f))
+        {
+            if (!is_defined(g))
+                continue;
+            if (!index.count(g))
+            {
+                visit(g);
+                lowlink[f] = std::min(lowlink[f], lowlink[g]);
+            }
+            else if (onStack.count(g))
+                lowlink[f] = std::min(lowlink[f], index[g]);
+        }
+        if (lowlink[f] != index[f])
+            return;
+        vector<string> scc;
+        string g;
+        do
+        {
+            g = stack.back();
+            stack.pop_back();
+            onStack.erase(g);
+            sccIndex[g] = sccs.size();
+            scc.push_back(g);
+        } while (g != f);
+        sccs.push_back(scc);
+    };
+    for (const string &f : defined)
+    {
+        if (!index.count(f))
+            visit(f);
+    }
+}
+
+bool CallGraph::same_scc(const string &f, const string &g) const
+{
+    auto a = sccIndex.find(f), b = sccIndex.find(g);
+    return a != sccIndex.end() && b != sccIndex.end() && a->second == b->second;
+}
+
+bool CallGraph::is_recursive(const string &f) const
+{
+    auto it = sccIndex.find(f);
+    return it != sccIndex.end() && (sccs[it->second].size() > 1 || get_callees(f).count(f));
+}
+
+const set<string> &CallGraph::get_callees(const string &f) const
+{
+    auto it = callees.find(f);
+    return it != callees.end() ? it->second : empty;
+}
+
+const set<string> &CallGraph::get_callers(const string &f) const
+{
+    auto it = callers.find(f);
+    return it != callers.end() ? it->second : empty;
+}
+
+int CallGraph::get_call_site_count(const string &f) const
+{
+    auto it = callSites.find(f);
+    return it != callSites.end() ? it->second : 0;
+}
+
+// ---------------------------------------------------------------------------
+// Purity
+// ---------------------------------------------------------------------------
+
+string FunctionEffects::describe() const
+{
+    string effects;
+    auto add = [&](bool present, const string &text)
+    {
+        if (present)
+            effects += (effects.empty() ? "" : ", ") + text;
+    };
+    add(readsGlobals, "lit des globales");
+    add(writesGlobals, "écrit des globales");
+    add(readsInput, "lit l'entrée (getchar)");
+    add(writesOutput, "écrit sur la sortie (putchar)");
+    add(callsImpure, "appelle des fonctions à effets de bord");
+    string text = effects.empty() ? "pure" : "effets de bord : " + effects;
+    return text + (mayNotTerminate ? " ; peut ne pas terminer" : " ; termine toujours");
+}
+
+static bool same_effects(const FunctionEffects &a, const FunctionEffects &b)
+{
+    return a.readsGlobals == b.readsGlobals && a.writesGlobals == b.writesGlobals && a.readsInput == b.readsInput &&
+           a.writesOutput == b.writesOutput && a.callsImpure == b.callsImpure && a.mayNotTerminate == b.mayNotTerminate;
+}
+
+Purity::Purity(const Module &module, AnalysisManager &am)
+{
+    const CallGraph &callGraph = am.get_call_graph();
+    unknown.readsGlobals = unknown.writesGlobals = unknown.callsImpure = unknown.mayNotTerminate = true;
+    effects["putchar"].writesOutput = true;
+    effects["getchar"].readsInput = true;
+
+    // Les appelés hors de la composante sont déjà calculés ; dans la composante, les effets ne font
+    // que croître à partir de "aucun effet" jusqu'au point fixe
+    for (const vector<string> &scc : callGraph.get_sccs_bottom_up())
+    {
+        for (const string &f : scc)
+            effects[f] = FunctionEffects();
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+            for (const string &f : scc)
+            {
+                FunctionEffects computed = compute(*module.at(f), am);
+                if (same_effects(computed, effects[f]))
+                    continue;
+                effects[f] = computed;
+                changed = true;
+            }
+        }
+    }
+}
+
+FunctionEffects Purity::compute(CFG &cfg, AnalysisManager &am) const
+{
+    FunctionEffects result;
+    result.mayNotTerminate = am.get_call_graph().is_recursive(cfg.get_name());
+    if (!cfg.get_bbs().empty())
+        result.mayNotTerminate |= !am.get_loops(&cfg).get_loops().empty();
+
+    for (BasicBlock *bb : cfg.get_bbs())
+    {
+        for (IRInstr *instr : bb->instrs)
+        {
+            const vector<string> &p = instr->get_params();
+            switch (instr->get_op())
+            {
+            case IRInstr::rmem:
+                result.readsGlobals |= !IRInstr::is_symbol(p[1]);
+                break;
+            case IRInstr::wmem:
+                result.writesGlobals |= !IRInstr::is_symbol(p[0]);
+                break;
+            case IRInstr::call:
+            {
+                const FunctionEffects &callee = get_effects(p[0]);
+                result.readsGlobals |= callee.readsGlobals;
+                result.writesGlobals |= callee.writesGlobals;
+                if (p[0] == "putchar" || p[0] == "getchar")
+                {
+                    result.writesOutput |= callee.writesOutput;
+                    result.readsInput |= callee.readsInput;
+                }
+                else
+                    result.callsImpure |= callee.readsInput || callee.writesOutput || callee.callsImpure;
+                result.mayNotTerminate |= callee.mayNotTerminate;
+                break;
+            }
+            default:
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+const FunctionEffects &Purity::get_effects(const string &f) const
+{
+    auto it = effects.find(f);
+    return it != effects.end() ? it->second : unknown;
+}
+
+bool Purity::is_pure_call(const IRInstr *instr) const
+{
+    return instr->get_op() == IRInstr::call && get_effects(instr->get_params()[0]).is_pure();
+}
+
+bool Purity::is_removable_call(const IRInstr *instr) const
+{
+    return instr->get_op() == IRInstr::call && get_effects(instr->get_params()[0]).is_removable();
+}
@@ -0,0 +1,202 @@
+// ANALYSES.H : Analyses du middle-end calculées sur le CFG
+// Ces analyses ne modifient pas l'IR : elles sont calculées à la demande par l'AnalysisManager
+// (voir PassManager.h), mises en cache, puis invalidées lorsqu'une passe modifie le CFG.
+//   - DominatorTree : arbre des dominateurs (algorithme itératif de Cooper, Harvey et Kennedy)
+//   - DominanceFrontier : frontières de dominance (placement des phi lors de la construction SSA)
+//   - LoopInfo      : boucles naturelles (arcs retour vers un dominateur)
+//   - BranchProbability : probabilités statiques des branchements, fréquences et blocs froids
+//   - CallGraph     : graphe d'appel du module (qui appelle qui) et ses composantes fortement connexes
+//   - Purity        : effets de bord de chaque fonction (entrées-sorties, globales, terminaison)
+// Les analyses de flot de données (vivacité, définitions atteignantes, expressions disponibles)
+// sont dans Dataflow.h.
+#ifndef ANALYSES_H
+#define ANALYSES_H
+
+#include "IR.h"
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Arbre des dominateurs d'un CFG
+// Un bloc A domine un bloc B si tout chemin de l'entrée vers B passe par A
+class DominatorTree
+{
+public:
+    DominatorTree(const CFG *cfg);
+
+    /** Dominateur immédiat d'un bloc (nullptr pour l'entrée et les blocs inatteignables) */
+    BasicBlock *get_idom(BasicBlock *bb) const;
+    /** Vrai si a domine b (un bloc se domine lui-même) */
+    bool dominates(BasicBlock *a, BasicBlock *b) const;
+    /** Fils d'un bloc dans l'arbre des dominateurs */
+    const vector<BasicBlock *> &get_children(BasicBlock *bb) const;
+    /** Blocs atteignables en reverse post-order (la racine de l'arbre est le premier) */
+    const vector<BasicBlock *> &get_rpo() const { return rpo; }
+    /** Vrai si le bloc est atteignable depuis l'entrée */
+    bool is_reachable(BasicBlock *bb) const { return index.count(bb) != 0; }
+
+private:
+    vector<BasicBlock *> rpo;             // blocs atteignables en reverse post-order
+    map<BasicBlock *, int> index;         // position de chaque bloc dans rpo
+    vector<int> idom;                     // dominateur immédiat (index dans rpo)
+    vector<vector<BasicBlock *>> children; // fils dans l'arbre
+    vector<int> preorder, postorder;      // numérotation de l'arbre pour dominates() en O(1)
+};
+
+// Frontière de dominance : DF(A) contient les blocs B tels que A domine un prédécesseur de B
+// sans dominer strictement B (là où deux définitions de chemins différents se rejoignent)
+class DominanceFrontier
+{
+public:
+    DominanceFrontier(const CFG *cfg, const DominatorTree &domTree);
+
+    /** Frontière de dominance d'un bloc (vide pour un bloc inatteignable) */
+    const vector<BasicBlock *> &get_frontier(BasicBlock *bb) const;
+    /** Frontière itérée d'un ensemble de blocs : les blocs où placer un phi pour une variable définie dans defs */
+    vector<BasicBlock *> get_iterated_frontier(const vector<BasicBlock *> &defs) const;
+
+private:
+    map<BasicBlock *, vector<BasicBlock *>> frontier;
+};
+
+// Boucle naturelle : un en-tête et l'ensemble des blocs qui peuvent y revenir sans repasser par lui
+struct Loop
+{
+    BasicBlock *header;
+    std::set<BasicBlock *> blocks;
+    vector<BasicBlock *> latches; // sources des arcs retour
+};
+
+// Boucles naturelles d'un CFG (le langage n'a pas de boucle, mais les passes peuvent en créer,
+// par exemple l'élimination de la récursion terminale)
+class LoopInfo
+{
+public:
+    LoopInfo(const CFG *cfg, const DominatorTree &domTree);
+
+    const vector<Loop> &get_loops() const { return loops; }
+    /** Nombre de boucles contenant le bloc (0 si le bloc n'est dans aucune boucle) */
+    int get_loop_depth(BasicBlock *bb) const;
+
+private:
+    vector<Loop> loops;
+    map<BasicBlock *, int> depth;
+};
+
+// Probabilités statiques des branchements (heuristiques de Ball et Larus, sans profil d'exécution)
+// Chaque heuristique qui s'applique donne une probabilité pour la branche vraie ; elles sont combinées
+// comme des indices indépendants :
+//   - __builtin_expect : la branche annoncée est prise à 99,9 %
+//   - retour d'erreur : une branche qui retourne une constante négative est prise à 2 %
+//   - retour : une branche qui quitte la fonction (et pas l'autre) est prise à 28 %
+//   - comparaison : x == y est vrai à 25 % (x != y à 75 %), x < 0 et x <= 0 à 25 %, x > 0 et x >= 0 à 75 %
+//   - boucle : la branche qui reste dans la boucle est prise à 88 %
+// Les fréquences des blocs (relatives à l'entrée) suivent les arcs avant en reverse post-order ;
+// l'en-tête d'une boucle est multiplié par 8 (nombre moyen d'itérations pour une sortie à 12 %).
+// Un bloc est froid quand il n'est atteint que par des arcs improbables (moins de 1 %) ou depuis des
+// blocs froids : seuls __builtin_expect et les retours d'erreur rendent du code froid.
+class BranchProbability
+{
+public:
+    BranchProbability(const CFG *cfg, const DominatorTree &domTree, const LoopInfo &loops);
+
+    /** Probabilité de l'arc from -> to (1 pour un saut inconditionnel, 0 si to n'est pas un successeur) */
+    double get_edge_probability(BasicBlock *from, BasicBlock *to) const;
+    /** Fréquence estimée d'un bloc, l'entrée valant 1 */
+    double get_frequency(BasicBlock *bb) const;
+    /** Vrai si le bloc n'est exécuté que sur un chemin improbable (jamais l'entrée) */
+    bool is_cold(BasicBlock *bb) const { return cold.count(bb) != 0; }
+
+private:
+    map<BasicBlock *, double> trueProbability; // blocs terminés par un branchement conditionnel
+    map<BasicBlock *, double> frequency;
+    std::set<BasicBlock *> cold;
+};
+
+// Graphe d'appel du module : arcs appelant -> appelé, avec le nombre de sites d'appel
+// Les composantes fortement connexes (algorithme de Tarjan) regroupent les fonctions mutuellement
+// récursives ; elles sont rangées de bas en haut, chaque appelé avant ses appelants
+class CallGraph
+{
+public:
+    CallGraph(const Module &module);
+
+    /** Fonctions appelées par f (y compris les fonctions externes comme putchar) */
+    const std::set<string> &get_callees(const string &f) const;
+    /** Fonctions du module qui appellent f */
+    const std::set<string> &get_callers(const string &f) const;
+    /** Nombre d'instructions call vers f dans tout le module */
+    int get_call_site_count(const string &f) const;
+    /** Vrai si f est défini dans le module (faux pour putchar/getchar) */
+    bool is_defined(const string &f) const { return defined.count(f) != 0; }
+    /** Composantes fortement connexes des fonctions du module, de bas en haut (appelés d'abord) */
+    const vector<vector<string>> &get_sccs_bottom_up() const { return sccs; }
+    /** Vrai si f et g sont dans la même composante (appels mutuellement récursifs, ou f == g) */
+    bool same_scc(const string &f, const string &g) const;
+    /** Vrai si f peut s'appeler elle-même, directement ou à travers d'autres fonctions */
+    bool is_recursive(const string &f) const;
+
+private:
+    std::set<string> defined;
+    vector<vector<string>> sccs;
+    map<string, size_t> sccIndex;
+    map<string, std::set<string>> callees;
+    map<string, std::set<string>> callers;
+    map<string, int> callSites;
+    std::set<string> empty;
+
+    void compute_sccs();
+};
+
+class AnalysisManager;
+
+// Effets d'une fonction, y compris ceux des fonctions qu'elle appelle
+struct FunctionEffects
+{
+    bool readsGlobals = false;
+    bool writesGlobals = false;
+    bool readsInput = false;      // appelle getchar
+    bool writesOutput = false;    // appelle putchar
+    bool callsImpure = false;     // appelle une fonction qui a des effets de bord
+    bool mayNotTerminate = false; // boucle, récursion, ou appel d'une fonction qui peut ne pas terminer
+
+    /** Sans effet de bord ni lecture de globale : le résultat ne dépend que des arguments */
+    bool is_pure() const { return !readsGlobals && !writesGlobals && !readsInput && !writesOutput && !callsImpure; }
+    /** Pure et termine toujours : un appel peut être supprimé ou déplacé */
+    bool is_removable() const { return is_pure() && !mayNotTerminate; }
+    /** Description pour --remarks ("pure", ou la liste des effets) */
+    string describe() const;
+};
+
+// Effets de bord des fonctions du module, calculés de bas en haut sur les composantes du graphe d'appel
+// (les fonctions d'une même composante sont itérées jusqu'au point fixe). Deux appels d'une fonction
+// pure avec les mêmes arguments donnent le même résultat ; l'appel d'une fonction pure qui termine
+// peut de plus être supprimé si son résultat est inutilisé, ou exécuté plus tôt. Une boucle ou une
+// récursion rend la terminaison inconnue. putchar écrit la sortie, getchar lit l'entrée ; une autre
+// fonction externe a tous les effets. Les globales ne sont pas traduites par VisitorIR : un rmem ou un
+// wmem dont l'opérande n'est pas une case du cadre (!N) serait un accès global.
+// Une passe de fonction n'ajoute pas d'appel ; tailrec crée une boucle, mais à la place d'une récursion
+// qui rendait déjà la terminaison inconnue. Les effets ne peuvent donc que diminuer, et le résultat
+// reste valide (prudent) jusqu'à la prochaine passe de module. Le graphe d'appel et les boucles de
+// chaque fonction viennent du cache de l'AnalysisManager.
+class Purity
+{
+public:
+    Purity(const Module &module, AnalysisManager &am);
+
+    /** Effets de f (fonction du module ou externe) */
+    const FunctionEffects &get_effects(const string &f) const;
+    /** Vrai si instr est un appel d'une fonction pure (deux appels identiques sont fusionnables) */
+    bool is_pure_call(const IRInstr *instr) const;
+    /** Vrai si instr est un appel d'une fonction pure qui termine (supprimable ou déplaçable) */
+    bool is_removable_call(const IRInstr *instr) const;
+
+private:
+    map<string, FunctionEffects> effects;
+    FunctionEffects unknown; // fonction externe inconnue
+
+    FunctionEffects compute(CFG &cfg, AnalysisManager &am) const;
+};
+
+#endif
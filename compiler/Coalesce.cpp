@@ -0,0 +1,280 @@
+// COALESCE.CPP : Fusion des copies (passe "coalesce", après out-of-ssa)
+// out-of-ssa remplace chaque phi par des copies à la fin des prédécesseurs : sans fusion, une boucle
+// paie à chaque tour une lecture et une écriture en mémoire par variable modifiée.
+// "copy x, y" disparaît si x et y peuvent partager le même emplacement, c'est-à-dire si leurs durées
+// de vie n'interfèrent pas (Chaitin) :
+//   - le graphe d'interférence est construit à partir de la vivacité : une définition de d interfère
+//     avec toutes les variables vivantes juste après elle, sauf la source si c'est une copie de
+//     cette source (elles contiennent alors la même valeur)
+//   - deux variables fusionnées n'en forment plus qu'une, qui hérite des interférences des deux
+//   - toutes les occurrences sont renommées vers le représentant, et les copies "copy x, x"
+//     devenues inutiles sont supprimées
+// Les emplacements de la pile sont ensuite réattribués (coloration gloutonne du même graphe) : seules
+// les variables encore utilisées en reçoivent un, et deux variables qui n'interfèrent pas partagent le
+// même. Sans cela, le cadre garde un emplacement par temporaire créé depuis VisitorIR (mem2reg, inline,
+// out-of-ssa) et devient plus grand qu'à -O0. Certaines variables gardent un emplacement à elles seules :
+//   - une variable lue avant d'être écrite, qui vaut toujours 0 dans l'interpréteur et le JIT
+//   - un temporaire défini par un unique ldconst : gen_asm reconnaît la case constante et réduit la
+//     multiplication, la division ou le modulo qui la lit (CFG::get_constant_slot)
+//   - une comparaison lue une seule fois : gen_asm la fusionne avec le branchement ou le select qui la
+//     lit (CFG::get_use_count)
+// Les registres physiques (paramètres) et les constantes ne sont jamais fusionnés. La passe ne fait
+// rien sur un CFG qui contient encore des phi.
+
+#include "Passes.h"
+#include <algorithm>
+#include <set>
+
+namespace
+{
+
+class CoalescePass : public FunctionPass
+{
+public:
+    string get_name() const override { return "coalesce"; }
+    bool preserves_cfg() const override { return true; }
+
+    bool run_on_function(CFG &cfg, AnalysisManager &am) override
+    {
+        if (cfg.get_bbs().empty())
+            return false;
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            for (IRInstr *instr : bb->instrs)
+            {
+                if (instr->get_op() == IRInstr::phi)
+                    return false;
+            }
+        }
+
+        interference.clear();
+        representative.clear();
+        const Liveness &liveness = am.get_liveness(&cfg);
+        vector<IRInstr *> copies = build_interference(cfg, liveness);
+        vector<string> liveIn = liveness.get_live_in_vars(cfg.get_entry());
+
+        bool merged = false;
+        for (IRInstr *copy : copies)
+        {
+            string x = find(copy->get_params()[0]);
+            string y = find(copy->get_params()[1]);
+            if (x == y || interference[x].count(y) || !PassManager::consume_fuel(get_name()))
+                continue;
+            // Le plus petit numéro reste : une variable du programme garde son nom
+            if (std::stoi(y.substr(1)) < std::stoi(x.substr(1)))
+                std::swap(x, y);
+            merge(x, y);
+            merged = true;
+        }
+        if (merged)
+            remove_copies(cfg);
+
+        std::set<string> exclusive = exclusive_vars(cfg);
+        for (const string &var : liveIn)
+            exclusive.insert(find(var));
+        return assign_slots(cfg, exclusive) || merged;
+    }
+
+private:
+    map<string, std::set<string>> interference; // représentant -> représentants avec qui il interfère
+    map<string, string> representative;         // variable fusionnée -> variable qui la remplace
+
+    // Renomme chaque variable vers son représentant et supprime les copies "copy x, x"
+    void remove_copies(CFG &cfg)
+    {
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            vector<IRInstr *> kept;
+            for (IRInstr *instr : bb->instrs)
+            {
+                vector<string> &p = instr->get_params();
+                for (string &operand : p)
+                {
+                    if (IRInstr::is_symbol(operand))
+                        operand = find(operand);
+                }
+                if (instr->get_op() == IRInstr::copy && p[0] == p[1])
+                {
+                    delete instr;
+                    continue;
+                }
+                kept.push_back(instr);
+            }
+            bb->instrs = kept;
+            if (bb->exit_false && IRInstr::is_symbol(bb->test_var_name))
+                bb->test_var_name = find(bb->test_var_name);
+        }
+    }
+
+    // Constantes et comparaisons fusionnables : les partager ferait repasser gen_asm par idiv ou setcc
+    static std::set<string> exclusive_vars(const CFG &cfg)
+    {
+        map<string, int> definitions, uses;
+        map<string, IRInstr::Operation> definedBy;
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            for (IRInstr *instr : bb->instrs)
+            {
+                for (size_t i : instr->get_use_indices())
+                    uses[instr->get_params()[i]]++;
+                string dest = instr->get_dest();
+                if (!IRInstr::is_symbol(dest))
+                    continue;
+                definitions[dest]++;
+                definedBy[dest] = instr->get_op();
+            }
+            if (bb->exit_false)
+                uses[bb->test_var_name]++;
+        }
+        std::set<string> exclusive;
+        for (const auto &def : definitions)
+        {
+            IRInstr::Operation op = definedBy[def.first];
+            if (def.second == 1 && (op == IRInstr::ldconst || (IRInstr::is_comparison(op) && uses[def.first] == 1)))
+                exclusive.insert(def.first);
+        }
+        return exclusive;
+    }
+
+    // Attribue les emplacements dans l'ordre des index (les paramètres et les variables du programme
+    // restent en tête) : chaque variable prend le premier emplacement qu'aucun de ses voisins n'occupe ;
+    // une variable de exclusive reçoit un emplacement neuf, que personne ne reprend
+    bool assign_slots(CFG &cfg, const std::set<string> &exclusive)
+    {
+        std::set<int> used;
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            for (IRInstr *instr : bb->instrs)
+            {
+                for (const string &operand : instr->get_params())
+                {
+                    if (IRInstr::is_symbol(operand))
+                        used.insert(std::stoi(operand.substr(1)));
+                }
+            }
+            if (bb->exit_false && IRInstr::is_symbol(bb->test_var_name))
+                used.insert(std::stoi(bb->test_var_name.substr(1)));
+        }
+
+        // Un opérande peut dépasser la table des symboles (le "ret !0" d'un return sans valeur)
+        int count = cfg.get_symbol_count();
+        if (!used.empty())
+            count = std::max(count, *used.rbegin() + 1);
+        vector<int> slot(count, -1);
+        vector<bool> shared; // emplacement -> peut recevoir une autre variable
+        int sharing = 0;
+        for (int index : used)
+        {
+            string var = "!" + std::to_string(index);
+            std::set<int> taken;
+            for (const string &other : interference[var])
+            {
+                int otherIndex = std::stoi(other.substr(1));
+                if (otherIndex < index && slot[otherIndex] >= 0)
+                    taken.insert(slot[otherIndex]);
+            }
+            int s = 0;
+            if (!exclusive.count(var))
+            {
+                while (s < (int)shared.size() && (!shared[s] || taken.count(s)))
+                    s++;
+            }
+            else
+                s = shared.size();
+            if (s < (int)shared.size() && !PassManager::consume_fuel(get_name()))
+                s = shared.size();
+            if (s == (int)shared.size())
+                shared.push_back(!exclusive.count(var));
+            else
+                sharing++;
+            slot[index] = s;
+        }
+
+        bool identity = (int)shared.size() == count;
+        for (int index = 0; index < count && identity; index++)
+            identity = slot[index] == index;
+        if (identity)
+            return false;
+        cfg.renumber_symbols(slot);
+        PassManager::remark(get_name(), cfg,
+                            std::to_string(shared.size()) + " emplacement(s) de pile au lieu de " +
+                                std::to_string(count) + " (" + std::to_string(sharing) + " partagé(s))");
+        return true;
+    }
+
+    string find(const string &var)
+    {
+        auto it = representative.find(var);
+        if (it == representative.end())
+            return var;
+        string root = find(it->second);
+        it->second = root;
+        return root;
+    }
+
+    void add_edge(const string &a, const string &b)
+    {
+        interference[a].insert(b);
+        interference[b].insert(a);
+    }
+
+    // Parcours de chaque bloc à rebours depuis les variables vivantes en sortie ; renvoie les copies
+    // candidates (entre deux variables), dans l'ordre du CFG
+    vector<IRInstr *> build_interference(CFG &cfg, const Liveness &liveness)
+    {
+        vector<IRInstr *> copies;
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            vector<string> liveOut = liveness.get_live_out_vars(bb);
+            std::set<string> live(liveOut.begin(), liveOut.end());
+            if (bb->exit_false && IRInstr::is_symbol(bb->test_var_name))
+                live.insert(bb->test_var_name);
+
+            size_t firstCopy = copies.size();
+            for (auto it = bb->instrs.rbegin(); it != bb->instrs.rend(); ++it)
+            {
+                IRInstr *instr = *it;
+                const vector<string> &p = instr->get_params();
+                bool isCopy = instr->get_op() == IRInstr::copy && IRInstr::is_symbol(p[1]);
+                string dest = instr->get_dest();
+                if (IRInstr::is_symbol(dest))
+                {
+                    for (const string &var : live)
+                    {
+                        if (var != dest && !(isCopy && var == p[1]))
+                            add_edge(dest, var);
+                    }
+                    live.erase(dest);
+                }
+                for (size_t i : instr->get_use_indices())
+                {
+                    if (IRInstr::is_symbol(p[i]))
+                        live.insert(p[i]);
+                }
+                if (isCopy && p[0] != p[1])
+                    copies.push_back(instr);
+            }
+            std::reverse(copies.begin() + firstCopy, copies.end());
+        }
+        return copies;
+    }
+
+    // y est remplacée par x, qui hérite de ses interférences
+    void merge(const string &x, const string &y)
+    {
+        for (const string &other : interference[y])
+        {
+            interference[other].erase(y);
+            add_edge(x, other);
+        }
+        interference.erase(y);
+        representative[y] = x;
+    }
+};
+
+} // namespace
+
+FunctionPass *createCoalescePass()
+{
+    return new CoalescePass();
+}
@@ -0,0 +1,91 @@
+// COPYPROP.CPP : Propagation des copies (passe "copyprop")
+// Les copies viennent de partout : le + unaire, les déclarations et affectations (d'abord des wmem,
+// devenues des copy après mem2reg), le return qui copie sa valeur dans la variable de retour, et les
+// simplifications de instcombine, lvn et gvn. Sans cette passe, chaque maillon d'une chaîne
+// a = b; c = a; return c; coûte une lecture et une écriture en mémoire à la génération de code.
+// Sur la forme SSA, "copy d, s" donne à d la même valeur que s partout où d est lue (la définition
+// de s domine celle de d, donc toutes ses utilisations) :
+//   - chaque utilisation de d (phi et variables de test comprises) lit directement la source au bout
+//     de la chaîne de copies, et la copie est supprimée
+//   - seules les copies d'une valeur SSA sont propagées : un registre physique (paramètre) ou une
+//     constante littérale ne peuvent pas être l'opérande d'une opération arithmétique
+// Les copies qui restent après out-of-ssa (celles des phi) sont fusionnées par la passe coalesce.
+
+#include "Passes.h"
+#include <set>
+
+namespace
+{
+
+class CopyPropPass : public FunctionPass
+{
+public:
+    string get_name() const override { return "copyprop"; }
+    bool preserves_cfg() const override { return true; }
+
+    bool run_on_function(CFG &cfg, AnalysisManager &am) override
+    {
+        if (cfg.get_bbs().empty() || !cfg.is_ssa())
+            return false;
+
+        source.clear();
+        std::set<IRInstr *> propagated;
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            for (IRInstr *instr : bb->instrs)
+            {
+                const vector<string> &p = instr->get_params();
+                if (instr->get_op() != IRInstr::copy || !IRInstr::is_symbol(p[1]) || p[0] == p[1])
+                    continue;
+                if (!PassManager::consume_fuel(get_name()))
+                    continue;
+                source[p[0]] = p[1];
+                propagated.insert(instr);
+            }
+        }
+        if (propagated.empty())
+            return false;
+
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            vector<IRInstr *> kept;
+            for (IRInstr *instr : bb->instrs)
+            {
+                if (propagated.count(instr))
+                {
+                    delete instr;
+                    continue;
+                }
+                for (size_t i : instr->get_use_indices())
+                    rename(instr->get_params()[i]);
+                kept.push_back(instr);
+            }
+            bb->instrs = kept;
+            if (bb->exit_false)
+                rename(bb->test_var_name);
+        }
+        return true;
+    }
+
+private:
+    map<string, string> source; // destination d'une copie propagée -> sa source
+
+    // Remonte la chaîne de copies jusqu'à la valeur d'origine
+    void rename(string &operand) const
+    {
+        for (size_t steps = 0; steps <= source.size(); steps++)
+        {
+            auto it = source.find(operand);
+            if (it == source.end())
+                return;
+            operand = it->second;
+        }
+    }
+};
+
+} // namespace
+
+FunctionPass *createCopyPropPass()
+{
+    return new CopyPropPass();
+}
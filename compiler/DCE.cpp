@@ -0,0 +1,119 @@
+// DCE.CPP : Élimination du code mort (passe "dce")
+// Deux sortes de code mort :
+//   - les blocs inatteignables depuis l'entrée : branche supprimée par sccp, ou bloc ouvert après un
+//     return dans un IR relu par ifcc-opt (VisitorIR retire déjà les siens). Les phi perdent les
+//     valeurs qui en venaient.
+//   - les instructions dont le résultat n'est jamais lu, comme "a+b;" ou les calculs devenus inutiles
+//     après les simplifications des autres passes
+// Le second cas est un marquage-balayage : sont vivants les appels et les return (effets de bord ;
+// l'appel d'une fonction pure qui termine toujours n'en a pas, voir Purity),
+// les variables de test des branchements, puis de proche en proche toutes les définitions d'une
+// variable lue par une instruction vivante ; le reste est supprimé. Une variable écrite par wmem
+// n'est vivante que si elle est relue, ce qui permet à la passe de travailler aussi hors SSA.
+// Avec --remarks, le nombre d'instructions et de blocs supprimés est affiché pour chaque fonction.
+
+#include "Passes.h"
+#include <set>
+
+namespace
+{
+
+class DCEPass : public FunctionPass
+{
+public:
+    string get_name() const override { return "dce"; }
+
+    bool run_on_function(CFG &cfg, AnalysisManager &am) override
+    {
+        if (cfg.get_bbs().empty())
+            return false;
+
+        int removedBlocks = cfg.remove_unreachable_bbs();
+        if (removedBlocks > 0)
+            cfg.prune_phis();
+        int removedCalls = 0;
+        int removedInstrs = sweep(cfg, mark(cfg, am.get_purity()), removedCalls);
+
+        if (removedBlocks > 0 || removedInstrs > 0)
+        {
+            string calls = removedCalls > 0 ? " (dont " + std::to_string(removedCalls) + " appel(s) pur(s))" : "";
+            PassManager::remark(get_name(), cfg, std::to_string(removedInstrs) + " instruction(s)" + calls + " et " +
+                                                     std::to_string(removedBlocks) + " bloc(s) inatteignable(s) supprimés");
+        }
+        return removedBlocks > 0 || removedInstrs > 0;
+    }
+
+private:
+    // Instructions vivantes : effets de bord, puis définitions des opérandes lus par une instruction vivante
+    std::set<IRInstr *> mark(CFG &cfg, const Purity &purity)
+    {
+        map<string, vector<IRInstr *>> definitions;
+        vector<IRInstr *> worklist;
+        std::set<IRInstr *> live;
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            for (IRInstr *instr : bb->instrs)
+            {
+                string dest = instr->get_dest();
+                if (IRInstr::is_symbol(dest))
+                    definitions[dest].push_back(instr);
+                if (instr->has_side_effects() && !purity.is_removable_call(instr) && live.insert(instr).second)
+                    worklist.push_back(instr);
+            }
+        }
+
+        std::set<string> usedVars;
+        auto use = [&](const string &var) {
+            if (!IRInstr::is_symbol(var) || !usedVars.insert(var).second)
+                return;
+            for (IRInstr *def : definitions[var])
+            {
+                if (live.insert(def).second)
+                    worklist.push_back(def);
+            }
+        };
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            if (bb->exit_false)
+                use(bb->test_var_name);
+        }
+        while (!worklist.empty())
+        {
+            IRInstr *instr = worklist.back();
+            worklist.pop_back();
+            for (size_t i : instr->get_use_indices())
+                use(instr->get_params()[i]);
+        }
+        return live;
+    }
+
+    // Supprime les instructions non marquées ; retourne leur nombre (removedCalls : appels purs supprimés)
+    int sweep(CFG &cfg, const std::set<IRInstr *> &live, int &removedCalls)
+    {
+        int removed = 0;
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            vector<IRInstr *> kept;
+            for (IRInstr *instr : bb->instrs)
+            {
+                if (live.count(instr) || !PassManager::consume_fuel(get_name()))
+                {
+                    kept.push_back(instr);
+                    continue;
+                }
+                removedCalls += instr->get_op() == IRInstr::call;
+                delete instr;
+                removed++;
+            }
+            bb->instrs = kept;
+        }
+        return removed;
+    }
+};
+
+} // namespace
+
+FunctionPass *createDCEPass()
+{
+    return new DCEPass();
+}
@@ -0,0 +1,278 @@
+// DSE.CPP : Élimination des écritures mortes et transfert écriture -> lecture (passe "dse")
+// Travaille sur l'IR en mémoire construit par VisitorIR, où chaque variable "!N" est une case de pile
+// écrite par wmem et relue par rmem ; chaque accès coûte une écriture ou une lecture en mémoire
+// dans l'assembleur x86 comme ARM.
+//   1. dans chaque bloc :
+//      - une relecture "rmem t, !v" d'une case dont la valeur est déjà dans un temporaire (écrite
+//        par "wmem !v, x" ou lue plus haut) devient "copy t, x", et les instructions suivantes du
+//        bloc lisent directement x
+//      - une écriture écrasée plus loin dans le bloc sans avoir été relue entre-temps
+//        (a = 1; a = 2;) est supprimée
+//   2. sur toute la fonction :
+//      - définitions atteignantes : si toutes les écritures qui atteignent une lecture stockent la
+//        même constante, ou le même temporaire défini une seule fois (fonction sans boucle : il ne
+//        peut pas avoir été recalculé entre l'écriture et la lecture), la lecture est remplacée
+//      - vivacité : une écriture dans une case qui n'est plus relue ensuite est supprimée
+// Les variables n'ont jamais leur adresse prise : un appel ne lit ni n'écrit les cases de l'appelant.
+// Les copies et temporaires devenus inutiles sont laissés à la passe dce. Après mem2reg, il n'y a
+// plus de rmem/wmem et la passe ne fait rien. Avec --remarks, les lectures remplacées et les écritures
+// supprimées sont comptées pour chaque fonction.
+
+#include "Passes.h"
+#include <set>
+
+namespace
+{
+
+class DSEPass : public FunctionPass
+{
+public:
+    string get_name() const override { return "dse"; }
+    bool preserves_cfg() const override { return true; }
+
+    bool run_on_function(CFG &cfg, AnalysisManager &am) override
+    {
+        if (!has_memory_accesses(cfg))
+            return false;
+
+        forwardedLoads = 0;
+        removedStores = 0;
+        bool changed = false;
+        for (BasicBlock *bb : cfg.get_bbs())
+            changed |= forward_in_block(bb);
+        if (changed)
+            am.invalidate(&cfg, true);
+
+        bool globalChanged = forward_globally(cfg, am);
+        if (globalChanged)
+            am.invalidate(&cfg, true);
+        globalChanged |= remove_dead_stores(cfg, am.get_liveness(&cfg));
+        if (forwardedLoads > 0 || removedStores > 0)
+            PassManager::remark(get_name(), cfg, std::to_string(forwardedLoads) + " lecture(s) remplacée(s), " +
+                                                     std::to_string(removedStores) + " écriture(s) morte(s) supprimée(s)");
+        return changed || globalChanged;
+    }
+
+private:
+    int forwardedLoads = 0;
+    int removedStores = 0;
+
+    static bool has_memory_accesses(CFG &cfg)
+    {
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            for (IRInstr *instr : bb->instrs)
+            {
+                if (instr->get_op() == IRInstr::rmem || instr->get_op() == IRInstr::wmem)
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    // Oublie tout ce qui reposait sur l'ancienne valeur de name
+    static void forget(const string &name, map<string, string> &known, map<string, string> &forward)
+    {
+        known.erase(name);
+        forward.erase(name);
+        for (auto it = known.begin(); it != known.end();)
+            it = (it->second == name) ? known.erase(it) : std::next(it);
+        for (auto it = forward.begin(); it != forward.end();)
+            it = (it->second == name) ? forward.erase(it) : std::next(it);
+    }
+
+    // Phase locale : transfert écriture -> lecture et écritures écrasées dans le bloc
+    bool forward_in_block(BasicBlock *bb)
+    {
+        map<string, string> known;        // case -> temporaire qui contient sa valeur actuelle
+        map<string, string> forward;      // temporaire remplacé -> temporaire à lire à sa place
+        map<string, IRInstr *> unread;    // case -> dernière écriture pas encore relue
+        std::set<IRInstr *> deadStores;
+        bool changed = false;
+
+        for (IRInstr *instr : bb->instrs)
+        {
+            vector<string> &p = instr->get_params();
+            IRInstr::Operation op = instr->get_op();
+            for (size_t i : instr->get_use_indices())
+            {
+                auto it = forward.find(p[i]);
+                if (op != IRInstr::rmem && it != forward.end())
+                    p[i] = it->second;
+                unread.erase(p[i]); // lecture de la case (rmem, ou lecture directe comme "ret !0")
+            }
+
+            if (op == IRInstr::rmem)
+            {
+                auto it = known.find(p[1]);
+                if (it != known.end() && PassManager::consume_fuel(get_name()))
+                {
+                    string dest = p[0], source = it->second;
+                    instr->set_op(IRInstr::copy);
+                    p = {dest, source};
+                    forget(dest, known, forward);
+                    forward[dest] = source;
+                    forwardedLoads++;
+                    changed = true;
+                    continue;
+                }
+                string var = p[1];
+                forget(p[0], known, forward);
+                known[var] = p[0];
+                continue;
+            }
+            if (op == IRInstr::wmem)
+            {
+                auto previous = unread.find(p[0]);
+                if (previous != unread.end() && PassManager::consume_fuel(get_name()))
+                {
+                    deadStores.insert(previous->second);
+                    removedStores++;
+                }
+                forget(p[0], known, forward);
+                if (IRInstr::is_symbol(p[1]))
+                    known[p[0]] = p[1];
+                unread[p[0]] = instr;
+                continue;
+            }
+            string dest = instr->get_dest();
+            if (IRInstr::is_symbol(dest))
+            {
+                forget(dest, known, forward);
+                unread.erase(dest);
+            }
+        }
+        if (bb->exit_false)
+        {
+            auto it = forward.find(bb->test_var_name);
+            if (it != forward.end())
+                bb->test_var_name = it->second;
+        }
+
+        if (!deadStores.empty())
+        {
+            vector<IRInstr *> kept;
+            for (IRInstr *instr : bb->instrs)
+            {
+                if (deadStores.count(instr))
+                    delete instr;
+                else
+                    kept.push_back(instr);
+            }
+            bb->instrs = kept;
+            changed = true;
+        }
+        return changed;
+    }
+
+    // Phase globale : lectures dont toutes les écritures atteignantes stockent la même valeur
+    bool forward_globally(CFG &cfg, AnalysisManager &am)
+    {
+        map<string, vector<IRInstr *>> definitions;
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            for (IRInstr *instr : bb->instrs)
+            {
+                string dest = instr->get_dest();
+                if (IRInstr::is_symbol(dest))
+                    definitions[dest].push_back(instr);
+            }
+        }
+        auto single_definition = [&](const string &name) -> IRInstr * {
+            auto it = definitions.find(name);
+            return (it != definitions.end() && it->second.size() == 1) ? it->second[0] : nullptr;
+        };
+        bool acyclic = am.get_loops(&cfg).get_loops().empty();
+        ReachingDefinitions &reaching = am.get_reaching_definitions(&cfg);
+
+        bool changed = false;
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            for (IRInstr *instr : bb->instrs)
+            {
+                if (instr->get_op() != IRInstr::rmem)
+                    continue;
+                vector<string> &p = instr->get_params();
+                vector<IRInstr *> stores = reaching.get_reaching_defs(instr, p[1]);
+                if (stores.empty())
+                    continue;
+
+                // Source commune, ou constante commune chargée par ldconst
+                std::set<string> sources, constants;
+                for (IRInstr *store : stores)
+                {
+                    if (!store || store->get_op() != IRInstr::wmem || !IRInstr::is_symbol(store->get_params()[1]))
+                    {
+                        sources.clear();
+                        constants.clear();
+                        break;
+                    }
+                    const string &source = store->get_params()[1];
+                    sources.insert(source);
+                    IRInstr *def = single_definition(source);
+                    constants.insert(def && def->get_op() == IRInstr::ldconst
+                                         ? std::to_string(IRInstr::constant_value(def->get_params()[1]))
+                                         : "");
+                }
+
+                if (constants.size() == 1 && !constants.begin()->empty() && PassManager::consume_fuel(get_name()))
+                {
+                    instr->set_op(IRInstr::ldconst);
+                    p = {p[0], *constants.begin()};
+                    forwardedLoads++;
+                    changed = true;
+                }
+                else if (acyclic && sources.size() == 1 && single_definition(*sources.begin()) &&
+                         PassManager::consume_fuel(get_name()))
+                {
+                    instr->set_op(IRInstr::copy);
+                    p = {p[0], *sources.begin()};
+                    forwardedLoads++;
+                    changed = true;
+                }
+            }
+        }
+        return changed;
+    }
+
+    // Écritures dans une case qui n'est plus vivante après elles
+    bool remove_dead_stores(CFG &cfg, const Liveness &liveness)
+    {
+        bool changed = false;
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            vector<string> liveOut = liveness.get_live_out_vars(bb);
+            std::set<string> live(liveOut.begin(), liveOut.end());
+            if (bb->exit_false)
+                live.insert(bb->test_var_name);
+
+            vector<IRInstr *> kept;
+            for (auto it = bb->instrs.rbegin(); it != bb->instrs.rend(); ++it)
+            {
+                IRInstr *instr = *it;
+                string dest = instr->get_dest();
+                if (instr->get_op() == IRInstr::wmem && !live.count(dest) && PassManager::consume_fuel(get_name()))
+                {
+                    delete instr;
+                    removedStores++;
+                    changed = true;
+                    continue;
+                }
+                if (IRInstr::is_symbol(dest))
+                    live.erase(dest);
+                for (size_t i : instr->get_use_indices())
+                    live.insert(instr->get_params()[i]);
+                kept.push_back(instr);
+            }
+            bb->instrs.assign(kept.rbegin(), kept.rend());
+        }
+        return changed;
+    }
+};
+
+} // namespace
+
+FunctionPass *createDSEPass()
+{
+    return new DSEPass();
+}
@@ -0,0 +1,705 @@
+// DATAFLOW.CPP : Implémentation du moteur de flot de données et de ses analyses
+
+#include "Dataflow.h"
+#include <algorithm>
+#include <deque>
+#include <unordered_set>
+
+// ---------------------------------------------------------------------------
+// BitVector
+// ---------------------------------------------------------------------------
+
+BitVector::BitVector(size_t size, bool value)
+    : nbits(size), words((size + 63) / 64, value ? ~(uint64_t)0 : 0)
+{
+    clear_unused_bits();
+}
+
+// Les bits au-delà de size() restent à 0 pour que count() et operator== soient exacts
+void BitVector::clear_unused_bits()
+{
+    if (nbits % 64)
+        words.back() &= ((uint64_t)1 << (nbits % 64)) - 1;
+}
+
+void BitVector::set_all()
+{
+    std::fill(words.begin(), words.end(), ~(uint64_t)0);
+    clear_unused_bits();
+}
+
+void BitVector::clear()
+{
+    std::fill(words.begin(), words.end(), 0);
+}
+
+bool BitVector::union_with(const BitVector &other)
+{
+    uint64_t changed = 0;
+    for (size_t i = 0; i < words.size(); i++)
+    {
+        uint64_t merged = words[i] | other.words[i];
+        changed |= merged ^ words[i];
+        words[i] = merged;
+    }
+    return changed != 0;
+}
+
+bool BitVector::intersect_with(const BitVector &other)
+{
+    uint64_t changed = 0;
+    for (size_t i = 0; i < words.size(); i++)
+    {
+        uint64_t merged = words[i] & other.words[i];
+        changed |= merged ^ words[i];
+        words[i] = merged;
+    }
+    return changed != 0;
+}
+
+void BitVector::subtract(const BitVector &other)
+{
+    for (size_t i = 0; i < words.size(); i++)
+    {
+        words[i] &= ~other.words[i];
+    }
+}
+
+size_t BitVector::count() const
+{
+    size_t n = 0;
+    for (uint64_t word : words)
+    {
+        n += __builtin_popcountll(word);
+    }
+    return n;
+}
+
+bool BitVector::any() const
+{
+    for (uint64_t word : words)
+    {
+        if (word)
+            return true;
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// DataflowAnalysis
+// ---------------------------------------------------------------------------
+
+DataflowAnalysis::DataflowAnalysis(const CFG *cfg, Direction direction, Meet meet)
+    : direction(direction), meet(meet), universeSize(0), iterations(0)
+{
+    blocks = cfg->compute_rpo();
+    index.reserve(blocks.size());
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        index[blocks[i]] = i;
+    }
+    preds.resize(blocks.size());
+    succs.resize(blocks.size());
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        for (BasicBlock *succ : blocks[i]->get_successors())
+        {
+            int s = index.at(succ);
+            succs[i].push_back(s);
+            preds[s].push_back(i);
+        }
+    }
+}
+
+int DataflowAnalysis::block_index(BasicBlock *bb) const
+{
+    auto it = index.find(bb);
+    return it == index.end() ? -1 : it->second;
+}
+
+void DataflowAnalysis::init_universe(size_t size)
+{
+    universeSize = size;
+    size_t n = blocks.size();
+    gen.assign(n, BitVector(size));
+    kill.assign(n, BitVector(size));
+    in.assign(n, BitVector(size));
+    out.assign(n, BitVector(size));
+    empty = BitVector(size);
+    boundary = BitVector(size);
+}
+
+// Liste de travail : un bloc est réévalué quand l'ensemble d'un de ses voisins (prédécesseur en avant,
+// successeur en arrière) a changé. L'ordre initial (RPO ou post-order) fait converger les CFG sans
+// boucle en une seule passe.
+void DataflowAnalysis::solve()
+{
+    size_t n = blocks.size();
+    bool forward = direction == FORWARD;
+    // Ensemble calculé par la fonction de transfert (out en avant, in en arrière) et ensemble de confluence
+    vector<BitVector> &result = forward ? out : in;
+    vector<BitVector> &merged = forward ? in : out;
+    const vector<vector<int>> &sources = forward ? preds : succs;
+    const vector<vector<int>> &targets = forward ? succs : preds;
+
+    // Intersection : on part du plus grand ensemble pour que le point fixe soit le plus grand possible
+    if (meet == INTERSECTION)
+    {
+        for (BitVector &set : result)
+            set.set_all();
+    }
+
+    std::deque<int> worklist;
+    vector<char> queued(n, 1);
+    for (size_t i = 0; i < n; i++)
+    {
+        worklist.push_back(forward ? i : n - 1 - i);
+    }
+
+    BitVector next(universeSize);
+    while (!worklist.empty())
+    {
+        int b = worklist.front();
+        worklist.pop_front();
+        queued[b] = 0;
+        iterations++;
+
+        // Confluence ; l'entrée (en avant) ou les blocs terminaux (en arrière) partent de la valeur aux bornes
+        BitVector &m = merged[b];
+        bool isBoundary = forward ? (b == 0) : sources[b].empty();
+        if (isBoundary)
+            m = boundary;
+        else if (meet == UNION)
+            m.clear();
+        else
+            m.set_all();
+        if (meet == UNION || !isBoundary)
+        {
+            for (int s : sources[b])
+            {
+                if (meet == UNION)
+                    m.union_with(result[s]);
+                else
+                    m.intersect_with(result[s]);
+            }
+        }
+
+        // Transfert : gen U (m - kill)
+        next = m;
+        next.subtract(kill[b]);
+        next.union_with(gen[b]);
+        if (next != result[b])
+        {
+            std::swap(next, result[b]);
+            for (int t : targets[b])
+            {
+                if (!queued[t])
+                {
+                    queued[t] = 1;
+                    worklist.push_back(t);
+                }
+            }
+        }
+    }
+}
+
+const BitVector &DataflowAnalysis::get_in(BasicBlock *bb) const
+{
+    int b = block_index(bb);
+    return b < 0 ? empty : in[b];
+}
+
+const BitVector &DataflowAnalysis::get_out(BasicBlock *bb) const
+{
+    int b = block_index(bb);
+    return b < 0 ? empty : out[b];
+}
+
+int symbol_id(const string &operand)
+{
+    if (!IRInstr::is_symbol(operand))
+        return -1;
+    int id = 0;
+    for (size_t i = 1; i < operand.size(); i++)
+        id = id * 10 + (operand[i] - '0');
+    return id;
+}
+
+// Variables lues avant d'être écrites dans un bloc (y compris la variable de test)
+// Appelle f(symbole) pour chacune, éventuellement plusieurs fois
+// Les opérandes d'un phi ne sont pas lus dans son bloc mais à la fin du prédécesseur correspondant
+template <typename F>
+static void for_each_upward_exposed(BasicBlock *bb, vector<int> &definedIn, int mark, F f)
+{
+    for (IRInstr *instr : bb->instrs)
+    {
+        if (instr->get_op() != IRInstr::phi)
+        {
+            for (size_t i : instr->get_use_indices())
+            {
+                int s = symbol_id(instr->get_params()[i]);
+                if (s >= 0 && definedIn[s] != mark)
+                    f(s);
+            }
+        }
+        int d = symbol_id(instr->get_dest());
+        if (d >= 0)
+            definedIn[d] = mark;
+    }
+    int t = bb->exit_false ? symbol_id(bb->test_var_name) : -1;
+    if (t >= 0 && definedIn[t] != mark)
+        f(t);
+}
+
+// Nombre de symboles à prévoir : la table des symboles, plus les "!N" éventuellement créés hors table
+static size_t symbol_bound(const CFG *cfg, const vector<BasicBlock *> &blocks)
+{
+    int bound = cfg->get_symbol_count();
+    for (BasicBlock *bb : blocks)
+    {
+        for (IRInstr *instr : bb->instrs)
+        {
+            for (const string &p : instr->get_params())
+                bound = std::max(bound, symbol_id(p) + 1);
+        }
+        bound = std::max(bound, symbol_id(bb->test_var_name) + 1);
+    }
+    return bound;
+}
+
+// ---------------------------------------------------------------------------
+// Liveness
+// ---------------------------------------------------------------------------
+
+// Analyse arrière : in(B) = use(B) U (out(B) - def(B)), out(B) = U in(S) pour S successeur
+// Seules les variables lues avant d'être écrites dans au moins un bloc peuvent être vivantes
+// à une frontière de bloc : ce sont les seules numérotées.
+// En SSA, un opérande de phi est vivant en sortie du prédécesseur dont il provient (et seulement lui) :
+// il est compté comme une lecture à la fin de ce prédécesseur.
+Liveness::Liveness(const CFG *cfg) : DataflowAnalysis(cfg, BACKWARD, UNION)
+{
+    const vector<BasicBlock *> &bbs = get_blocks();
+    size_t nsym = symbol_bound(cfg, bbs);
+    bitOfSymbol.assign(nsym, -1);
+    auto number = [&](int s) {
+        if (bitOfSymbol[s] < 0)
+        {
+            bitOfSymbol[s] = symbolOfBit.size();
+            symbolOfBit.push_back(s);
+        }
+    };
+
+    // Opérandes des phi, rattachés au prédécesseur d'où ils proviennent
+    map<string, int> blockOfLabel;
+    for (size_t b = 0; b < bbs.size(); b++)
+        blockOfLabel[bbs[b]->label] = b;
+    vector<vector<int>> phiUses(bbs.size());
+    bool hasPhis = false;
+    for (BasicBlock *bb : bbs)
+    {
+        for (IRInstr *instr : bb->instrs)
+        {
+            if (instr->get_op() != IRInstr::phi)
+                continue;
+            const vector<string> &params = instr->get_params();
+            for (size_t i = 1; i + 1 < params.size(); i += 2)
+            {
+                int s = symbol_id(params[i]);
+                auto pred = blockOfLabel.find(params[i + 1]);
+                if (s < 0 || pred == blockOfLabel.end())
+                    continue;
+                phiUses[pred->second].push_back(s);
+                number(s);
+                hasPhis = true;
+            }
+        }
+    }
+
+    vector<int> definedIn(nsym, -1);
+    for (size_t b = 0; b < bbs.size(); b++)
+    {
+        for_each_upward_exposed(bbs[b], definedIn, b, number);
+    }
+
+    init_universe(symbolOfBit.size());
+    if (hasPhis)
+        phiUsesOut.assign(bbs.size(), BitVector(symbolOfBit.size()));
+    std::fill(definedIn.begin(), definedIn.end(), -1);
+    for (size_t b = 0; b < bbs.size(); b++)
+    {
+        for_each_upward_exposed(bbs[b], definedIn, b, [&](int s) { gen[b].set(bitOfSymbol[s]); });
+        // Lecture sur l'arc sortant : vivante en entrée sauf si le bloc la définit
+        for (int s : phiUses[b])
+        {
+            phiUsesOut[b].set(bitOfSymbol[s]);
+            if (definedIn[s] != (int)b)
+                gen[b].set(bitOfSymbol[s]);
+        }
+        for (IRInstr *instr : bbs[b]->instrs)
+        {
+            int d = symbol_id(instr->get_dest());
+            if (d >= 0 && bitOfSymbol[d] >= 0)
+                kill[b].set(bitOfSymbol[d]);
+        }
+    }
+    solve();
+}
+
+bool Liveness::test(const BitVector &set, const string &var) const
+{
+    int s = symbol_id(var);
+    if (s < 0 || s >= (int)bitOfSymbol.size() || bitOfSymbol[s] < 0)
+        return false;
+    return set.test(bitOfSymbol[s]);
+}
+
+bool Liveness::is_live_in(BasicBlock *bb, const string &var) const
+{
+    return test(get_in(bb), var);
+}
+
+bool Liveness::is_live_out(BasicBlock *bb, const string &var) const
+{
+    int b = block_index(bb);
+    if (b >= 0 && !phiUsesOut.empty() && test(phiUsesOut[b], var))
+        return true;
+    return test(get_out(bb), var);
+}
+
+vector<string> Liveness::to_names(const BitVector &set) const
+{
+    vector<string> names;
+    set.for_each([&](size_t bit) { names.push_back("!" + std::to_string(symbolOfBit[bit])); });
+    return names;
+}
+
+vector<string> Liveness::get_live_in_vars(BasicBlock *bb) const
+{
+    return to_names(get_in(bb));
+}
+
+vector<string> Liveness::get_live_out_vars(BasicBlock *bb) const
+{
+    int b = block_index(bb);
+    if (b < 0 || phiUsesOut.empty())
+        return to_names(get_out(bb));
+    BitVector live = get_out(bb);
+    live.union_with(phiUsesOut[b]);
+    return to_names(live);
+}
+
+// ---------------------------------------------------------------------------
+// ReachingDefinitions
+// ---------------------------------------------------------------------------
+
+// Seules les variables lues avant d'être écrites dans un bloc sont suivies (les lectures des autres variables
+// sont toutes précédées d'une écriture dans leur propre bloc), et seule la dernière écriture de chaque bloc
+// peut en atteindre un autre. Comme pour placer les phi de mem2reg, une jonction est créée aux frontières de
+// dominance itérées des blocs qui écrivent la variable (l'entrée compte comme écriture de la valeur initiale) ;
+// un parcours de l'arbre des dominateurs, avec une pile de valeurs par variable, relie ensuite chaque jonction
+// aux valeurs en sortie de ses prédécesseurs et note la valeur en entrée des blocs qui lisent la variable.
+ReachingDefinitions::ReachingDefinitions(const CFG *cfg) : domTree(cfg)
+{
+    const vector<BasicBlock *> &bbs = domTree.get_rpo();
+    size_t n = bbs.size();
+    symbolCount = symbol_bound(cfg, bbs);
+    blockIndex.reserve(n);
+    for (size_t b = 0; b < n; b++)
+        blockIndex[bbs[b]] = b;
+
+    vector<vector<int>> exposed(n);
+    vector<int> definedIn(symbolCount, -1);
+    initialNode.assign(symbolCount, -1);
+    for (size_t b = 0; b < n; b++)
+    {
+        for_each_upward_exposed(bbs[b], definedIn, b, [&](int s) {
+            exposed[b].push_back(s);
+            if (initialNode[s] < 0)
+            {
+                initialNode[s] = nodes.size();
+                nodes.push_back({nullptr, false, {}});
+            }
+        });
+    }
+    if (n == 0)
+        return;
+
+    // Dernière écriture de chaque variable suivie, bloc par bloc
+    vector<vector<std::pair<int, int>>> lastDefs(n); // bloc -> (variable, noeud)
+    vector<vector<BasicBlock *>> defBlocks(symbolCount);
+    for (size_t b = 0; b < n; b++)
+    {
+        const vector<IRInstr *> &instrs = bbs[b]->instrs;
+        for (auto it = instrs.rbegin(); it != instrs.rend(); ++it)
+        {
+            int d = symbol_id((*it)->get_dest());
+            if (d < 0 || initialNode[d] < 0 || !lastDefAt.emplace(key(b, d), nodes.size()).second)
+                continue;
+            lastDefs[b].push_back({d, (int)nodes.size()});
+            nodes.push_back({*it, false, {}});
+            defBlocks[d].push_back(bbs[b]);
+        }
+    }
+
+    // Jonctions ; l'entrée en est une pour toutes les variables si un arc y revient
+    bool entryIsJoin = false;
+    for (size_t b = 0; b < n && !entryIsJoin; b++)
+    {
+        for (BasicBlock *succ : bbs[b]->get_successors())
+            entryIsJoin = entryIsJoin || succ == bbs[0];
+    }
+    DominanceFrontier frontier(cfg, domTree);
+    vector<vector<std::pair<int, int>>> joins(n); // bloc -> (variable, jonction)
+    for (size_t s = 0; s < symbolCount; s++)
+    {
+        if (initialNode[s] < 0)
+            continue;
+        defBlocks[s].push_back(bbs[0]);
+        vector<BasicBlock *> joinBlocks = frontier.get_iterated_frontier(defBlocks[s]);
+        if (entryIsJoin && std::find(joinBlocks.begin(), joinBlocks.end(), bbs[0]) == joinBlocks.end())
+            joinBlocks.push_back(bbs[0]);
+        for (BasicBlock *bb : joinBlocks)
+        {
+            auto it = blockIndex.find(bb);
+            if (it == blockIndex.end())
+                continue;
+            joins[it->second].push_back({(int)s, (int)nodes.size()});
+            joinAt[key(it->second, s)] = nodes.size();
+            nodes.push_back({nullptr, true, {}});
+        }
+    }
+
+    // Parcours de l'arbre des dominateurs sans récursion (il peut être aussi profond que la fonction est longue)
+    vector<vector<int>> current(symbolCount);
+    for (size_t s = 0; s < symbolCount; s++)
+    {
+        if (initialNode[s] >= 0)
+            current[s].push_back(initialNode[s]);
+    }
+    for (auto &join : joins[0])
+        nodes[join.second].operands.push_back(initialNode[join.first]);
+    vector<int> pushed;                          // variables empilées, dans l'ordre
+    vector<std::pair<int, size_t>> walk{{0, 0}}; // (bloc, hauteur de pushed à son entrée)
+    vector<size_t> nextChild{0};
+    bool entering = true;
+    while (!walk.empty())
+    {
+        int b = walk.back().first;
+        if (entering)
+        {
+            for (auto &join : joins[b])
+            {
+                current[join.first].push_back(join.second);
+                pushed.push_back(join.first);
+            }
+            for (int s : exposed[b])
+                valueIn[key(b, s)] = current[s].back();
+            for (auto &def : lastDefs[b])
+            {
+                current[def.first].push_back(def.second);
+                pushed.push_back(def.first);
+            }
+            for (BasicBlock *succ : bbs[b]->get_successors())
+            {
+                for (auto &join : joins[blockIndex.at(succ)])
+                    nodes[join.second].operands.push_back(current[join.first].back());
+            }
+        }
+        const vector<BasicBlock *> &children = domTree.get_children(bbs[b]);
+        if (nextChild.back() < children.size())
+        {
+            BasicBlock *child = children[nextChild.back()++];
+            walk.push_back({blockIndex.at(child), pushed.size()});
+            nextChild.push_back(0);
+            entering = true;
+            continue;
+        }
+        // Sortie du bloc : on dépile ce qu'il a empilé
+        size_t height = walk.back().second;
+        while (pushed.size() > height)
+        {
+            current[pushed.back()].pop_back();
+            pushed.pop_back();
+        }
+        walk.pop_back();
+        nextChild.pop_back();
+        entering = false;
+    }
+}
+
+// Valeur de la variable en entrée du bloc : notée par le parcours si le bloc la lit, sinon celle du premier
+// dominateur qui l'écrit ou qui est une jonction
+int ReachingDefinitions::value_in(int block, int symbol) const
+{
+    auto it = valueIn.find(key(block, symbol));
+    if (it != valueIn.end())
+        return it->second;
+    for (BasicBlock *bb = domTree.get_rpo()[block];;)
+    {
+        int b = blockIndex.at(bb);
+        if ((it = joinAt.find(key(b, symbol))) != joinAt.end())
+            return it->second;
+        bb = domTree.get_idom(bb);
+        if (!bb)
+            return initialNode[symbol];
+        if ((it = lastDefAt.find(key(blockIndex.at(bb), symbol))) != lastDefAt.end())
+            return it->second;
+    }
+}
+
+vector<IRInstr *> ReachingDefinitions::get_reaching_defs_in(BasicBlock *bb, const string &var) const
+{
+    vector<IRInstr *> result;
+    int s = symbol_id(var);
+    auto it = blockIndex.find(bb);
+    if (s < 0 || s >= (int)symbolCount || initialNode[s] < 0 || it == blockIndex.end())
+        return result;
+    // Union des écritures (et de la valeur initiale) accessibles depuis la valeur en entrée
+    std::unordered_set<int> seen;
+    vector<int> worklist{value_in(it->second, s)};
+    while (!worklist.empty())
+    {
+        int node = worklist.back();
+        worklist.pop_back();
+        if (!seen.insert(node).second)
+            continue;
+        if (nodes[node].join)
+            worklist.insert(worklist.end(), nodes[node].operands.begin(), nodes[node].operands.end());
+        else
+            result.push_back(nodes[node].def);
+    }
+    return result;
+}
+
+vector<IRInstr *> ReachingDefinitions::get_reaching_defs(IRInstr *use, const string &var) const
+{
+    // Dernière écriture de var avant use dans le même bloc
+    BasicBlock *bb = use->get_bb();
+    auto it = std::find(bb->instrs.begin(), bb->instrs.end(), use);
+    while (it != bb->instrs.begin())
+    {
+        --it;
+        if ((*it)->get_dest() == var)
+            return {*it};
+    }
+    return get_reaching_defs_in(bb, var);
+}
+
+// ---------------------------------------------------------------------------
+// AvailableExpressions
+// ---------------------------------------------------------------------------
+
+string AvailableExpressions::expression_key(const IRInstr *instr)
+{
+    const vector<string> &p = instr->get_params();
+    switch (instr->get_op())
+    {
+    case IRInstr::ldconst:
+        return "ldconst " + p[1];
+    case IRInstr::rmem:
+    case IRInstr::not_op:
+        return IRInstr::is_register(p[1]) ? "" : IRInstr::op_name(instr->get_op()) + " " + p[1];
+    case IRInstr::add:
+    case IRInstr::mul:
+    case IRInstr::cmp_eq:
+    case IRInstr::cmp_ne:
+    case IRInstr::bit_and:
+    case IRInstr::bit_xor:
+    case IRInstr::bit_or:
+    case IRInstr::logical_and:
+    case IRInstr::logical_or:
+        // Opérations commutatives : ordre canonique des opérandes
+        return IRInstr::op_name(instr->get_op()) + " " + std::min(p[1], p[2]) + ", " + std::max(p[1], p[2]);
+    case IRInstr::sub:
+    case IRInstr::div:
+    case IRInstr::mod:
+    case IRInstr::cmp_lt:
+    case IRInstr::cmp_gt:
+    case IRInstr::cmp_le:
+    case IRInstr::cmp_ge:
+        return IRInstr::op_name(instr->get_op()) + " " + p[1] + ", " + p[2];
+    default:
+        return "";
+    }
+}
+
+// Analyse avant : out(B) = gen(B) U (in(B) - kill(B)), in(B) = n out(P) pour P prédécesseur
+// Une expression calculée dans un seul bloc ne peut pas être disponible à l'entrée d'un bloc qui la calcule :
+// seules les expressions présentes dans au moins deux blocs sont numérotées.
+AvailableExpressions::AvailableExpressions(const CFG *cfg) : DataflowAnalysis(cfg, FORWARD, INTERSECTION)
+{
+    const vector<BasicBlock *> &bbs = get_blocks();
+    std::unordered_map<string, int> lastBlock; // dernier bloc où l'expression a été vue
+    vector<string> keys;
+    for (size_t b = 0; b < bbs.size(); b++)
+    {
+        for (IRInstr *instr : bbs[b]->instrs)
+        {
+            string key = expression_key(instr);
+            if (key.empty())
+                continue;
+            auto it = lastBlock.find(key);
+            if (it == lastBlock.end())
+                lastBlock[key] = b;
+            else if (it->second != (int)b && !bitOfExpression.count(key))
+            {
+                bitOfExpression[key] = keys.size();
+                keys.push_back(key);
+            }
+            else
+                it->second = b;
+        }
+    }
+
+    // Expressions qui lisent chaque variable (elles sont invalidées quand la variable est réécrite)
+    size_t nsym = symbol_bound(cfg, bbs);
+    vector<vector<int>> exprsUsing(nsym);
+    for (BasicBlock *bb : bbs)
+    {
+        for (IRInstr *instr : bb->instrs)
+        {
+            string key = expression_key(instr);
+            auto it = key.empty() ? bitOfExpression.end() : bitOfExpression.find(key);
+            if (it == bitOfExpression.end())
+                continue;
+            for (size_t i : instr->get_use_indices())
+            {
+                int s = symbol_id(instr->get_params()[i]);
+                if (s >= 0 && std::find(exprsUsing[s].begin(), exprsUsing[s].end(), it->second) == exprsUsing[s].end())
+                    exprsUsing[s].push_back(it->second);
+            }
+        }
+    }
+
+    init_universe(keys.size());
+    for (size_t b = 0; b < bbs.size(); b++)
+    {
+        for (IRInstr *instr : bbs[b]->instrs)
+        {
+            string key = expression_key(instr);
+            auto it = key.empty() ? bitOfExpression.end() : bitOfExpression.find(key);
+            if (it != bitOfExpression.end())
+                gen[b].set(it->second);
+            // L'écriture invalide les expressions qui lisent la variable (y compris celle qu'on vient de calculer)
+            int d = symbol_id(instr->get_dest());
+            if (d >= 0)
+            {
+                for (int bit : exprsUsing[d])
+                {
+                    gen[b].reset(bit);
+                    kill[b].set(bit);
+                }
+            }
+        }
+    }
+    solve();
+}
+
+bool AvailableExpressions::is_available_in(BasicBlock *bb, const IRInstr *instr) const
+{
+    string key = expression_key(instr);
+    if (key.empty())
+        return false;
+    auto it = bitOfExpression.find(key);
+    return it != bitOfExpression.end() && get_in(bb).test(it->second);
+}
@@ -0,0 +1,216 @@
+// DATAFLOW.H : Moteur générique d'analyses de flot de données sur le CFG
+// Les ensembles sont des vecteurs de bits denses (BitVector) et chaque bloc est décrit par
+// sa fonction de transfert out = gen U (in - kill) ; le solveur itère avec une liste de travail
+// jusqu'au point fixe, en visitant les blocs en reverse post-order (analyse avant) ou en
+// post-order (analyse arrière), ce qui converge en quelques passes sur les CFG produits par VisitorIR.
+//
+// Deux clients sont fournis :
+//   - Liveness             : variables vivantes (arrière, union)
+//   - AvailableExpressions : expressions disponibles (avant, intersection), utilisées par gvn aux jonctions
+// Pour que la taille des ensembles reste petite sur les très grosses fonctions, chaque client ne numérote
+// que les éléments qui traversent une frontière de bloc (les temporaires locaux à un bloc, majoritaires
+// dans l'IR de VisitorIR, n'y figurent pas) ; les requêtes sur les autres éléments restent exactes.
+// Les définitions atteignantes (ReachingDefinitions) n'utilisent pas de vecteurs de bits : leurs ensembles
+// grandissent avec le nombre d'écritures, elles sont représentées variable par variable (voir plus bas).
+#ifndef DATAFLOW_H
+#define DATAFLOW_H
+
+#include "IR.h"
+#include "Analyses.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Ensemble de bits de taille fixe
+class BitVector
+{
+public:
+    BitVector() : nbits(0) {}
+    explicit BitVector(size_t size, bool value = false);
+
+    size_t size() const { return nbits; }
+    bool test(size_t i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+    void set(size_t i) { words[i >> 6] |= (uint64_t)1 << (i & 63); }
+    void reset(size_t i) { words[i >> 6] &= ~((uint64_t)1 << (i & 63)); }
+    void set_all();
+    void clear();
+
+    /** this = this U other ; retourne vrai si this a changé */
+    bool union_with(const BitVector &other);
+    /** this = this n other ; retourne vrai si this a changé */
+    bool intersect_with(const BitVector &other);
+    /** this = this - other */
+    void subtract(const BitVector &other);
+
+    size_t count() const;
+    bool any() const;
+    bool operator==(const BitVector &other) const { return words == other.words; }
+    bool operator!=(const BitVector &other) const { return words != other.words; }
+
+    /** Appelle f(i) pour chaque bit à 1, dans l'ordre croissant */
+    template <typename F>
+    void for_each(F f) const
+    {
+        for (size_t w = 0; w < words.size(); w++)
+        {
+            uint64_t word = words[w];
+            while (word)
+            {
+                f(w * 64 + __builtin_ctzll(word));
+                word &= word - 1;
+            }
+        }
+    }
+
+private:
+    size_t nbits;
+    vector<uint64_t> words;
+
+    void clear_unused_bits();
+};
+
+// Solveur générique : les sous-classes choisissent la direction et l'opérateur de confluence,
+// numérotent leur univers puis remplissent gen et kill pour chaque bloc avant d'appeler solve()
+class DataflowAnalysis
+{
+public:
+    enum Direction
+    {
+        FORWARD,
+        BACKWARD
+    };
+    enum Meet
+    {
+        UNION,
+        INTERSECTION
+    };
+
+    virtual ~DataflowAnalysis() {}
+
+    /** Ensemble en entrée / en sortie d'un bloc (vide pour un bloc inatteignable) */
+    const BitVector &get_in(BasicBlock *bb) const;
+    const BitVector &get_out(BasicBlock *bb) const;
+    /** Taille de l'univers (nombre de bits de chaque ensemble) */
+    size_t get_universe_size() const { return universeSize; }
+    /** Nombre d'évaluations de fonctions de transfert avant le point fixe */
+    long get_iterations() const { return iterations; }
+
+protected:
+    DataflowAnalysis(const CFG *cfg, Direction direction, Meet meet);
+
+    /** Alloue les ensembles une fois la taille de l'univers connue */
+    void init_universe(size_t size);
+    /** Résout le système d'équations (gen et kill doivent être remplis) */
+    void solve();
+
+    /** Blocs atteignables, en reverse post-order */
+    const vector<BasicBlock *> &get_blocks() const { return blocks; }
+    /** Position d'un bloc dans get_blocks() (-1 s'il est inatteignable) */
+    int block_index(BasicBlock *bb) const;
+
+    vector<BitVector> gen;
+    vector<BitVector> kill;
+    /** Valeur à l'entrée de la fonction (analyse avant) ou à la sortie des blocs terminaux (analyse arrière) ;
+        vide par défaut */
+    BitVector boundary;
+
+private:
+    Direction direction;
+    Meet meet;
+    size_t universeSize;
+    long iterations;
+    vector<BasicBlock *> blocks;
+    std::unordered_map<BasicBlock *, int> index;
+    vector<vector<int>> preds, succs;
+    vector<BitVector> in, out;
+    BitVector empty;
+};
+
+// Index d'une variable "!N" dans la table des symboles (-1 pour une constante ou un registre)
+int symbol_id(const string &operand);
+
+// Analyse de vivacité : une variable est vivante en un point si sa valeur peut encore être lue
+// La variable de test d'un bloc (test_var_name) est lue à la fin du bloc ;
+// un opérande de phi est lu à la fin du prédécesseur correspondant
+class Liveness : public DataflowAnalysis
+{
+public:
+    Liveness(const CFG *cfg);
+
+    bool is_live_in(BasicBlock *bb, const string &var) const;
+    bool is_live_out(BasicBlock *bb, const string &var) const;
+    /** Variables vivantes en entrée / en sortie d'un bloc (noms "!N") */
+    vector<string> get_live_in_vars(BasicBlock *bb) const;
+    vector<string> get_live_out_vars(BasicBlock *bb) const;
+
+private:
+    vector<int> bitOfSymbol; // index de symbole -> bit (-1 si la variable n'est vivante dans aucun arc)
+    vector<int> symbolOfBit;
+    vector<BitVector> phiUsesOut; // opérandes de phi lus sur les arcs sortants de chaque bloc (vide sans phi)
+
+    bool test(const BitVector &set, const string &var) const;
+    vector<string> to_names(const BitVector &set) const;
+};
+
+// Définitions atteignantes : quelles écritures d'une variable peuvent être lues en un point
+// Chaque variable a aussi une pseudo-définition "valeur initiale" (nullptr) placée à l'entrée de la fonction :
+// si elle atteint une lecture, la variable peut ne pas avoir été écrite sur l'un des chemins
+// Représentation creuse, comme la construction SSA : pour chaque variable, un noeud par écriture qui
+// traverse un bloc et un noeud de jonction aux frontières de dominance itérées de ses écritures (l'union des
+// noeuds des prédécesseurs). Ailleurs, un bloc hérite de la valeur de son dominateur immédiat. La construction
+// est linéaire en blocs + écritures + jonctions ; une requête parcourt les noeuds qui mènent à sa réponse.
+class ReachingDefinitions
+{
+public:
+    ReachingDefinitions(const CFG *cfg);
+
+    /** Définitions de var qui peuvent atteindre l'instruction use (nullptr : valeur initiale) */
+    vector<IRInstr *> get_reaching_defs(IRInstr *use, const string &var) const;
+    /** Définitions de var qui atteignent l'entrée du bloc (nullptr : valeur initiale) */
+    vector<IRInstr *> get_reaching_defs_in(BasicBlock *bb, const string &var) const;
+    /** Nombre de noeuds (valeurs initiales, écritures et jonctions) */
+    size_t get_node_count() const { return nodes.size(); }
+
+private:
+    struct Node
+    {
+        IRInstr *def;          // écriture (nullptr : valeur initiale ou jonction)
+        bool join;             // jonction : union des noeuds de operands
+        vector<int> operands;
+    };
+
+    DominatorTree domTree;
+    std::unordered_map<BasicBlock *, int> blockIndex; // bloc atteignable -> position dans domTree.get_rpo()
+    size_t symbolCount;
+    vector<Node> nodes;
+    vector<int> initialNode;                         // index de symbole -> valeur initiale (-1 : non suivi)
+    std::unordered_map<size_t, int> lastDefAt;       // (bloc, variable) -> dernière écriture du bloc
+    std::unordered_map<size_t, int> joinAt;          // (bloc, variable) -> jonction en entrée du bloc
+    std::unordered_map<size_t, int> valueIn;         // (bloc, variable lue avant d'être écrite) -> valeur en entrée
+
+    size_t key(int block, int symbol) const { return (size_t)block * symbolCount + symbol; }
+    int value_in(int block, int symbol) const;
+};
+
+// Expressions disponibles : une expression est disponible à l'entrée d'un bloc si elle a été calculée
+// sur tous les chemins depuis l'entrée sans qu'aucun de ses opérandes n'ait été réécrit depuis
+// Expressions prises en compte : opérations pures (arithmétique, comparaisons, not, ldconst) et lectures rmem
+class AvailableExpressions : public DataflowAnalysis
+{
+public:
+    AvailableExpressions(const CFG *cfg);
+
+    /** Clé de l'expression calculée par l'instruction ("" si ce n'est pas une expression pure)
+        Les opérandes des opérations commutatives sont triés : "add !1, !2" et "add !2, !1" ont la même clé */
+    static string expression_key(const IRInstr *instr);
+    /** Vrai si l'expression calculée par instr est disponible à l'entrée de bb */
+    bool is_available_in(BasicBlock *bb, const IRInstr *instr) const;
+    /** Nombre d'expressions suivies par l'analyse */
+    size_t get_expression_count() const { return get_universe_size(); }
+
+private:
+    std::unordered_map<string, int> bitOfExpression;
+};
+
+#endif
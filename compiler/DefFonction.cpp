@@ -1,8 +1,56 @@
 #include "DefFonction.h"
 #include "IR.h"
 #include <iostream>
+#include <sstream>
 
-DefFonction::DefFonction(const string& name, const Type& returnType, const vector<Param>& params)
-    : name(name), type(returnType), parameters(params), cfg(nullptr) {
+DefFonction::DefFonction(const std::string& name, const Type& returnType, const std::vector<Param>& params)
+    : name(name), type(returnType), parameters(params), inlineHint(INLINE_DEFAULT), cfg(nullptr) {
     // Le CFG sera créé plus tard lors de la génération de code
-}
\ No newline at end of file
+}
+
+std::string inlineHintName(InlineHint hint) {
+    switch (hint) {
+    case INLINE_HINT:
+        return "inline";
+    case INLINE_ALWAYS:
+        return "always_inline";
+    case INLINE_NEVER:
+        return "noinline";
+    default:
+        return "";
+    }
+}
+
+InlineSpecifiers readInlineSpecifiers(const std::vector<std::string> &specifiers) {
+    InlineSpecifiers result;
+    bool hinted = false, always = false, never = false;
+    for (const std::string &spec : specifiers) {
+        if (spec == "inline") {
+            hinted = true;
+            continue;
+        }
+        // __attribute__((a,b)) : noms entre les doubles parenthèses, séparés par des virgules
+        size_t open = spec.find("((");
+        size_t close = spec.rfind("))");
+        if (open == std::string::npos || close == std::string::npos || close < open)
+            continue;
+        std::stringstream names(spec.substr(open + 2, close - open - 2));
+        std::string name;
+        while (std::getline(names, name, ',')) {
+            if (name == "always_inline")
+                always = true;
+            else if (name == "noinline")
+                never = true;
+            else
+                result.ignored.push_back(name);
+        }
+    }
+    result.conflicting = always && never;
+    if (never)
+        result.hint = INLINE_NEVER;
+    else if (always)
+        result.hint = INLINE_ALWAYS;
+    else if (hinted)
+        result.hint = INLINE_HINT;
+    return result;
+}
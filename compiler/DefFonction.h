@@ -1,9 +1,7 @@
 #ifndef DEFFONCTION_H
 #define DEFFONCTION_H
 
-#include "IR.h"
 #include "type.h"
-#include "visitor_ir.h"  // Pour avoir accès à la structure Param
 #include <string>
 #include <vector>
 #include <iostream>
@@ -11,6 +9,41 @@
 // Forward declaration
 class CFG;
 
+// Structure pour représenter un paramètre de fonction
+// Permet de stocker le nom et le type de chaque paramètre
+// (définie ici et non dans visitor_ir.h pour que le middle-end ne dépende pas d'ANTLR)
+struct Param
+{
+    std::string name;
+    Type type;
+
+    Param(const std::string &n, Type t) : name(n), type(t) {}
+};
+
+// Consigne d'intégration donnée dans le source : inline, __attribute__((always_inline)) ou
+// __attribute__((noinline)) ; lue par la passe "inline"
+enum InlineHint
+{
+    INLINE_DEFAULT, // aucune consigne : le modèle de coût décide
+    INLINE_HINT,    // inline : seuil de coût plus élevé
+    INLINE_ALWAYS,  // always_inline : intégrée partout où c'est possible (pas dans un cycle d'appels)
+    INLINE_NEVER    // noinline : jamais intégrée
+};
+
+// Nom d'une consigne dans l'IR textuel ("inline", "always_inline", "noinline" ; "" sans consigne)
+std::string inlineHintName(InlineHint hint);
+
+// Consigne lue dans les spécificateurs d'une fonction, tels qu'écrits dans le source ("inline" ou
+// "__attribute__((a,b))") : noinline l'emporte sur always_inline, qui l'emporte sur inline.
+// Partagée par SymbolTableVisitor (avertissements) et VisitorIR (consigne gardée dans DefFonction).
+struct InlineSpecifiers
+{
+    InlineHint hint = INLINE_DEFAULT;
+    std::vector<std::string> ignored; // attributs inconnus
+    bool conflicting = false;         // always_inline et noinline à la fois
+};
+InlineSpecifiers readInlineSpecifiers(const std::vector<std::string> &specifiers);
+
 // Classe pour représenter une définition de fonction
 class DefFonction {
 public:
@@ -21,11 +54,14 @@ public:
     std::string getName() const { return name; }
     Type getType() const { return type; }
     const std::vector<Param>& getParams() const { return parameters; }
+    InlineHint getInlineHint() const { return inlineHint; }
+    void setInlineHint(InlineHint hint) { inlineHint = hint; }
     
 private:
     std::string name;           // Nom de la fonction
     Type type;                  // Type de retour
     std::vector<Param> parameters;  // Paramètres
+    InlineHint inlineHint;      // Consigne d'intégration
     CFG* cfg;                   // Graphe de flot de contrôle
 };
 
@@ -0,0 +1,163 @@
+// DRIVEROPTIONS.CPP : Options de ligne de commande communes à ifcc et ifcc-opt
+
+#include "DriverOptions.h"
+#include "IRSerializer.h"
+#include "Interpreter.h"
+#include "JIT.h"
+#include "LLVMEmitter.h"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+using std::endl;
+
+bool parse_driver_option(const string &arg, DriverOptions &options)
+{
+    if (arg == "-O0" || arg == "-O1" || arg == "-O2" || arg == "-O3")
+    {
+        options.optLevel = std::min(arg[2] - '0', 2);
+    }
+    else if (arg.rfind("--passes=", 0) == 0)
+    {
+        options.customPasses = arg.substr(9);
+        options.hasCustomPasses = true;
+    }
+    else if (arg.rfind("--disable-pass=", 0) == 0)
+    {
+        options.disabledPasses.push_back(arg.substr(15));
+    }
+    else if (arg.rfind("--print-after=", 0) == 0)
+    {
+        options.printAfter = arg.substr(14);
+    }
+    else if (arg.rfind("--fuel=", 0) == 0)
+    {
+        try
+        {
+            PassManager::set_fuel(std::stol(arg.substr(7)));
+        }
+        catch (const std::logic_error &)
+        {
+            throw std::runtime_error("valeur invalide pour " + arg);
+        }
+    }
+    else if (arg.rfind("--emit=", 0) == 0)
+    {
+        options.emit = arg.substr(7);
+        if (options.emit != "asm" && options.emit != "ir" && options.emit != "ir-binary" && options.emit != "llvm")
+            throw std::runtime_error("format de sortie inconnu '" + options.emit + "'");
+    }
+    else if (arg == "--run" || arg.rfind("--run=", 0) == 0)
+    {
+        options.run = arg == "--run" ? "interp" : arg.substr(6);
+        if (options.run != "interp" && options.run != "jit")
+            throw std::runtime_error("moteur d'exécution inconnu '" + options.run + "'");
+    }
+    else if (arg == "--stats")
+    {
+        options.stats = true;
+    }
+    else if (arg == "--remarks")
+    {
+        PassManager::set_remarks(true);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+void print_driver_options_usage(ostream &o, const string &defaultEmit)
+{
+    o << "  -O0, -O1, -O2          niveau d'optimisation (défaut : -O0)" << endl;
+    o << "  --passes=p1,p2,...     exécute ces passes au lieu du pipeline de -O" << endl;
+    o << "  --disable-pass=<passe> retire cette passe du pipeline (option répétable)" << endl;
+    o << "  --print-after=<passe>  affiche l'IR sur stderr après cette passe (ou 'all')" << endl;
+    o << "  --fuel=<n>             limite le nombre de transformations effectuées" << endl;
+    o << "  --emit=asm|ir|ir-binary|llvm  format de sortie (défaut : " << defaultEmit << " ; llvm : LLVM IR textuel pour clang)" << endl;
+    o << "  --run[=interp|jit]     exécute le programme (interpréteur ou JIT x86-64) ; sa valeur de retour devient le code de sortie" << endl;
+    o << "  --stats                avec --run : affiche sur stderr la taille du code et le temps avant la première instruction" << endl;
+    o << "                         (et, pour l'interpréteur, le nombre d'instructions exécutées)" << endl;
+    o << "  --remarks              affiche sur stderr ce que chaque passe a transformé, fonction par fonction" << endl;
+}
+
+bool configure_pass_manager(PassManager &passManager, const DriverOptions &options)
+{
+    if (options.hasCustomPasses)
+    {
+        std::stringstream passList(options.customPasses);
+        string passName;
+        while (std::getline(passList, passName, ','))
+        {
+            if (!passName.empty() && !passManager.add_pass_by_name(passName))
+            {
+                std::cerr << "Error: unknown pass '" << passName << "'" << endl;
+                return false;
+            }
+        }
+    }
+    else
+    {
+        passManager.build_pipeline(options.optLevel);
+    }
+    for (const string &passName : options.disabledPasses)
+    {
+        vector<string> available = PassManager::get_available_passes();
+        if (std::find(available.begin(), available.end(), passName) == available.end())
+        {
+            std::cerr << "Error: unknown pass '" << passName << "'" << endl;
+            return false;
+        }
+        passManager.remove_pass(passName);
+    }
+    // Le back-end n'émet pas de phi : si l'IR peut encore être en SSA (pipeline personnalisé,
+    // IR relu par ifcc-opt), on termine par out-of-ssa, qui ne fait rien sur un IR sans phi.
+    // L'interpréteur de --run n'exécute pas non plus de phi.
+    // Les passes placées après le dernier out-of-ssa (coalesce) ne recréent pas de phi.
+    vector<string> pipeline = passManager.get_pipeline();
+    auto lastMem2Reg = std::find(pipeline.rbegin(), pipeline.rend(), "mem2reg");
+    auto lastOutOfSSA = std::find(pipeline.rbegin(), pipeline.rend(), "out-of-ssa");
+    bool endsOutOfSSA = lastOutOfSSA != pipeline.rend() && lastOutOfSSA < lastMem2Reg;
+    bool endsInSSA = lastMem2Reg != pipeline.rend() && lastMem2Reg < lastOutOfSSA;
+    if ((options.emit == "asm" || !options.run.empty()) && !endsOutOfSSA)
+        passManager.add_pass_by_name("out-of-ssa");
+    // À l'inverse, le back-end LLVM attend de l'IR en SSA (mem2reg ne fait rien sur une fonction qui a déjà des phi)
+    else if (options.emit == "llvm" && options.run.empty() && !endsInSSA)
+        passManager.add_pass_by_name("mem2reg");
+    passManager.set_print_after(options.printAfter);
+    return true;
+}
+
+void emit_module(ostream &o, const Module &module, const DriverOptions &options)
+{
+    if (options.emit == "ir")
+        write_module_text(o, module);
+    else if (options.emit == "ir-binary")
+        write_module_binary(o, module);
+    else if (options.emit == "llvm")
+        gen_llvm_module(o, module);
+    else
+        gen_asm_module(o, module);
+}
+
+int run_or_emit_module(ostream &o, const Module &module, const DriverOptions &options)
+{
+    try
+    {
+        if (options.run.empty())
+        {
+            emit_module(o, module, options);
+            return 0;
+        }
+        std::ostream *stats = options.stats ? &std::cerr : nullptr;
+        if (options.run == "jit")
+            return jit_run_module(module, stats);
+        return run_module(module, stats);
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,40 @@
+// DRIVEROPTIONS.H : Options de ligne de commande communes à ifcc et ifcc-opt
+// (niveau d'optimisation, choix des passes, affichage de l'IR, format de sortie, exécution directe)
+#ifndef DRIVER_OPTIONS_H
+#define DRIVER_OPTIONS_H
+
+#include "IR.h"
+#include "PassManager.h"
+#include <iostream>
+#include <string>
+
+struct DriverOptions
+{
+    int optLevel = 0;             // -O0, -O1, -O2 (-O3 équivaut à -O2)
+    bool hasCustomPasses = false; // --passes= remplace le pipeline de -O
+    string customPasses;          // liste de passes séparées par des virgules
+    vector<string> disabledPasses; // --disable-pass= : passes retirées du pipeline (option répétable)
+    string printAfter;            // --print-after=<passe> ou "all"
+    string emit = "asm";          // --emit= : asm, ir (textuel), ir-binary ou llvm
+    string run;                   // --run[=interp|jit] : exécute le programme au lieu de l'émettre
+    bool stats = false;           // --stats : statistiques d'exécution sur stderr
+};
+
+/** Interprète une option commune ; retourne faux si l'option n'en fait pas partie
+    (lève std::runtime_error si sa valeur est invalide) */
+bool parse_driver_option(const string &arg, DriverOptions &options);
+
+/** Affiche l'aide des options communes ; defaultEmit est le format de sortie par défaut de l'outil */
+void print_driver_options_usage(ostream &o, const string &defaultEmit);
+
+/** Construit le pipeline de passes demandé ; retourne faux (avec un message) si une passe est inconnue */
+bool configure_pass_manager(PassManager &passManager, const DriverOptions &options);
+
+/** Écrit le module dans le format demandé par --emit= */
+void emit_module(ostream &o, const Module &module, const DriverOptions &options);
+
+/** Avec --run : exécute le module (Interpreter.h, ou JIT.h avec --run=jit) et retourne le code de sortie du programme ;
+    sinon écrit le module sur o avec emit_module et retourne 0 (1 si le module ne peut pas être émis) */
+int run_or_emit_module(ostream &o, const Module &module, const DriverOptions &options);
+
+#endif
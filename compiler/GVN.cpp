@@ -0,0 +1,442 @@
+// GVN.CPP : Numérotation globale des valeurs sur l'arbre des dominateurs (passe "gvn")
+// Étend la numérotation locale (lvn) à toute la fonction, sur la forme SSA : un calcul est
+// totalement redondant si le même calcul, sur les mêmes valeurs, a déjà été fait dans un bloc qui
+// le domine (avant un if, il est disponible dans les deux branches et après la jonction).
+//   - l'arbre des dominateurs est parcouru en profondeur avec une table de hachage à portées :
+//     les expressions calculées dans un bloc sont visibles dans tout son sous-arbre, puis retirées
+//   - la clé d'une expression est l'opération et les valeurs de ses opérandes (une copie a la
+//     valeur de sa source ; opérandes triés pour une opération commutative)
+//   - une instruction redondante est supprimée, et toutes ses utilisations (phi et variables de
+//     test comprises) lisent directement le premier résultat : en SSA, il domine la définition
+//     supprimée, donc chacune de ses utilisations
+// Un appel n'est fusionné que si la fonction appelée est pure (voir Purity) : f(x) + f(x) n'appelle f
+// qu'une fois. Les autres appels ne sont jamais fusionnés.
+// Avant la numérotation, l'appel d'une fonction pure qui termine toujours dont les arguments sont
+// définis hors d'une boucle (boucle créée par tailrec) est remonté à la fin du bloc qui la précède
+// (unique prédécesseur de l'en-tête hors de la boucle, qui ne saute que vers lui) : il n'est plus
+// exécuté qu'une fois, et il peut ensuite être fusionné avec un appel identique fait avant la boucle.
+// Les boucles internes sont traitées d'abord, un appel peut donc sortir de plusieurs niveaux.
+// Un calcul qu'aucun bloc dominant ne fait peut être redondant à une jonction : a+b calculé dans les
+// deux branches d'un if, puis après. Les expressions disponibles (Dataflow.h) disent qu'il a été fait
+// sur tous les chemins ; ses résultats sont alors réunis par des phi (placés en remontant les
+// prédécesseurs jusqu'aux calculs, comme la construction SSA à la demande de Braun et al.) et le calcul
+// est supprimé. Un phi qui ne reçoit qu'une valeur est remplacé par elle.
+
+#include "Passes.h"
+#include <algorithm>
+#include <set>
+
+namespace
+{
+
+class GVNPass : public FunctionPass
+{
+public:
+    string get_name() const override { return "gvn"; }
+    bool preserves_cfg() const override { return true; }
+
+    bool run_on_function(CFG &cfg, AnalysisManager &am) override
+    {
+        if (cfg.get_bbs().empty() || !cfg.is_ssa())
+            return false;
+
+        purity = &am.get_purity();
+        value.clear();
+        replaced.clear();
+        available.clear();
+        redundant.clear();
+        int joined = merge_available_expressions(cfg, am.get_available_expressions(&cfg));
+        if (joined > 0)
+            PassManager::remark(get_name(), cfg, std::to_string(joined) + " calcul(s) déjà disponible(s) sur tous les chemins");
+        int hoisted = hoist_invariant_calls(cfg, am.get_loops(&cfg));
+        if (hoisted > 0)
+            PassManager::remark(get_name(), cfg, std::to_string(hoisted) + " appel(s) pur(s) invariant(s) sorti(s) de boucle");
+        walk_dominator_tree(cfg, am.get_dominators(&cfg));
+        if (replaced.empty())
+            return joined > 0 || hoisted > 0;
+        int calls = std::count_if(redundant.begin(), redundant.end(), [](const IRInstr *instr)
+                                  { return instr->get_op() == IRInstr::call; });
+        if (calls > 0)
+            PassManager::remark(get_name(), cfg, std::to_string(calls) + " appel(s) pur(s) fusionné(s) avec un appel identique");
+
+        // Les utilisations des valeurs remplacées lisent le premier résultat ; les calculs redondants
+        // n'ont alors plus d'utilisation
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            vector<IRInstr *> kept;
+            for (IRInstr *instr : bb->instrs)
+            {
+                if (redundant.count(instr))
+                {
+                    delete instr;
+                    continue;
+                }
+                for (size_t i : instr->get_use_indices())
+                    rename(instr->get_params()[i]);
+                kept.push_back(instr);
+            }
+            bb->instrs = kept;
+            if (bb->exit_false)
+                rename(bb->test_var_name);
+        }
+        return true;
+    }
+
+private:
+    map<string, string> value;     // valeur SSA -> valeur dont elle est une copie ou un doublon
+    map<string, string> replaced;  // définition supprimée -> premier résultat
+    map<string, string> available; // clé d'expression -> valeur qui la contient (portée : sous-arbre courant)
+    std::set<IRInstr *> redundant; // instructions à supprimer
+    const Purity *purity = nullptr;
+
+    string find(const string &operand) const
+    {
+        string v = operand;
+        for (size_t steps = 0; steps <= value.size(); steps++)
+        {
+            auto it = value.find(v);
+            if (it == value.end())
+                break;
+            v = it->second;
+        }
+        return v;
+    }
+
+    void rename(string &operand) const
+    {
+        if (replaced.count(operand))
+            operand = find(operand);
+    }
+
+    map<BasicBlock *, vector<BasicBlock *>> preds;
+    map<std::pair<BasicBlock *, string>, string> valueIn; // (bloc, expression) -> valeur en entrée du bloc
+    vector<IRInstr *> joinPhis;                            // phi créés pour les expressions disponibles
+
+    // Valeur de l'expression key à la fin de bb : le dernier calcul du bloc, sinon la valeur en entrée
+    string value_at_end(CFG &cfg, BasicBlock *bb, const string &key)
+    {
+        for (auto it = bb->instrs.rbegin(); it != bb->instrs.rend(); ++it)
+        {
+            if (AvailableExpressions::expression_key(*it) == key)
+                return (*it)->get_dest();
+        }
+        return value_at_entry(cfg, bb, key);
+    }
+
+    // Valeur en entrée de bb : celle de l'unique prédécesseur, ou un phi ; le phi est enregistré avant
+    // de remonter ses prédécesseurs, un arc retour le retrouve donc au lieu de boucler
+    string value_at_entry(CFG &cfg, BasicBlock *bb, const string &key)
+    {
+        auto known = valueIn.find({bb, key});
+        if (known != valueIn.end())
+            return known->second;
+        const vector<BasicBlock *> &from = preds[bb];
+        if (from.size() == 1)
+            return valueIn[{bb, key}] = value_at_end(cfg, from[0], key);
+        string dest = cfg.create_new_tempvar(Type::INT_TYPE);
+        valueIn[{bb, key}] = dest;
+        IRInstr *phi = new IRInstr(bb, IRInstr::phi, Type::INT_TYPE, {dest});
+        bb->instrs.insert(bb->instrs.begin(), phi);
+        joinPhis.push_back(phi);
+        for (BasicBlock *pred : from)
+        {
+            string incoming = value_at_end(cfg, pred, key);
+            phi->get_params().insert(phi->get_params().end(), {incoming, pred->label});
+        }
+        return dest;
+    }
+
+    int merge_available_expressions(CFG &cfg, const AvailableExpressions &available)
+    {
+        // Premier calcul de chaque expression dans son bloc (les suivants sont dominés par lui)
+        vector<std::pair<BasicBlock *, IRInstr *>> candidates;
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            if (bb == cfg.get_entry())
+                continue;
+            std::set<string> seen;
+            for (IRInstr *instr : bb->instrs)
+            {
+                IRInstr::Operation op = instr->get_op();
+                string key = AvailableExpressions::expression_key(instr);
+                if (key.empty() || op == IRInstr::ldconst || op == IRInstr::rmem || !seen.insert(key).second)
+                    continue;
+                if (available.is_available_in(bb, instr))
+                    candidates.push_back({bb, instr});
+            }
+        }
+        if (candidates.empty())
+            return 0;
+
+        preds = cfg.compute_predecessors();
+        valueIn.clear();
+        joinPhis.clear();
+        map<string, string> merged;
+        std::set<IRInstr *> removed;
+        for (const auto &candidate : candidates)
+        {
+            if (!PassManager::consume_fuel(get_name()))
+                continue;
+            IRInstr *instr = candidate.second;
+            merged[instr->get_dest()] = value_at_entry(cfg, candidate.first, AvailableExpressions::expression_key(instr));
+            removed.insert(instr);
+        }
+
+        // Un phi dont toutes les valeurs (hors lui-même) sont identiques est remplacé par cette valeur
+        auto resolve = [&](string v)
+        {
+            for (size_t steps = 0; steps <= merged.size(); steps++)
+            {
+                auto it = merged.find(v);
+                if (it == merged.end())
+                    break;
+                v = it->second;
+            }
+            return v;
+        };
+        bool simplified = true;
+        while (simplified)
+        {
+            simplified = false;
+            for (IRInstr *phi : joinPhis)
+            {
+                if (removed.count(phi))
+                    continue;
+                const vector<string> &p = phi->get_params();
+                string single;
+                bool trivial = true;
+                for (size_t i = 1; i < p.size() && trivial; i += 2)
+                {
+                    string v = resolve(p[i]);
+                    if (v == p[0] || v == single)
+                        continue;
+                    trivial = single.empty();
+                    single = v;
+                }
+                if (!trivial || single.empty())
+                    continue;
+                merged[p[0]] = single;
+                removed.insert(phi);
+                simplified = true;
+            }
+        }
+
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            vector<IRInstr *> kept;
+            for (IRInstr *instr : bb->instrs)
+            {
+                if (removed.count(instr))
+                {
+                    delete instr;
+                    continue;
+                }
+                for (size_t i : instr->get_use_indices())
+                    instr->get_params()[i] = resolve(instr->get_params()[i]);
+                kept.push_back(instr);
+            }
+            bb->instrs = kept;
+            if (bb->exit_false)
+                bb->test_var_name = resolve(bb->test_var_name);
+        }
+        return std::count_if(candidates.begin(), candidates.end(), [&](const std::pair<BasicBlock *, IRInstr *> &c)
+                             { return removed.count(c.second) != 0; });
+    }
+
+    // Bloc qui précède la boucle : seul prédécesseur de l'en-tête hors de la boucle, sans autre successeur
+    static BasicBlock *find_preheader(const Loop &loop, map<BasicBlock *, vector<BasicBlock *>> &preds)
+    {
+        BasicBlock *preheader = nullptr;
+        for (BasicBlock *pred : preds[loop.header])
+        {
+            if (loop.blocks.count(pred))
+                continue;
+            if (preheader)
+                return nullptr;
+            preheader = pred;
+        }
+        return preheader && !preheader->exit_false ? preheader : nullptr;
+    }
+
+    // Un argument est invariant s'il est constant ou défini hors de la boucle (un registre n'est lu
+    // qu'à l'entrée de la fonction : il n'est pas déplacé)
+    static bool is_invariant(const IRInstr *call, const Loop &loop, const map<string, BasicBlock *> &definedIn)
+    {
+        const vector<string> &p = call->get_params();
+        for (size_t i = 2; i < p.size(); i++)
+        {
+            if (IRInstr::is_constant(p[i]))
+                continue;
+            if (!IRInstr::is_symbol(p[i]))
+                return false;
+            auto it = definedIn.find(p[i]);
+            if (it != definedIn.end() && loop.blocks.count(it->second))
+                return false;
+        }
+        return true;
+    }
+
+    int hoist_invariant_calls(CFG &cfg, const LoopInfo &loopInfo)
+    {
+        vector<const Loop *> loops;
+        for (const Loop &loop : loopInfo.get_loops())
+            loops.push_back(&loop);
+        if (loops.empty())
+            return 0;
+        std::stable_sort(loops.begin(), loops.end(), [](const Loop *a, const Loop *b)
+                         { return a->blocks.size() < b->blocks.size(); });
+
+        map<string, BasicBlock *> definedIn;
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            for (IRInstr *instr : bb->instrs)
+            {
+                if (IRInstr::is_symbol(instr->get_dest()))
+                    definedIn[instr->get_dest()] = bb;
+            }
+        }
+        map<BasicBlock *, vector<BasicBlock *>> preds = cfg.compute_predecessors();
+
+        int hoisted = 0;
+        for (const Loop *loop : loops)
+        {
+            BasicBlock *preheader = find_preheader(*loop, preds);
+            if (!preheader)
+                continue;
+            for (BasicBlock *bb : cfg.get_bbs())
+            {
+                if (!loop->blocks.count(bb))
+                    continue;
+                vector<IRInstr *> kept;
+                for (IRInstr *instr : bb->instrs)
+                {
+                    if (!purity->is_removable_call(instr) || instr->is_tail_call() ||
+                        !is_invariant(instr, *loop, definedIn) || !PassManager::consume_fuel(get_name()))
+                    {
+                        kept.push_back(instr);
+                        continue;
+                    }
+                    instr->set_bb(preheader);
+                    preheader->instrs.push_back(instr);
+                    definedIn[instr->get_dest()] = preheader;
+                    hoisted++;
+                }
+                bb->instrs = kept;
+            }
+        }
+        return hoisted;
+    }
+
+    // Clé de l'expression calculée par l'instruction ("" si elle ne peut pas être fusionnée)
+    string key_of(IRInstr *instr) const
+    {
+        IRInstr::Operation op = instr->get_op();
+        const vector<string> &p = instr->get_params();
+        switch (op)
+        {
+        case IRInstr::call:
+            if (!purity->is_pure_call(instr))
+                return "";
+            break;
+        case IRInstr::ret:
+        case IRInstr::copy:
+            return "";
+        case IRInstr::ldconst:
+            return "ldconst " + std::to_string(IRInstr::constant_value(p[1]));
+        case IRInstr::phi:
+        {
+            // Deux phi du même bloc qui reçoivent les mêmes valeurs des mêmes prédécesseurs
+            string key = "phi " + instr->get_bb()->label;
+            for (size_t i = 1; i + 1 < p.size(); i += 2)
+                key += " " + find(p[i]) + " " + p[i + 1];
+            return key;
+        }
+        default:
+            break;
+        }
+        vector<string> operands;
+        for (size_t i : instr->get_use_indices())
+            operands.push_back(find(p[i]));
+        if (IRInstr::is_commutative(op) && operands.size() == 2 && operands[1] < operands[0])
+            std::swap(operands[0], operands[1]);
+        string key = IRInstr::op_name(op);
+        if (op == IRInstr::call)
+            key += " " + p[0];
+        for (const string &operand : operands)
+            key += " " + operand;
+        return key;
+    }
+
+    // Parcours en profondeur itératif ; chaque bloc retire en sortie les expressions qu'il a ajoutées
+    void walk_dominator_tree(CFG &cfg, const DominatorTree &domTree)
+    {
+        struct Frame
+        {
+            BasicBlock *bb;
+            size_t nextChild;
+            size_t scopeMark;
+        };
+        vector<string> scope; // clés ajoutées, dans l'ordre
+        vector<Frame> stack;
+        BasicBlock *entry = cfg.get_entry();
+        stack.push_back({entry, 0, 0});
+        number_block(entry, scope);
+        while (!stack.empty())
+        {
+            Frame &frame = stack.back();
+            const vector<BasicBlock *> &children = domTree.get_children(frame.bb);
+            if (frame.nextChild < children.size())
+            {
+                BasicBlock *child = children[frame.nextChild++];
+                stack.push_back({child, 0, scope.size()});
+                number_block(child, scope);
+                continue;
+            }
+            while (scope.size() > frame.scopeMark)
+            {
+                available.erase(scope.back());
+                scope.pop_back();
+            }
+            stack.pop_back();
+        }
+    }
+
+    void number_block(BasicBlock *bb, vector<string> &scope)
+    {
+        for (IRInstr *instr : bb->instrs)
+        {
+            string dest = instr->get_dest();
+            if (!IRInstr::is_symbol(dest))
+                continue;
+            if (instr->get_op() == IRInstr::copy)
+            {
+                value[dest] = find(instr->get_params()[1]);
+                continue;
+            }
+            string key = key_of(instr);
+            if (key.empty())
+                continue;
+
+            auto it = available.find(key);
+            if (it == available.end())
+            {
+                available[key] = dest;
+                scope.push_back(key);
+                continue;
+            }
+            if (!PassManager::consume_fuel(get_name()))
+                continue;
+            // Calcul totalement redondant : le résultat disponible le remplace
+            value[dest] = it->second;
+            replaced[dest] = it->second;
+            redundant.insert(instr);
+        }
+    }
+};
+
+} // namespace
+
+FunctionPass *createGVNPass()
+{
+    return new GVNPass();
+}
@@ -0,0 +1,290 @@
+// IPCP.CPP : Propagation interprocédurale des constantes et spécialisation (passe "ipcp")
+// Beaucoup d'appels passent des arguments littéraux, que sccp ne voit pas : dans l'appelé, un paramètre
+// est lu depuis son registre ("copy p, %edi") et sa valeur est inconnue. Sur la forme SSA, pour chaque
+// fonction g du module (hors main), on examine tous ses sites d'appel (le programme est complet : aucun
+// appel ne vient de l'extérieur) ; un argument est constant s'il est littéral ou chargé par un ldconst,
+// et un appel récursif qui repasse le paramètre inchangé ne contredit aucune valeur :
+//   - propagation : si tous les appels passent la même constante c au paramètre p, la lecture de p
+//     devient "ldconst p, c" et sccp replie ensuite le corps de g
+//   - spécialisation : sinon, les appels sont regroupés selon leurs arguments constants ; un groupe
+//     chaud (fréquence cumulée de ses sites, selon BranchProbability) reçoit une copie g.constprop.N
+//     de g où ces paramètres sont des constantes, et ses appels sont redirigés vers elle
+// Le code ajouté par les copies est limité par un budget proportionnel à la taille du module, et une
+// fonction reçoit au plus deux copies. Avec --remarks, les constantes propagées et les copies créées sont
+// indiquées pour chaque fonction.
+
+#include "Passes.h"
+#include "DefFonction.h"
+#include <algorithm>
+
+namespace
+{
+
+const double hotCallFrequency = 2.0; // fréquence cumulée minimale des sites d'un groupe spécialisé
+const int maxSpecializations = 2;    // copies par fonction
+const int growthPercent = 30;        // budget de croissance : pourcentage de la taille du module...
+const int minGrowthBudget = 200;     // ...mais au moins ce nombre d'instructions
+
+// Valeur d'un argument vue depuis l'appelé
+struct ArgumentValue
+{
+    bool constant;   // littéral ou temporaire chargé par ldconst
+    bool forwarded;  // appel récursif qui repasse le paramètre reçu au même rang
+    int32_t value;
+};
+
+// Site d'appel de g, avec la fréquence estimée de son bloc
+struct CallSite
+{
+    CFG *caller;
+    IRInstr *call;
+    double frequency;
+    vector<ArgumentValue> args;
+};
+
+// Arguments constants d'un groupe de sites : (rang, valeur)
+typedef vector<std::pair<size_t, int32_t>> Signature;
+
+class IPCPPass : public ModulePass
+{
+public:
+    string get_name() const override { return "ipcp"; }
+
+    bool run_on_module(Module &module, AnalysisManager &am) override
+    {
+        int moduleSize = 0;
+        for (auto &pair : module)
+            moduleSize += pair.second->count_instructions();
+        budget = std::max(moduleSize * growthPercent / 100, minGrowthBudget);
+
+        // Tous les sites sont relevés avant la moindre modification (fréquences et constantes cohérentes)
+        map<string, vector<CallSite>> sites = collect_sites(module, am);
+        bool changed = false;
+        for (auto &pair : sites)
+        {
+            CFG &callee = *module.at(pair.first);
+            if (callee.get_name() == "main" || !callee.is_ssa())
+                continue;
+            std::set<size_t> propagated;
+            changed |= propagate(callee, pair.second, propagated);
+            changed |= specialize(module, callee, pair.second, propagated);
+        }
+        return changed;
+    }
+
+private:
+    int budget = 0;
+
+    static map<string, vector<CallSite>> collect_sites(Module &module, AnalysisManager &am)
+    {
+        map<string, vector<CallSite>> sites;
+        for (auto &pair : module)
+        {
+            CFG *caller = pair.second;
+            if (caller->get_bbs().empty())
+                continue;
+            map<string, int32_t> constants = caller->compute_constant_values();
+            map<size_t, IRInstr *> reads = caller->compute_parameter_reads();
+            BranchProbability &probability = am.get_branch_probability(caller);
+            for (BasicBlock *bb : caller->get_bbs())
+            {
+                for (IRInstr *instr : bb->instrs)
+                {
+                    const vector<string> &p = instr->get_params();
+                    if (instr->get_op() != IRInstr::call || !module.count(p[0]))
+                        continue;
+                    CallSite site{caller, instr, probability.get_frequency(bb), {}};
+                    for (size_t i = 2; i < p.size(); i++)
+                    {
+                        ArgumentValue arg{false, false, 0};
+                        auto it = constants.find(p[i]);
+                        if (IRInstr::is_constant(p[i]) || it != constants.end())
+                        {
+                            arg.constant = true;
+                            arg.value = it != constants.end() ? it->second : IRInstr::constant_value(p[i]);
+                        }
+                        auto read = reads.find(i - 2);
+                        arg.forwarded = p[0] == caller->get_name() && read != reads.end() && read->second->get_dest() == p[i];
+                        site.args.push_back(arg);
+                    }
+                    sites[p[0]].push_back(site);
+                }
+            }
+        }
+        return sites;
+    }
+
+    // Le paramètre lu par read devient la constante value
+    static void bind_parameter(IRInstr *read, int32_t value)
+    {
+        read->set_op(IRInstr::ldconst);
+        read->get_params()[1] = std::to_string(value);
+    }
+
+    static string describe(const CFG &cfg, const Signature &signature)
+    {
+        string text;
+        for (const auto &arg : signature)
+        {
+            const vector<Param> &params = cfg.ast->getParams();
+            string name = arg.first < params.size() ? params[arg.first].name : "#" + std::to_string(arg.first);
+            text += (text.empty() ? "" : ", ") + name + " = " + std::to_string(arg.second);
+        }
+        return text;
+    }
+
+    // Paramètres qui reçoivent la même constante de tous les appels
+    bool propagate(CFG &callee, const vector<CallSite> &sites, std::set<size_t> &propagated)
+    {
+        Signature bound;
+        for (auto &read : callee.compute_parameter_reads())
+        {
+            size_t index = read.first;
+            bool agree = true, seen = false;
+            int32_t value = 0;
+            for (const CallSite &site : sites)
+            {
+                if (index >= site.args.size())
+                {
+                    agree = false;
+                    break;
+                }
+                const ArgumentValue &arg = site.args[index];
+                if (arg.forwarded)
+                    continue;
+                if (!arg.constant || (seen && arg.value != value))
+                {
+                    agree = false;
+                    break;
+                }
+                seen = true;
+                value = arg.value;
+            }
+            if (!agree || !seen || !PassManager::consume_fuel(get_name()))
+                continue;
+            bind_parameter(read.second, value);
+            propagated.insert(index);
+            bound.push_back({index, value});
+        }
+        if (bound.empty())
+            return false;
+        PassManager::remark(get_name(), callee, "même constante à tous les appels : " + describe(callee, bound));
+        return true;
+    }
+
+    // Copies de callee pour les groupes d'appels chauds qui partagent des arguments constants : un groupe
+    // réunit les sites qui passent c au paramètre p, et sa signature tous les arguments sur lesquels ils
+    // s'accordent
+    bool specialize(Module &module, CFG &callee, vector<CallSite> &sites, const std::set<size_t> &propagated)
+    {
+        // Seuls comptent les paramètres encore inconnus et lus dans le corps
+        map<size_t, IRInstr *> reads = callee.compute_parameter_reads();
+        std::set<size_t> useful;
+        for (const auto &read : reads)
+        {
+            if (!propagated.count(read.first) && callee.count_uses(read.second->get_dest()) > 0)
+                useful.insert(read.first);
+        }
+
+        map<std::pair<size_t, int32_t>, vector<CallSite *>> byArgument;
+        for (CallSite &site : sites)
+        {
+            for (size_t i = 0; i < site.args.size(); i++)
+            {
+                if (site.args[i].constant && useful.count(i))
+                    byArgument[{i, site.args[i].value}].push_back(&site);
+            }
+        }
+        map<Signature, vector<CallSite *>> groups;
+        for (const auto &group : byArgument)
+        {
+            Signature signature;
+            for (size_t i : useful)
+            {
+                const vector<CallSite *> &members = group.second;
+                bool agree = std::all_of(members.begin(), members.end(), [&](const CallSite *site)
+                                         { return i < site->args.size() && site->args[i].constant &&
+                                                  site->args[i].value == members[0]->args[i].value; });
+                if (agree)
+                    signature.push_back({i, members[0]->args[i].value});
+            }
+            groups[signature] = group.second;
+        }
+
+        // Groupes les plus chauds d'abord ; un site n'est redirigé qu'une fois
+        vector<std::pair<double, const Signature *>> candidates;
+        for (const auto &group : groups)
+            candidates.push_back({frequency_of(group.second, {}), &group.first});
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const std::pair<double, const Signature *> &a, const std::pair<double, const Signature *> &b)
+                  { return a.first > b.first; });
+
+        int size = callee.count_instructions();
+        int created = 0;
+        std::set<const CallSite *> redirected;
+        for (const auto &candidate : candidates)
+        {
+            const Signature &signature = *candidate.second;
+            vector<CallSite *> &members = groups[signature];
+            if (created == maxSpecializations || size > budget)
+                break;
+            if (frequency_of(members, redirected) < hotCallFrequency || !PassManager::consume_fuel(get_name()))
+                continue;
+            CFG *copy = clone_function(module, callee);
+            map<size_t, IRInstr *> copyReads = copy->compute_parameter_reads();
+            for (const auto &arg : signature)
+                bind_parameter(copyReads.at(arg.first), arg.second);
+            int count = 0;
+            for (CallSite *site : members)
+            {
+                if (!redirected.insert(site).second)
+                    continue;
+                site->call->get_params()[0] = copy->get_name();
+                count++;
+            }
+            budget -= size;
+            created++;
+            PassManager::remark(get_name(), callee, "spécialisée en " + copy->get_name() + " (" + describe(callee, signature) +
+                                                        ") pour " + std::to_string(count) + " appel(s)");
+        }
+        return created > 0;
+    }
+
+    // Fréquence cumulée des sites qui n'ont pas encore été redirigés
+    static double frequency_of(const vector<CallSite *> &members, const std::set<const CallSite *> &redirected)
+    {
+        double frequency = 0;
+        for (const CallSite *site : members)
+        {
+            if (!redirected.count(site))
+                frequency += site->frequency;
+        }
+        return frequency;
+    }
+
+    // Copie de la fonction sous un nouveau nom (mêmes paramètres et consigne d'intégration)
+    static CFG *clone_function(Module &module, const CFG &original)
+    {
+        string name;
+        int n = 0;
+        do
+        {
+            name = original.get_name() + ".constprop." + std::to_string(n++);
+        } while (module.count(name));
+
+        DefFonction *ast = new DefFonction(name, original.ast->getType(), original.ast->getParams());
+        ast->setInlineHint(original.ast->getInlineHint());
+        CFG *copy = new CFG(ast);
+        map<string, string> renamed;
+        copy->clone_blocks(original, renamed);
+        module[name] = copy;
+        return copy;
+    }
+};
+
+} // namespace
+
+ModulePass *createIPCPPass()
+{
+    return new IPCPPass();
+}
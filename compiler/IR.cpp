@@ -12,7 +12,12 @@
 // Ce découpage permet d'isoler la logique du langage source, de préparer des optimisations, et de faciliter le reciblage assembleur.
 
 #include "IR.h"
+#include "DefFonction.h"
 #include <set>
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
 
 using std::endl;
 using std::ostream;
@@ -56,6 +61,484 @@ string IRInstr::IR_reg_to_asm(string reg)
 IRInstr::IRInstr(BasicBlock *bb_, Operation op, Type t, vector<string> params)
     : bb(bb_), op(op), t(t), params(params) {}
 
+// Une variable ou un temporaire de l'IR : "!" suivi de son index dans la table des symboles
+bool IRInstr::is_symbol(const string &s)
+{
+    if (s.size() < 2 || s[0] != '!')
+        return false;
+    for (size_t i = 1; i < s.size(); i++)
+    {
+        if (!isdigit((unsigned char)s[i]))
+            return false;
+    }
+    return true;
+}
+
+// Une constante entière littérale, éventuellement négative
+bool IRInstr::is_constant(const string &s)
+{
+    size_t start = (!s.empty() && s[0] == '-') ? 1 : 0;
+    if (s.size() <= start)
+        return false;
+    for (size_t i = start; i < s.size(); i++)
+    {
+        if (!isdigit((unsigned char)s[i]))
+            return false;
+    }
+    return true;
+}
+
+// Les chiffres sont accumulés modulo 2^32 : "4294967295" vaut -1, comme pour movl $4294967295
+int32_t IRInstr::constant_value(const string &s)
+{
+    bool negative = !s.empty() && s[0] == '-';
+    uint32_t value = 0;
+    for (size_t i = negative ? 1 : 0; i < s.size(); i++)
+        value = value * 10 + (uint32_t)(s[i] - '0');
+    return (int32_t)(negative ? 0u - value : value);
+}
+
+bool IRInstr::fold(Operation op, int32_t a, int32_t b, int32_t &result)
+{
+    // Les opérations arithmétiques sont faites sur des non signés : débordement défini, modulo 2^32
+    uint32_t x = (uint32_t)a, y = (uint32_t)b;
+    switch (op)
+    {
+    case add:
+        result = (int32_t)(x + y);
+        return true;
+    case sub:
+        result = (int32_t)(x - y);
+        return true;
+    case mul:
+        result = (int32_t)(x * y);
+        return true;
+    case div:
+    case mod:
+        if (b == 0 || (a == INT32_MIN && b == -1))
+            return false;
+        result = (op == div) ? a / b : a % b;
+        return true;
+    case cmp_eq:
+        result = a == b;
+        return true;
+    case cmp_ne:
+        result = a != b;
+        return true;
+    case cmp_lt:
+        result = a < b;
+        return true;
+    case cmp_gt:
+        result = a > b;
+        return true;
+    case cmp_le:
+        result = a <= b;
+        return true;
+    case cmp_ge:
+        result = a >= b;
+        return true;
+    case not_op:
+        result = a == 0;
+        return true;
+    case abs_op:
+        result = a < 0 ? (int32_t)(0u - x) : a;
+        return true;
+    case bit_and:
+        result = (int32_t)(x & y);
+        return true;
+    case bit_xor:
+        result = (int32_t)(x ^ y);
+        return true;
+    case bit_or:
+        result = (int32_t)(x | y);
+        return true;
+    case logical_and:
+        result = a != 0 && b != 0;
+        return true;
+    case logical_or:
+        result = a != 0 || b != 0;
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Plus petit décalage p >= 32 tel que 2^p / |d| arrondi au-dessus donne un quotient exact pour tout n
+// sur 32 bits (Hacker's Delight, figure 10-1)
+void IRInstr::signed_magic(int32_t d, int32_t &multiplier, int &shift)
+{
+    const uint32_t two31 = 0x80000000u;
+    uint32_t ad = d < 0 ? 0u - (uint32_t)d : (uint32_t)d;
+    uint32_t t = two31 + ((uint32_t)d >> 31);
+    uint32_t anc = t - 1 - t % ad; // |nc|
+    int p = 31;
+    uint32_t q1 = two31 / anc, r1 = two31 - q1 * anc; // 2^p / |nc|
+    uint32_t q2 = two31 / ad, r2 = two31 - q2 * ad;   // 2^p / |d|
+    uint32_t delta;
+    do
+    {
+        p++;
+        q1 *= 2;
+        r1 *= 2;
+        if (r1 >= anc)
+        {
+            q1++;
+            r1 -= anc;
+        }
+        q2 *= 2;
+        r2 *= 2;
+        if (r2 >= ad)
+        {
+            q2++;
+            r2 -= ad;
+        }
+        delta = ad - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+
+    multiplier = (int32_t)(q2 + 1);
+    if (d < 0)
+        multiplier = (int32_t)(0u - (uint32_t)multiplier);
+    shift = p - 32;
+}
+
+// Un registre physique (paramètres reçus dans %edi, %esi... en x86 ou w0-w7 en ARM)
+bool IRInstr::is_register(const string &s)
+{
+    if (s.empty())
+        return false;
+    if (s[0] == '%')
+        return true;
+    return s.size() >= 2 && s[0] == 'w' && isdigit((unsigned char)s[1]);
+}
+
+// Rang du paramètre transmis dans un registre : %edi, %esi, %edx, %ecx, %r8d, %r9d en x86, w0-w7 en ARM
+int IRInstr::argument_index(const string &s)
+{
+    static const char *x86[] = {"%edi", "%esi", "%edx", "%ecx", "%r8d", "%r9d"};
+    for (int i = 0; i < 6; i++)
+    {
+        if (s == x86[i])
+            return i;
+    }
+    if (s.size() == 2 && s[0] == 'w' && s[1] >= '0' && s[1] <= '7')
+        return s[1] - '0';
+    return -1;
+}
+
+bool IRInstr::is_comparison(Operation op)
+{
+    return op == cmp_eq || op == cmp_ne || op == cmp_lt || op == cmp_gt || op == cmp_le || op == cmp_ge;
+}
+
+bool IRInstr::is_commutative(Operation op)
+{
+    return op == add || op == mul || op == bit_and || op == bit_or || op == bit_xor || op == cmp_eq ||
+           op == cmp_ne || op == logical_and || op == logical_or;
+}
+
+// phi dest, val0, label0, val1, label1...
+string IRInstr::get_phi_value(const string &label) const
+{
+    for (size_t i = 1; i + 1 < params.size(); i += 2)
+    {
+        if (params[i + 1] == label)
+            return params[i];
+    }
+    return "";
+}
+
+// Variable écrite par l'instruction
+// call écrit dans params[1] (params[0] est le nom de la fonction), ret n'écrit rien
+string IRInstr::get_dest() const
+{
+    switch (op)
+    {
+    case call:
+        return params[1];
+    case ret:
+        return "";
+    default:
+        return params[0];
+    }
+}
+
+// Positions des opérandes lus par l'instruction
+vector<size_t> IRInstr::get_use_indices() const
+{
+    switch (op)
+    {
+    case ldconst:
+        return {};
+    case rmem:
+    case wmem:
+    case not_op:
+    case abs_op:
+    case copy:
+        return {1};
+    case select:
+        return {1, 2, 3};
+    case ret:
+        return {0};
+    case phi:
+    {
+        // Les valeurs entrantes (les labels des prédécesseurs ne sont pas des opérandes)
+        vector<size_t> uses;
+        for (size_t i = 1; i < params.size(); i += 2)
+            uses.push_back(i);
+        return uses;
+    }
+    case call:
+    {
+        vector<size_t> uses;
+        for (size_t i = 2; i < params.size(); i++)
+            uses.push_back(i);
+        return uses;
+    }
+    default:
+        return {1, 2};
+    }
+}
+
+// Seuls les appels (putchar, getchar, fonctions utilisateur) et le retour ont un effet observable
+bool IRInstr::has_side_effects() const
+{
+    return op == call || op == ret;
+}
+
+// Nom textuel d'une opération (utilisé pour l'affichage de l'IR)
+string IRInstr::op_name(Operation op)
+{
+    switch (op)
+    {
+    case ldconst: return "ldconst";
+    case add: return "add";
+    case sub: return "sub";
+    case mul: return "mul";
+    case div: return "div";
+    case mod: return "mod";
+    case rmem: return "rmem";
+    case wmem: return "wmem";
+    case call: return "call";
+    case cmp_eq: return "cmp_eq";
+    case cmp_ne: return "cmp_ne";
+    case cmp_lt: return "cmp_lt";
+    case cmp_gt: return "cmp_gt";
+    case cmp_le: return "cmp_le";
+    case cmp_ge: return "cmp_ge";
+    case not_op: return "not";
+    case bit_and: return "bit_and";
+    case bit_xor: return "bit_xor";
+    case bit_or: return "bit_or";
+    case logical_and: return "logical_and";
+    case logical_or: return "logical_or";
+    case ret: return "ret";
+    case phi: return "phi";
+    case copy: return "copy";
+    case select: return "select";
+    case abs_op: return "abs";
+    }
+    return "?";
+}
+
+// Opération correspondant à un nom (inverse de op_name, utilisé pour relire l'IR textuel)
+bool IRInstr::op_from_name(const string &name, Operation &op)
+{
+    for (int i = 0; op_name((Operation)i) != "?"; i++)
+    {
+        if (op_name((Operation)i) == name)
+        {
+            op = (Operation)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Affiche l'instruction sous la forme "op p0, p1, ..."
+void IRInstr::print(ostream &o) const
+{
+    o << (tailCall ? "tail " : "") << op_name(op);
+    for (size_t i = 0; i < params.size(); i++)
+    {
+        o << (i == 0 ? " " : ", ") << params[i];
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Réduction de force : multiplications, divisions et modulos par une constante
+// ---------------------------------------------------------------------------
+// Le diviseur (ou un facteur) est constant quand sa case n'est écrite que par un ldconst
+// (CFG::get_constant_slot). imul coûte 3 cycles et idiv plusieurs dizaines : décalages, lea
+// et multiplication par l'inverse (« nombre magique ») les remplacent. Une division par 0 ou par
+// INT_MIN garde idiv/sdiv (la première doit toujours provoquer l'erreur à l'exécution).
+
+// Exposant k si u = 2^k, -1 sinon
+static int log2_exact(uint32_t u)
+{
+    if (u == 0 || (u & (u - 1)) != 0)
+        return -1;
+    int k = 0;
+    while ((u >> k) != 1)
+        k++;
+    return k;
+}
+
+// Opérande constant d'une multiplication (l'un ou l'autre) : x reçoit l'autre opérande
+static bool constant_factor(const CFG *cfg, const vector<string> &params, int32_t &c, string &x)
+{
+    if (cfg->get_constant_slot(params[2], c))
+    {
+        x = params[1];
+        return true;
+    }
+    if (cfg->get_constant_slot(params[1], c))
+    {
+        x = params[2];
+        return true;
+    }
+    return false;
+}
+
+// %eax *= c (%ecx libre) ; faux si aucune séquence ne remplace imull
+static bool x86_mul_by_constant(ostream &o, int32_t c)
+{
+    uint32_t u = (uint32_t)c;
+    bool negate = false;
+    if (c < 0 && log2_exact(u) < 0)
+    {
+        negate = true;
+        u = 0u - u;
+    }
+    int k = log2_exact(u);
+    if (c == 0)
+        o << "\txorl\t%eax, %eax\n";
+    else if (k >= 0)
+    {
+        if (k > 0)
+            o << "\tsall\t$" << k << ", %eax\n";
+    }
+    else
+    {
+        // u = m * 2^k avec m = 3, 5 ou 9 : lea, puis décalage
+        int m = 0;
+        for (int candidate : {9, 5, 3})
+        {
+            if (u % candidate == 0 && log2_exact(u / candidate) >= 0)
+            {
+                m = candidate;
+                k = log2_exact(u / candidate);
+                break;
+            }
+        }
+        if (m)
+        {
+            o << "\tleal\t(%eax,%eax," << m - 1 << "), %eax\n";
+            if (k > 0)
+                o << "\tsall\t$" << k << ", %eax\n";
+        }
+        else if (log2_exact(u - 1) >= 0)
+        {
+            // 2^k + 1
+            o << "\tmovl\t%eax, %ecx\n";
+            o << "\tsall\t$" << log2_exact(u - 1) << ", %eax\n";
+            o << "\taddl\t%ecx, %eax\n";
+        }
+        else if (log2_exact(u + 1) >= 0)
+        {
+            // 2^k - 1
+            o << "\tmovl\t%eax, %ecx\n";
+            o << "\tsall\t$" << log2_exact(u + 1) << ", %eax\n";
+            o << "\tsubl\t%ecx, %eax\n";
+        }
+        else
+            return false;
+    }
+    if (negate)
+        o << "\tnegl\t%eax\n";
+    return true;
+}
+
+// %eax = %eax / c ou %eax % c (%ecx et %edx libres) ; faux si idivl doit être gardé
+static bool x86_div_by_constant(ostream &o, int32_t c, bool modulo)
+{
+    if (c == 0 || c == INT32_MIN)
+        return false;
+    if (c == 1 || c == -1)
+    {
+        if (modulo)
+            o << "\txorl\t%eax, %eax\n";
+        else if (c == -1)
+            o << "\tnegl\t%eax\n";
+        return true;
+    }
+
+    uint32_t u = c < 0 ? 0u - (uint32_t)c : (uint32_t)c;
+    int k = log2_exact(u);
+    if (k > 0)
+    {
+        // Arrondi vers zéro : on ajoute 2^k - 1 aux dividendes négatifs avant le décalage
+        o << "\tmovl\t%eax, %edx\n";
+        if (k > 1)
+            o << "\tsarl\t$31, %edx\n";
+        o << "\tshrl\t$" << 32 - k << ", %edx\n";
+        if (modulo)
+        {
+            o << "\tleal\t(%eax,%edx), %ecx\n";
+            o << "\tandl\t$" << -(int64_t)u << ", %ecx\n";
+            o << "\tsubl\t%ecx, %eax\n";
+        }
+        else
+        {
+            o << "\taddl\t%edx, %eax\n";
+            o << "\tsarl\t$" << k << ", %eax\n";
+            if (c < 0)
+                o << "\tnegl\t%eax\n";
+        }
+        return true;
+    }
+
+    int32_t multiplier;
+    int shift;
+    IRInstr::signed_magic(c, multiplier, shift);
+    o << "\tmovl\t%eax, %ecx\n";
+    o << "\tmovl\t$" << multiplier << ", %eax\n";
+    o << "\timull\t%ecx\n"; // %edx = 32 bits de poids fort du produit
+    if (c > 0 && multiplier < 0)
+        o << "\taddl\t%ecx, %edx\n";
+    else if (c < 0 && multiplier > 0)
+        o << "\tsubl\t%ecx, %edx\n";
+    if (shift > 0)
+        o << "\tsarl\t$" << shift << ", %edx\n";
+    o << "\tmovl\t%edx, %eax\n";
+    o << "\tshrl\t$31, %eax\n";
+    o << "\taddl\t%eax, %edx\n"; // quotient tronqué vers zéro
+    if (modulo)
+    {
+        o << "\timull\t$" << c << ", %edx, %edx\n";
+        o << "\tmovl\t%ecx, %eax\n";
+        o << "\tsubl\t%edx, %eax\n";
+    }
+    else
+        o << "\tmovl\t%edx, %eax\n";
+    return true;
+}
+
+// Suffixe de condition (jcc/cmovcc en x86, b.cond/csel en ARM) vrai quand la comparaison op est vraie
+// (ou fausse si negate)
+static string condition_code(IRInstr::Operation op, bool negate)
+{
+    static const map<IRInstr::Operation, std::pair<string, string>> codes = {
+#ifdef ARM
+        {IRInstr::cmp_eq, {"eq", "ne"}}, {IRInstr::cmp_ne, {"ne", "eq"}}, {IRInstr::cmp_lt, {"lt", "ge"}},
+        {IRInstr::cmp_gt, {"gt", "le"}}, {IRInstr::cmp_le, {"le", "gt"}}, {IRInstr::cmp_ge, {"ge", "lt"}}};
+#else
+        {IRInstr::cmp_eq, {"e", "ne"}}, {IRInstr::cmp_ne, {"ne", "e"}}, {IRInstr::cmp_lt, {"l", "ge"}},
+        {IRInstr::cmp_gt, {"g", "le"}}, {IRInstr::cmp_le, {"le", "g"}}, {IRInstr::cmp_ge, {"ge", "l"}}};
+#endif
+    const std::pair<string, string> &code = codes.at(op);
+    return negate ? code.second : code.first;
+}
+
 // Génère le code assembleur x86 pour cette instruction IR
 void IRInstr::gen_asm_x86(ostream &o)
 {
@@ -76,22 +559,40 @@ void IRInstr::gen_asm_x86(ostream &o)
         o << "\tmovl\t%eax, " << IR_reg_to_asm(params[0]) << "\n";
         break;
     case mul:
+    {
+        int32_t c;
+        string x;
+        if (constant_factor(bb->cfg, params, c, x))
+        {
+            std::ostringstream reduced;
+            if (x86_mul_by_constant(reduced, c))
+            {
+                o << "\tmovl\t" << IR_reg_to_asm(x) << ", %eax\n";
+                o << reduced.str();
+                o << "\tmovl\t%eax, " << IR_reg_to_asm(params[0]) << "\n";
+                break;
+            }
+        }
         o << "\tmovl\t" << IR_reg_to_asm(params[1]) << ", %eax\n";
         o << "\timull\t" << IR_reg_to_asm(params[2]) << ", %eax\n";
         o << "\tmovl\t%eax, " << IR_reg_to_asm(params[0]) << "\n";
         break;
+    }
     case div:
-        o << "\tmovl\t" << IR_reg_to_asm(params[1]) << ", %eax\n";
-        o << "\tcltd\n"; // Sign extend eax into edx
-        o << "\tidivl\t" << IR_reg_to_asm(params[2]) << "\n";
-        o << "\tmovl\t%eax, " << IR_reg_to_asm(params[0]) << "\n";
-        break;
     case mod:
+    {
         o << "\tmovl\t" << IR_reg_to_asm(params[1]) << ", %eax\n";
+        int32_t c;
+        if (bb->cfg->get_constant_slot(params[2], c) && x86_div_by_constant(o, c, op == mod))
+        {
+            o << "\tmovl\t%eax, " << IR_reg_to_asm(params[0]) << "\n";
+            break;
+        }
         o << "\tcltd\n"; // Sign extend eax into edx
         o << "\tidivl\t" << IR_reg_to_asm(params[2]) << "\n";
-        o << "\tmovl\t%edx, " << IR_reg_to_asm(params[0]) << "\n";
+        o << "\tmovl\t" << (op == div ? "%eax, " : "%edx, ") << IR_reg_to_asm(params[0]) << "\n";
         break;
+    }
     case rmem:
         if (params[1][0] == '%')
         {
@@ -171,6 +672,33 @@ void IRInstr::gen_asm_x86(ostream &o)
         o << "\tmovzbl\t%al, %eax\n";
         o << "\tmovl\t%eax, " << IR_reg_to_asm(params[0]) << "\n";
         break;
+    case select:
+    {
+        // Sans branchement : b, remplacé par a si la condition est vraie (cmov)
+        IRInstr *compare = bb->get_select_compare(this);
+        string cc = "ne";
+        if (compare)
+        {
+            const vector<string> &c = compare->get_params();
+            o << "\tmovl\t" << IR_reg_to_asm(c[1]) << ", %eax\n";
+            o << "\tcmpl\t" << IR_reg_to_asm(c[2]) << ", %eax\n";
+            cc = condition_code(compare->get_op(), false);
+        }
+        else
+            o << "\tcmpl\t$0, " << IR_reg_to_asm(params[1]) << "\n";
+        o << "\tmovl\t" << IR_reg_to_asm(params[3]) << ", %eax\n";
+        o << "\tcmov" << cc << "\t" << IR_reg_to_asm(params[2]) << ", %eax\n";
+        o << "\tmovl\t%eax, " << IR_reg_to_asm(params[0]) << "\n";
+        break;
+    }
+    case abs_op:
+        // -x, ou x si -x est négatif (abs(INT_MIN) reste INT_MIN)
+        o << "\tmovl\t" << IR_reg_to_asm(params[1]) << ", %eax\n";
+        o << "\tmovl\t%eax, %ecx\n";
+        o << "\tnegl\t%eax\n";
+        o << "\tcmovl\t%ecx, %eax\n";
+        o << "\tmovl\t%eax, " << IR_reg_to_asm(params[0]) << "\n";
+        break;
     case bit_and:
         o << "\tmovl\t" << IR_reg_to_asm(params[1]) << ", %eax\n";
         o << "\tandl\t" << IR_reg_to_asm(params[2]) << ", %eax\n";
@@ -189,6 +717,22 @@ void IRInstr::gen_asm_x86(ostream &o)
     case ret:
         o << "\tmovl\t" << IR_reg_to_asm(params[0]) << ", %eax\n";
         break;
+    case copy:
+        if (params[0] == params[1])
+            break;
+        if (is_constant(params[1]))
+            o << "\tmovl\t$" << params[1] << ", " << IR_reg_to_asm(params[0]) << "\n";
+        else if (is_register(params[1]))
+            o << "\tmovl\t" << params[1] << ", " << IR_reg_to_asm(params[0]) << "\n";
+        else
+        {
+            o << "\tmovl\t" << IR_reg_to_asm(params[1]) << ", %eax\n";
+            o << "\tmovl\t%eax, " << IR_reg_to_asm(params[0]) << "\n";
+        }
+        break;
+    case phi:
+        // Jamais émis : la passe out-of-ssa remplace les phi par des copies avant la génération de code
+        break;
     case call:
         // Sauvegarder les registres qui pourraient être modifiés
         o << "\tpushq\t%rax\n";
@@ -313,26 +857,130 @@ void IRInstr::gen_asm_x86(ostream &o)
     }
 }
 
+// Charge une constante 32 bits dans reg (mov si elle tient sur 16 bits, sinon movz/movk)
+static void arm_load_constant(ostream &o, const string &constant, const string &reg = "w0")
+{
+    int value = IRInstr::constant_value(constant);
+    uint32_t uval = static_cast<uint32_t>(value);
+    if (value >= 0 && value <= 65535) {
+        o << "\tmov " << reg << ", #" << value << "\n";
+    } else {
+        uint16_t low = uval & 0xFFFF;
+        uint16_t mid = (uval >> 16) & 0xFFFF;
+        o << "\tmovz " << reg << ", #" << low << "\n";
+        if (mid)
+            o << "\tmovk " << reg << ", #" << mid << ", lsl #16\n";
+    }
+}
+
+// w0 *= c (w1 libre) ; faux si aucune séquence ne remplace mul (voir x86_mul_by_constant)
+static bool arm_mul_by_constant(ostream &o, int32_t c)
+{
+    uint32_t u = (uint32_t)c;
+    bool negate = false;
+    if (c < 0 && log2_exact(u) < 0)
+    {
+        negate = true;
+        u = 0u - u;
+    }
+    int k = log2_exact(u);
+    if (c == 0)
+        o << "\tmov w0, #0\n";
+    else if (k >= 0)
+    {
+        if (k > 0)
+            o << "\tlsl w0, w0, #" << k << "\n";
+    }
+    else
+    {
+        // u = (2^j + 1) * 2^k : une addition avec opérande décalé, puis un décalage
+        k = 0;
+        while (((u >> k) & 1) == 0)
+            k++;
+        int j = log2_exact((u >> k) - 1);
+        if (j > 0)
+        {
+            o << "\tadd w0, w0, w0, lsl #" << j << "\n";
+            if (k > 0)
+                o << "\tlsl w0, w0, #" << k << "\n";
+        }
+        else if (log2_exact(u + 1) >= 0)
+        {
+            // 2^k - 1
+            o << "\tlsl w1, w0, #" << log2_exact(u + 1) << "\n";
+            o << "\tsub w0, w1, w0\n";
+        }
+        else
+            return false;
+    }
+    if (negate)
+        o << "\tneg w0, w0\n";
+    return true;
+}
+
+// w0 = w0 / c ou w0 % c (w1, w2 et x2 libres) ; faux si sdiv doit être gardé (voir x86_div_by_constant)
+static bool arm_div_by_constant(ostream &o, int32_t c, bool modulo)
+{
+    if (c == 0 || c == INT32_MIN)
+        return false;
+    if (c == 1 || c == -1)
+    {
+        if (modulo)
+            o << "\tmov w0, #0\n";
+        else if (c == -1)
+            o << "\tneg w0, w0\n";
+        return true;
+    }
+
+    uint32_t u = c < 0 ? 0u - (uint32_t)c : (uint32_t)c;
+    int k = log2_exact(u);
+    if (k > 0)
+    {
+        // Dividende négatif : + 2^k - 1 avant le décalage arithmétique
+        o << "\tasr w1, w0, #31\n";
+        o << "\tadd w1, w0, w1, lsr #" << 32 - k << "\n";
+        o << "\tasr w1, w1, #" << k << "\n";
+        if (modulo)
+            o << "\tsub w0, w0, w1, lsl #" << k << "\n";
+        else if (c < 0)
+            o << "\tneg w0, w1\n";
+        else
+            o << "\tmov w0, w1\n";
+        return true;
+    }
+
+    int32_t multiplier;
+    int shift;
+    IRInstr::signed_magic(c, multiplier, shift);
+    arm_load_constant(o, std::to_string(multiplier), "w1");
+    o << "\tsmull x2, w0, w1\n";
+    o << "\tasr x2, x2, #32\n"; // 32 bits de poids fort du produit
+    if (c > 0 && multiplier < 0)
+        o << "\tadd w2, w2, w0\n";
+    else if (c < 0 && multiplier > 0)
+        o << "\tsub w2, w2, w0\n";
+    if (shift > 0)
+        o << "\tasr w2, w2, #" << shift << "\n";
+    o << "\tadd w2, w2, w2, lsr #31\n"; // quotient tronqué vers zéro
+    if (modulo)
+    {
+        arm_load_constant(o, std::to_string(c), "w1");
+        o << "\tmsub w0, w2, w1, w0\n";
+    }
+    else
+        o << "\tmov w0, w2\n";
+    return true;
+}
+
 // Génère le code assembleur ARM pour cette instruction IR
 void IRInstr::gen_asm_arm(ostream &o)
 {
     switch (op)
     {
-    case ldconst: {
-        int value = std::stoi(params[1]);
-        uint32_t uval = static_cast<uint32_t>(value);
-        if (value >= 0 && value <= 65535) {
-            o << "\tmov w0, #" << value << "\n";
-        } else {
-            uint16_t low = uval & 0xFFFF;
-            uint16_t mid = (uval >> 16) & 0xFFFF;
-            o << "\tmovz w0, #" << low << "\n";
-            if (mid)
-                o << "\tmovk w0, #" << mid << ", lsl #16\n";
-        }
+    case ldconst:
+        arm_load_constant(o, params[1]);
         o << "\tstr w0, [sp, #" << IR_reg_to_asm(params[0]) << "]\n";
         break;
-    }
     case add:
         o << "\tldr w0, [sp, #" << IR_reg_to_asm(params[1]) << "]\n";
         o << "\tldr w1, [sp, #" << IR_reg_to_asm(params[2]) << "]\n";
@@ -346,25 +994,48 @@ void IRInstr::gen_asm_arm(ostream &o)
         o << "\tstr w0, [sp, #" << IR_reg_to_asm(params[0]) << "]\n";
         break;
     case mul:
+    {
+        int32_t c;
+        string x;
+        if (constant_factor(bb->cfg, params, c, x))
+        {
+            std::ostringstream reduced;
+            if (arm_mul_by_constant(reduced, c))
+            {
+                o << "\tldr w0, [sp, #" << IR_reg_to_asm(x) << "]\n";
+                o << reduced.str();
+                o << "\tstr w0, [sp, #" << IR_reg_to_asm(params[0]) << "]\n";
+                break;
+            }
+        }
         o << "\tldr w0, [sp, #" << IR_reg_to_asm(params[1]) << "]\n";
         o << "\tldr w1, [sp, #" << IR_reg_to_asm(params[2]) << "]\n";
         o << "\tmul w0, w0, w1\n";
         o << "\tstr w0, [sp, #" << IR_reg_to_asm(params[0]) << "]\n";
         break;
+    }
     case div:
-        o << "\tldr w0, [sp, #" << IR_reg_to_asm(params[1]) << "]\n";
-        o << "\tldr w1, [sp, #" << IR_reg_to_asm(params[2]) << "]\n";
-        o << "\tsdiv w0, w0, w1\n";
-        o << "\tstr w0, [sp, #" << IR_reg_to_asm(params[0]) << "]\n";
-        break;
     case mod:
+    {
         o << "\tldr w0, [sp, #" << IR_reg_to_asm(params[1]) << "]\n";
+        int32_t c;
+        if (bb->cfg->get_constant_slot(params[2], c) && arm_div_by_constant(o, c, op == mod))
+        {
+            o << "\tstr w0, [sp, #" << IR_reg_to_asm(params[0]) << "]\n";
+            break;
+        }
         o << "\tldr w1, [sp, #" << IR_reg_to_asm(params[2]) << "]\n";
-        o << "\tsdiv w2, w0, w1\n";
-        o << "\tmul w2, w2, w1\n";
-        o << "\tsub w0, w0, w2\n";
+        if (op == div)
+            o << "\tsdiv w0, w0, w1\n";
+        else
+        {
+            o << "\tsdiv w2, w0, w1\n";
+            o << "\tmul w2, w2, w1\n";
+            o << "\tsub w0, w0, w2\n";
+        }
         o << "\tstr w0, [sp, #" << IR_reg_to_asm(params[0]) << "]\n";
         break;
+    }
     case rmem:
         if (params[1].size() >= 2 && params[1][0] == 'w' && isdigit(params[1][1])) {
             // Read from a register (w0-w7)
@@ -391,12 +1062,58 @@ void IRInstr::gen_asm_arm(ostream &o)
         // Always move the return value to w0
         o << "\tldr w0, [sp, #" << IR_reg_to_asm(params[0]) << "]\n";
         break;
+    case copy:
+        if (params[0] == params[1])
+            break;
+        if (is_constant(params[1])) {
+            arm_load_constant(o, params[1]);
+            o << "\tstr w0, [sp, #" << IR_reg_to_asm(params[0]) << "]\n";
+        } else if (is_register(params[1])) {
+            o << "\tstr " << params[1] << ", [sp, #" << IR_reg_to_asm(params[0]) << "]\n";
+        } else {
+            o << "\tldr w0, [sp, #" << IR_reg_to_asm(params[1]) << "]\n";
+            o << "\tstr w0, [sp, #" << IR_reg_to_asm(params[0]) << "]\n";
+        }
+        break;
+    case phi:
+        // Jamais émis : la passe out-of-ssa remplace les phi par des copies avant la génération de code
+        break;
     case not_op:
         o << "\tldr w0, [sp, #" << IR_reg_to_asm(params[1]) << "]\n";
         o << "\tcmp w0, #0\n";
         o << "\tcset w0, eq\n";
         o << "\tstr w0, [sp, #" << IR_reg_to_asm(params[0]) << "]\n";
         break;
+    case select:
+    {
+        // Sans branchement : csel entre a et b selon la condition
+        IRInstr *compare = bb->get_select_compare(this);
+        string cc = "ne";
+        if (compare)
+        {
+            const vector<string> &c = compare->get_params();
+            o << "\tldr w0, [sp, #" << IR_reg_to_asm(c[1]) << "]\n";
+            o << "\tldr w1, [sp, #" << IR_reg_to_asm(c[2]) << "]\n";
+            o << "\tcmp w0, w1\n";
+            cc = condition_code(compare->get_op(), false);
+        }
+        else
+        {
+            o << "\tldr w0, [sp, #" << IR_reg_to_asm(params[1]) << "]\n";
+            o << "\tcmp w0, #0\n";
+        }
+        o << "\tldr w1, [sp, #" << IR_reg_to_asm(params[2]) << "]\n";
+        o << "\tldr w2, [sp, #" << IR_reg_to_asm(params[3]) << "]\n";
+        o << "\tcsel w0, w1, w2, " << cc << "\n";
+        o << "\tstr w0, [sp, #" << IR_reg_to_asm(params[0]) << "]\n";
+        break;
+    }
+    case abs_op:
+        o << "\tldr w0, [sp, #" << IR_reg_to_asm(params[1]) << "]\n";
+        o << "\tcmp w0, #0\n";
+        o << "\tcneg w0, w0, lt\n";
+        o << "\tstr w0, [sp, #" << IR_reg_to_asm(params[0]) << "]\n";
+        break;
     case bit_and:
         o << "\tldr w0, [sp, #" << IR_reg_to_asm(params[1]) << "]\n";
         o << "\tldr w1, [sp, #" << IR_reg_to_asm(params[2]) << "]\n";
@@ -502,11 +1219,68 @@ void IRInstr::gen_asm_arm(ostream &o)
 // Les BasicBlocks sont reliés entre eux dans le CFG pour modéliser le flot d'exécution (if/else, branchements, etc.)
 // La génération d'assembleur se fait bloc par bloc, dans l'ordre d'exécution du CFG
 BasicBlock::BasicBlock(CFG *cfg, string entry_label)
-    : cfg(cfg), label(entry_label), exit_true(nullptr), exit_false(nullptr)
+    : cfg(cfg), label(entry_label), exit_true(nullptr), exit_false(nullptr), expected_branch(-1), cold(false)
 {
     cfg->add_bb(this);
 }
 
+BasicBlock::~BasicBlock()
+{
+    for (IRInstr *instr : instrs)
+    {
+        delete instr;
+    }
+}
+
+// Successeurs du bloc dans le CFG
+vector<BasicBlock *> BasicBlock::get_successors() const
+{
+    vector<BasicBlock *> succs;
+    if (exit_true)
+        succs.push_back(exit_true);
+    if (exit_false && exit_false != exit_true)
+        succs.push_back(exit_false);
+    return succs;
+}
+
+void BasicBlock::rename_phi_label(const string &from, const string &to)
+{
+    for (IRInstr *instr : instrs)
+    {
+        if (instr->get_op() != IRInstr::phi)
+            break;
+        vector<string> &p = instr->get_params();
+        for (size_t i = 2; i < p.size(); i += 2)
+        {
+            if (p[i] == from)
+                p[i] = to;
+        }
+    }
+}
+
+// Affiche le bloc : label, instructions, puis le branchement de sortie
+void BasicBlock::print(ostream &o) const
+{
+    o << "bb " << label << ":" << (cold ? " cold" : "") << endl;
+    for (IRInstr *instr : instrs)
+    {
+        o << "  ";
+        instr->print(o);
+        o << endl;
+    }
+    if (exit_true == nullptr)
+        o << "  exit" << endl;
+    else if (exit_false == nullptr)
+        o << "  jmp " << exit_true->label << endl;
+    else
+    {
+        o << "  br " << test_var_name << ", " << exit_true->label << ", " << exit_false->label;
+        if (expected_branch >= 0)
+            o << (expected_branch ? ", likely" : ", unlikely");
+        o << endl;
+    }
+}
+
 // Ajoute une instruction IR à ce bloc
 void BasicBlock::add_IRInstr(IRInstr::Operation op, Type t, vector<string> params)
 {
@@ -514,15 +1288,86 @@ void BasicBlock::add_IRInstr(IRInstr::Operation op, Type t, vector<string> param
     instrs.push_back(instr);
 }
 
+// Comparaison qui calcule la condition du branchement de fin de bloc, si elle peut lui être fusionnée
+IRInstr *BasicBlock::get_fused_compare() const
+{
+    if (exit_false == nullptr || instrs.empty())
+        return nullptr;
+    IRInstr *last = instrs.back();
+    if (!IRInstr::is_comparison(last->get_op()))
+        return nullptr;
+    if (last->get_params()[0] != test_var_name || cfg->get_use_count(test_var_name) != 1)
+        return nullptr;
+    return last;
+}
+
+// Comparaison placée juste avant le select et lue seulement par lui : elle positionne directement
+// les drapeaux du cmov/csel
+IRInstr *BasicBlock::get_select_compare(const IRInstr *select) const
+{
+    if (select->get_op() != IRInstr::select)
+        return nullptr;
+    auto it = std::find(instrs.begin(), instrs.end(), select);
+    if (it == instrs.begin() || it == instrs.end())
+        return nullptr;
+    IRInstr *previous = *(it - 1);
+    switch (previous->get_op())
+    {
+    case IRInstr::cmp_eq:
+    case IRInstr::cmp_ne:
+    case IRInstr::cmp_lt:
+    case IRInstr::cmp_gt:
+    case IRInstr::cmp_le:
+    case IRInstr::cmp_ge:
+        break;
+    default:
+        return nullptr;
+    }
+    const string &cond = select->get_params()[1];
+    if (previous->get_params()[0] != cond || cfg->get_use_count(cond) != 1)
+        return nullptr;
+    return previous;
+}
+
+// Appel terminal : le bloc termine la fonction et retourne directement le résultat de son dernier
+// appel, marqué par la passe tailrec (à -O0, un appel reste un call). La forme est vérifiée de nouveau
+// ici, les passes suivantes ayant pu la défaire. Les arguments doivent tenir dans les registres (6 sur
+// x86, 8 sur ARM) : rien n'est alors empilé et l'appelé réutilise l'adresse de retour de l'appelant
+IRInstr *BasicBlock::get_tail_call() const
+{
+    if (exit_true != nullptr || instrs.size() < 2)
+        return nullptr;
+    IRInstr *ret = instrs.back();
+    IRInstr *call = instrs[instrs.size() - 2];
+    if (ret->get_op() != IRInstr::ret || call->get_op() != IRInstr::call || !call->is_tail_call() ||
+        ret->get_params()[0] != call->get_params()[1])
+        return nullptr;
+#ifdef ARM
+    const size_t maxArgs = 8;
+#else
+    const size_t maxArgs = 6;
+#endif
+    if (call->get_params().size() - 2 > maxArgs)
+        return nullptr;
+    return call;
+}
+
 // Génère le code assembleur pour ce bloc (x86 ou ARM)
-void BasicBlock::gen_asm(ostream &o)
+void BasicBlock::gen_asm(ostream &o, BasicBlock *next, bool epilogueNext)
 {
     // Génère le label du bloc
     o << label << ":" << endl;
 
-    // Génère le code pour chaque instruction
-    for (IRInstr *instr : instrs)
+    // Génère le code pour chaque instruction (une comparaison fusionnée est émise avec le branchement
+    // ou le select qui la lit)
+    IRInstr *fused = get_fused_compare();
+    IRInstr *tailCall = get_tail_call();
+    size_t count = tailCall ? instrs.size() - 2 : instrs.size();
+    for (size_t i = 0; i < count; i++)
     {
+        IRInstr *instr = instrs[i];
+        if (instr == fused || (i + 1 < instrs.size() && get_select_compare(instrs[i + 1]) == instr))
+            continue;
 #ifdef ARM
         instr->gen_asm_arm(o);
 #else
@@ -530,31 +1375,105 @@ void BasicBlock::gen_asm(ostream &o)
 #endif
     }
 
-    // Gestion des branches (contrôle de flot)
+    if (tailCall != nullptr)
+    {
+        // Appel terminal : arguments dans les registres, cadre libéré, puis saut vers l'appelé qui
+        // retournera directement à notre appelant
+        const vector<string> &p = tailCall->get_params();
+#ifdef ARM
+        for (size_t i = 2; i < p.size(); i++)
+            o << "\tldr w" << (i - 2) << ", [sp, #" << IRInstr::IR_reg_to_asm(p[i]) << "]" << endl;
+#else
+        static const char *argRegs[] = {"%edi", "%esi", "%edx", "%ecx", "%r8d", "%r9d"};
+        for (size_t i = 2; i < p.size(); i++)
+            o << "\tmovl\t" << IRInstr::IR_reg_to_asm(p[i]) << ", " << argRegs[i - 2] << endl;
+#endif
+        cfg->gen_asm_frame_release(o);
+        string target = p[0];
+#ifdef __APPLE__
+        if (externalFunctions.count(target))
+            target = "_" + target;
+#endif
+#ifdef ARM
+        o << "\tb " << target << endl;
+#else
+        o << "\tjmp " << target << endl;
+#endif
+        return;
+    }
+
+    // Gestion des branches (contrôle de flot) ; aucun saut vers le bloc émis juste après
     if (exit_true == nullptr)
     {
-        // Fin de fonction - ne pas générer l'épilogue ici
+        // Fin de fonction : saut vers l'épilogue (généré une seule fois par CFG::gen_asm, juste après
+        // le dernier bloc chaud)
+        if (epilogueNext)
+            return;
+#ifdef ARM
+        o << "\tb " << cfg->get_epilogue_label() << endl;
+#else
+        o << "\tjmp " << cfg->get_epilogue_label() << endl;
+#endif
     }
     else if (exit_false == nullptr)
     {
         // Branchement inconditionnel
+        if (exit_true == next)
+            return;
 #ifdef ARM
         o << "\tb " << exit_true->label << endl;
 #else
         o << "\tjmp " << exit_true->label << endl;
+#endif
+    }
+    else if (fused != nullptr)
+    {
+        // Branchement conditionnel fusionné : une comparaison, puis un saut selon ses drapeaux. Si la
+        // branche vraie suit immédiatement, on saute vers la branche fausse sur la condition inverse
+        const vector<string> &p = fused->get_params();
+        bool invert = exit_true == next;
+        BasicBlock *target = invert ? exit_false : exit_true;
+        BasicBlock *other = invert ? exit_true : exit_false;
+#ifdef ARM
+        o << "\tldr w0, [sp, #" << IRInstr::IR_reg_to_asm(p[1]) << "]" << endl;
+        o << "\tldr w1, [sp, #" << IRInstr::IR_reg_to_asm(p[2]) << "]" << endl;
+        o << "\tcmp w0, w1" << endl;
+        o << "\tb." << condition_code(fused->get_op(), invert) << " " << target->label << endl;
+        if (other != next)
+            o << "\tb " << other->label << endl;
+#else
+        o << "\tmovl " << IRInstr::IR_reg_to_asm(p[1]) << ", %eax" << endl;
+        o << "\tcmpl " << IRInstr::IR_reg_to_asm(p[2]) << ", %eax" << endl;
+        o << "\tj" << condition_code(fused->get_op(), invert) << " " << target->label << endl;
+        if (other != next)
+            o << "\tjmp " << other->label << endl;
 #endif
     }
     else
     {
-        // Branchement conditionnel
+        // Branchement conditionnel sur la valeur du test, relue depuis sa case
+        // (les passes d'optimisation peuvent avoir déplacé ou supprimé l'instruction qui la calculait)
+        bool invert = exit_false != next;
+        BasicBlock *target = invert ? exit_false : exit_true;
+        BasicBlock *other = invert ? exit_true : exit_false;
 #ifdef ARM
-        o << "\tcmp w0, #0" << endl;
-        o << "\tb.eq " << exit_false->label << endl;
-        o << "\tb " << exit_true->label << endl;
+        o << "\tldr w0, [sp, #" << IRInstr::IR_reg_to_asm(test_var_name) << "]" << endl;
+        o << (invert ? "\tcbz w0, " : "\tcbnz w0, ") << target->label << endl;
+        if (other != next)
+            o << "\tb " << other->label << endl;
 #else
-        o << "\tcmpl $0, %eax" << endl;
-        o << "\tje " << exit_false->label << endl;
-        o << "\tjmp " << exit_true->label << endl;
+        if (IRInstr::is_symbol(test_var_name))
+        {
+            o << "\tcmpl $0, " << IRInstr::IR_reg_to_asm(test_var_name) << endl;
+        }
+        else
+        {
+            o << "\tmovl " << IRInstr::IR_reg_to_asm(test_var_name) << ", %eax" << endl;
+            o << "\tcmpl $0, %eax" << endl;
+        }
+        o << (invert ? "\tje " : "\tjne ") << target->label << endl;
+        if (other != next)
+            o << "\tjmp " << other->label << endl;
 #endif
     }
 }
@@ -566,23 +1485,459 @@ void BasicBlock::gen_asm(ostream &o)
 CFG::CFG(DefFonction *ast)
     : ast(ast), nextFreeSymbolIndex(0), nextBBnumber(0), current_bb(nullptr) {}
 
+CFG::~CFG()
+{
+    for (BasicBlock *bb : bbs)
+    {
+        delete bb;
+    }
+    delete ast;
+}
+
 // Ajoute un BasicBlock au CFG
 void CFG::add_bb(BasicBlock *bb)
 {
     bbs.push_back(bb);
+    labels.insert(bb->label);
+}
+
+// Retire un BasicBlock du CFG et le libère
+void CFG::remove_bb(BasicBlock *bb)
+{
+    bbs.erase(std::remove(bbs.begin(), bbs.end(), bb), bbs.end());
+    labels.erase(bb->label);
+    if (current_bb == bb)
+        current_bb = nullptr;
+    delete bb;
+}
+
+// Retire les blocs que l'entrée n'atteint pas (par exemple le bloc ouvert par VisitorIR après un return)
+// Leurs seuls prédécesseurs sont eux-mêmes inatteignables : aucun arc ne reste pendant
+int CFG::remove_unreachable_bbs()
+{
+    vector<BasicBlock *> reachable = compute_rpo();
+    std::set<BasicBlock *> keep(reachable.begin(), reachable.end());
+    vector<BasicBlock *> dead;
+    for (BasicBlock *bb : bbs)
+    {
+        if (!keep.count(bb))
+            dead.push_back(bb);
+    }
+    for (BasicBlock *bb : dead)
+    {
+        remove_bb(bb);
+    }
+    return dead.size();
+}
+
+// À appeler après la suppression d'arcs ou de blocs (branchement replié, bloc inatteignable)
+void CFG::prune_phis()
+{
+    map<BasicBlock *, vector<BasicBlock *>> preds = compute_predecessors();
+    for (BasicBlock *bb : bbs)
+    {
+        std::set<string> predLabels;
+        for (BasicBlock *pred : preds[bb])
+            predLabels.insert(pred->label);
+        for (IRInstr *instr : bb->instrs)
+        {
+            if (instr->get_op() != IRInstr::phi)
+                break;
+            vector<string> &p = instr->get_params();
+            vector<string> kept = {p[0]};
+            for (size_t i = 1; i + 1 < p.size(); i += 2)
+            {
+                if (predLabels.count(p[i + 1]))
+                {
+                    kept.push_back(p[i]);
+                    kept.push_back(p[i + 1]);
+                }
+            }
+            p = kept;
+        }
+    }
+}
+
+// Clonage de fonction (intégration, spécialisation) : les blocs copiés ne partagent rien avec l'original
+map<BasicBlock *, BasicBlock *> CFG::clone_blocks(const CFG &source, map<string, string> &renamed)
+{
+    auto translate = [&](const string &operand)
+    {
+        auto it = renamed.find(operand);
+        if (it != renamed.end())
+            return it->second;
+        if (!IRInstr::is_symbol(operand))
+            return operand;
+        return renamed[operand] = create_new_tempvar(Type::INT_TYPE);
+    };
+
+    map<BasicBlock *, BasicBlock *> clones;
+    map<string, string> labels;
+    for (BasicBlock *original : source.get_bbs())
+    {
+        clones[original] = new BasicBlock(this, new_BB_name());
+        labels[original->label] = clones[original]->label;
+    }
+    for (BasicBlock *original : source.get_bbs())
+    {
+        BasicBlock *clone = clones[original];
+        for (IRInstr *instr : original->instrs)
+        {
+            // Labels des phi (positions paires) et nom de la fonction appelée ne sont pas des opérandes
+            vector<string> params = instr->get_params();
+            for (size_t i = 0; i < params.size(); i++)
+            {
+                if (instr->get_op() == IRInstr::phi && i > 0 && i % 2 == 0)
+                    params[i] = labels.at(params[i]);
+                else if (instr->get_op() != IRInstr::call || i > 0)
+                    params[i] = translate(params[i]);
+            }
+            clone->instrs.push_back(new IRInstr(clone, instr->get_op(), instr->get_type(), params));
+            clone->instrs.back()->set_tail_call(instr->is_tail_call());
+        }
+        clone->exit_true = original->exit_true ? clones.at(original->exit_true) : nullptr;
+        clone->exit_false = original->exit_false ? clones.at(original->exit_false) : nullptr;
+        if (original->exit_false)
+            clone->test_var_name = translate(original->test_var_name);
+        clone->expected_branch = original->expected_branch;
+    }
+    return clones;
+}
+
+// Les passes SSA (sccp, instcombine...) ne font rien sur un IR qui n'a pas été construit par mem2reg
+bool CFG::is_ssa() const
+{
+    std::set<string> defined;
+    for (BasicBlock *bb : bbs)
+    {
+        for (IRInstr *instr : bb->instrs)
+        {
+            if (instr->get_op() == IRInstr::rmem || instr->get_op() == IRInstr::wmem)
+                return false;
+            string dest = instr->get_dest();
+            if (IRInstr::is_symbol(dest) && !defined.insert(dest).second)
+                return false;
+        }
+    }
+    return true;
+}
+
+int CFG::get_use_count(const string &var) const
+{
+    auto it = useCounts.find(var);
+    return it == useCounts.end() ? 0 : it->second;
+}
+
+int CFG::count_uses(const string &var) const
+{
+    int count = 0;
+    for (BasicBlock *bb : bbs)
+    {
+        for (IRInstr *instr : bb->instrs)
+        {
+            for (size_t i : instr->get_use_indices())
+                count += instr->get_params()[i] == var;
+        }
+        if (bb->exit_false && bb->test_var_name == var)
+            count++;
+    }
+    return count;
+}
+
+int CFG::count_instructions() const
+{
+    int count = 0;
+    for (BasicBlock *bb : bbs)
+        count += bb->instrs.size();
+    return count;
+}
+
+map<string, int32_t> CFG::compute_constant_values() const
+{
+    map<string, int32_t> constants;
+    for (BasicBlock *bb : bbs)
+    {
+        for (IRInstr *instr : bb->instrs)
+        {
+            if (instr->get_op() == IRInstr::ldconst && IRInstr::is_constant(instr->get_params()[1]))
+                constants[instr->get_dest()] = IRInstr::constant_value(instr->get_params()[1]);
+        }
+    }
+    return constants;
+}
+
+map<size_t, IRInstr *> CFG::compute_parameter_reads() const
+{
+    map<size_t, IRInstr *> reads;
+    if (bbs.empty())
+        return reads;
+    for (IRInstr *instr : get_entry()->instrs)
+    {
+        if (instr->get_op() != IRInstr::copy || !IRInstr::is_register(instr->get_params()[1]))
+            break;
+        int arg = IRInstr::argument_index(instr->get_params()[1]);
+        if (arg >= 0)
+            reads[arg] = instr;
+    }
+    return reads;
+}
+
+bool CFG::get_constant_slot(const string &var, int32_t &value) const
+{
+    auto it = constantSlots.find(var);
+    if (it == constantSlots.end())
+        return false;
+    value = it->second;
+    return true;
+}
+
+// Nom de la fonction (porté par le DefFonction)
+string CFG::get_name() const
+{
+    return ast ? ast->getName() : "";
+}
+
+// Label de l'épilogue : unique dans le programme car préfixé par le nom de la fonction
+string CFG::get_epilogue_label() const
+{
+    return get_name() + "_epilogue";
+}
+
+// Parcours en profondeur post-ordre (itératif pour supporter de très grands CFG)
+// Les successeurs sont visités dans l'ordre exit_true puis exit_false
+vector<BasicBlock *> CFG::compute_rpo() const
+{
+    vector<BasicBlock *> postOrder;
+    BasicBlock *entry = get_entry();
+    if (!entry)
+        return postOrder;
+
+    std::set<BasicBlock *> visited;
+    vector<std::pair<BasicBlock *, int>> stack;
+    visited.insert(entry);
+    stack.push_back({entry, 0});
+    while (!stack.empty())
+    {
+        BasicBlock *bb = stack.back().first;
+        int next = stack.back().second++;
+        BasicBlock *succ = nullptr;
+        if (next == 0)
+            succ = bb->exit_true;
+        else if (next == 1)
+            succ = bb->exit_false;
+        else
+        {
+            postOrder.push_back(bb);
+            stack.pop_back();
+            continue;
+        }
+        if (succ && !visited.count(succ))
+        {
+            visited.insert(succ);
+            stack.push_back({succ, 0});
+        }
+    }
+    std::reverse(postOrder.begin(), postOrder.end());
+    return postOrder;
+}
+
+// Prédécesseurs des blocs atteignables (un prédécesseur apparaît une fois par arc)
+map<BasicBlock *, vector<BasicBlock *>> CFG::compute_predecessors() const
+{
+    map<BasicBlock *, vector<BasicBlock *>> preds;
+    for (BasicBlock *bb : compute_rpo())
+    {
+        preds[bb];
+        for (BasicBlock *succ : bb->get_successors())
+        {
+            preds[succ].push_back(bb);
+        }
+    }
+    return preds;
+}
+
+// Affiche le CFG : signature, table des symboles, puis tous les blocs (l'entrée en premier)
+void CFG::print(ostream &o) const
+{
+    o << "function " << get_name() << "(";
+    if (ast)
+    {
+        const vector<Param> &params = ast->getParams();
+        for (size_t i = 0; i < params.size(); i++)
+        {
+            o << (i ? ", " : "") << params[i].name;
+        }
+    }
+    o << ")";
+    if (ast && ast->getInlineHint() != INLINE_DEFAULT)
+        o << " " << inlineHintName(ast->getInlineHint());
+    o << endl;
+
+    // Symboles triés par index
+    vector<std::pair<int, string>> symbols;
+    for (const auto &pair : SymbolIndex)
+    {
+        symbols.push_back({pair.second, pair.first});
+    }
+    std::sort(symbols.begin(), symbols.end());
+    for (const auto &sym : symbols)
+    {
+        auto it = SymbolType.find(sym.second);
+        o << "  symbol " << sym.second << " " << (it != SymbolType.end() ? it->second : Type()) << " !" << sym.first << endl;
+    }
+
+    for (BasicBlock *bb : bbs)
+    {
+        bb->print(o);
+    }
+    o << "end" << endl;
+}
+
+// Génère le code assembleur d'une fonction complète
+void CFG::gen_asm(ostream &o)
+{
+    string funcName = get_name();
+
+// Déclarer la fonction comme globale
+#ifdef __APPLE__
+    // Pour macOS, main doit s'appeler _main
+    if (funcName == "main")
+    {
+        o << "\t.globl\t_main\n";
+        o << "_main:\n";
+    }
+    else
+    {
+        o << "\t.globl\t" << funcName << "\n";
+        o << funcName << ":\n";
+    }
+#else
+    // Pour Linux, main reste main
+    o << "\t.globl\t" << funcName << "\n";
+    o << funcName << ":\n";
+#endif
+
+    // Cases qui ne reçoivent qu'une constante : la sélection d'instructions peut s'en servir
+    // (multiplication par décalages, division par multiplication)
+    map<string, int> definitions;
+    constantSlots.clear();
+    for (BasicBlock *bb : bbs)
+    {
+        for (IRInstr *instr : bb->instrs)
+        {
+            string dest = instr->get_dest();
+            if (!IRInstr::is_symbol(dest))
+                continue;
+            definitions[dest]++;
+            if (instr->get_op() == IRInstr::ldconst)
+                constantSlots[dest] = IRInstr::constant_value(instr->get_params()[1]);
+        }
+    }
+    for (const auto &def : definitions)
+    {
+        if (def.second > 1)
+            constantSlots.erase(def.first);
+    }
+
+    // Lectures de chaque variable : une comparaison lue une seule fois, par le branchement ou le select
+    // qui la suit, y est fusionnée
+    useCounts.clear();
+    for (BasicBlock *bb : bbs)
+    {
+        for (IRInstr *instr : bb->instrs)
+        {
+            for (size_t i : instr->get_use_indices())
+                useCounts[instr->get_params()[i]]++;
+        }
+        if (bb->exit_false)
+            useCounts[bb->test_var_name]++;
+    }
+
+    // Générer le prologue de la fonction (sauvegarde des registres, allocation de la pile)
+    gen_asm_prologue(o);
+
+    // Générer le code de tous les blocs de base dans l'ordre de bbs (rangé par la passe layout : chemins
+    // probables sans saut, blocs froids à part)
+    // Un bloc inatteignable (orphelin) n'a pas sa place ici : VisitorIR et la passe dce les retirent
+    size_t reachable = compute_rpo().size();
+    if (reachable != bbs.size())
+        throw std::runtime_error("assembleur de '" + funcName + "' : " + std::to_string(bbs.size() - reachable) +
+                                 " bloc(s) inatteignable(s) depuis l'entrée (utiliser la passe dce)");
+    vector<BasicBlock *> order, cold;
+    for (BasicBlock *bb : bbs)
+        (bb->cold && bb != get_entry() ? cold : order).push_back(bb);
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        order[i]->gen_asm(o, i + 1 < order.size() ? order[i + 1] : nullptr, i + 1 == order.size());
+    }
+
+    // Générer l'épilogue de la fonction (restaure la pile, retourne)
+    o << get_epilogue_label() << ":" << endl;
+    gen_asm_epilogue(o);
+
+    // Ajouter les directives de taille pour la fonction
+#if defined(ARM)
+    // Do NOT emit .size for ARM/clang
+#elif !defined(__APPLE__)
+    o << "\t.size\t" << funcName << ", .-" << funcName << "\n";
+#endif
+
+    // Blocs froids (chemins d'erreur, branches annoncées improbables) : hors du code chaud, dans la
+    // section .text.unlikely que l'éditeur de liens regroupe à l'écart
+    if (cold.empty())
+        return;
+#ifndef __APPLE__
+    o << "\t.section\t.text.unlikely,\"ax\",@progbits\n";
+#endif
+    o << funcName << ".cold:\n";
+    for (size_t i = 0; i < cold.size(); i++)
+    {
+        cold[i]->gen_asm(o, i + 1 < cold.size() ? cold[i + 1] : nullptr);
+    }
+#ifndef __APPLE__
+#ifndef ARM
+    o << "\t.size\t" << funcName << ".cold, .-" << funcName << ".cold\n";
+#endif
+    o << "\t.text\n";
+#endif
+}
+
+// Génère le code assembleur de tout le programme
+void gen_asm_module(ostream &o, const Module &module)
+{
+    // Générer le prologue global (section .text)
+    o << "\t.text\n";
+
+    for (const auto &pair : module)
+    {
+        pair.second->gen_asm(o);
+    }
+
+#ifndef __APPLE__
+    o << "\t.section\t.note.GNU-stack,\"\",@progbits\n";
+#endif
 }
 
 // Génère l'épilogue assembleur de la fonction (restaure la pile, retourne)
 void CFG::gen_asm_epilogue(std::ostream &o)
+{
+    gen_asm_frame_release(o);
+#ifdef ARM
+    o << "\tret\n";
+#else
+    o << "\tret" << endl;
+#endif
+}
+
+// Libère le cadre de pile ; partagé par l'épilogue et les appels terminaux
+void CFG::gen_asm_frame_release(std::ostream &o)
 {
 #ifdef ARM
     int totalSize = 16 + (nextFreeSymbolIndex * 8);
     totalSize = ((totalSize + 15) & ~15);
     o << "\tldp x29, x30, [sp], #" << totalSize << "\n";
-    o << "\tret\n";
 #else
     o << "\tleave" << endl;
-    o << "\tret" << endl;
 #endif
 }
 
@@ -601,6 +1956,51 @@ string CFG::create_new_tempvar(Type t)
     return name;
 }
 
+// Renumérote les emplacements de la pile (après coalesce) ; une variable du programme garde son nom
+// de préférence à un temporaire qui partage son emplacement
+void CFG::renumber_symbols(const vector<int> &slot)
+{
+    auto rename = [&](string &operand)
+    {
+        if (IRInstr::is_symbol(operand))
+            operand = "!" + to_string(slot[stoi(operand.substr(1))]);
+    };
+    for (BasicBlock *bb : bbs)
+    {
+        for (IRInstr *instr : bb->instrs)
+        {
+            for (string &operand : instr->get_params())
+                rename(operand);
+        }
+        if (bb->exit_false)
+            rename(bb->test_var_name);
+    }
+
+    map<int, string> names;
+    for (const auto &pair : SymbolIndex)
+    {
+        int index = slot[pair.second];
+        if (index < 0)
+            continue;
+        auto it = names.find(index);
+        if (it == names.end() || (it->second[0] == '!' && pair.first[0] != '!'))
+            names[index] = pair.first;
+    }
+    map<string, Type> types;
+    SymbolIndex.clear();
+    nextFreeSymbolIndex = 0;
+    for (int index : slot)
+        nextFreeSymbolIndex = std::max(nextFreeSymbolIndex, index + 1);
+    for (int index = 0; index < nextFreeSymbolIndex; index++)
+    {
+        auto it = names.find(index);
+        string name = it != names.end() && it->second[0] != '!' ? it->second : "!" + to_string(index);
+        types[name] = it != names.end() ? SymbolType[it->second] : Type::INT_TYPE;
+        SymbolIndex[name] = index;
+    }
+    SymbolType = types;
+}
+
 // Récupère l'index d'une variable
 int CFG::get_var_index(string name)
 {
@@ -614,9 +2014,15 @@ Type CFG::get_var_type(string name)
 }
 
 // Génère un nom unique pour un BasicBlock
+// Préfixé par le nom de la fonction pour ne pas entrer en collision avec les labels créés par VisitorIR
 string CFG::new_BB_name()
 {
-    return "BB_" + to_string(nextBBnumber++);
+    string name;
+    do
+    {
+        name = get_name() + "_L" + to_string(nextBBnumber++);
+    } while (labels.count(name));
+    return name;
 }
 
 // Génère le prologue assembleur de la fonction (sauvegarde des registres, allocation de la pile)
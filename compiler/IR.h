@@ -1,10 +1,12 @@
 #ifndef IR_H
 #define IR_H
 
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <iostream>
 #include <map>
+#include <set>
 #include <initializer_list>
 
 // Déclaration des namespaces
@@ -51,7 +53,11 @@ public:
         bit_or,       // OU binaire
         logical_and,  // ET logique paresseux (&&)
         logical_or,   // OU logique paresseux (||)
-        ret           // Retour de fonction
+        ret,          // Retour de fonction
+        phi,          // Fusion SSA en tête de bloc : phi dest, val0, label0, val1, label1...
+        copy,         // Copie : copy dest, src (src : variable, registre physique ou constante)
+        select,       // Sélection sans branchement : select dest, cond, a, b (dest = cond ? a : b)
+        abs_op        // Valeur absolue : abs dest, x (abs(INT_MIN) = INT_MIN, comme le C sur 32 bits)
     };
 
     /** Constructeur (voir les paramètres dans les attributs) */
@@ -62,15 +68,66 @@ public:
     /** Génération du code assembleur ARM pour cette instruction IR */
     void gen_asm_arm(ostream &o);
 
-protected:
+    // Accesseurs (utilisés par les passes d'optimisation du middle-end)
+    Operation get_op() const { return op; }
+    void set_op(Operation o) { op = o; }
+    Type get_type() const { return t; }
+    BasicBlock *get_bb() const { return bb; }
+    void set_bb(BasicBlock *b) { bb = b; }
+    const vector<string> &get_params() const { return params; }
+    vector<string> &get_params() { return params; }
+    /** Appel marqué comme terminal par la passe tailrec (voir BasicBlock::get_tail_call) */
+    bool is_tail_call() const { return tailCall; }
+    void set_tail_call(bool tail) { tailCall = tail; }
+
+    /** Variable écrite par l'instruction ("" si aucune) */
+    string get_dest() const;
+    /** Positions dans params des opérandes lus par l'instruction */
+    vector<size_t> get_use_indices() const;
+    /** Vrai si l'instruction ne peut pas être supprimée même si son résultat est inutilisé */
+    bool has_side_effects() const;
+
+    /** Valeur reçue par ce phi depuis le bloc label ("" si aucune) */
+    string get_phi_value(const string &label) const;
+
+    /** Affichage textuel de l'instruction (ex : "add !3, !1, !2") */
+    void print(ostream &o) const;
+    /** Nom textuel d'une opération (ex : "add") */
+    static string op_name(Operation op);
+    /** Opération correspondant à un nom textuel ; retourne faux si le nom est inconnu */
+    static bool op_from_name(const string &name, Operation &op);
+
+    // Classification des opérandes IR
+    static bool is_symbol(const string &s);   // variable ou temporaire "!N"
+    static bool is_constant(const string &s); // constante entière littérale ("42", "-1")
+    static bool is_register(const string &s); // registre physique ("%edi", "w0")
+    static int argument_index(const string &s); // rang du paramètre reçu dans ce registre, -1 sinon
+
+    // Classification des opérations
+    static bool is_comparison(Operation op);  // cmp_eq ... cmp_ge
+    static bool is_commutative(Operation op); // a op b == b op a
+
+    /** Valeur sur 32 bits d'une constante littérale (bits de poids fort ignorés, comme l'assembleur) */
+    static int32_t constant_value(const string &s);
+    /** Repliement de constantes : result = a op b (not_op et abs_op n'utilisent que a), avec la sémantique C sur 32 bits
+        (débordement modulo 2^32, / et % tronqués vers zéro, comparaisons et opérateurs logiques à 0 ou 1).
+        Retourne faux si op n'est pas repliable, ou pour une division par zéro ou INT_MIN / -1,
+        qui doivent rester des erreurs à l'exécution */
+    static bool fold(Operation op, int32_t a, int32_t b, int32_t &result);
+    /** Division signée par la constante d (hors -1, 0, 1) sans idiv (Hacker's Delight, chap. 10) :
+        q = hi32(multiplier * n), plus n si d > 0 et multiplier < 0, moins n si d < 0 et multiplier > 0,
+        décalé arithmétiquement de shift, plus 1 si q est négatif */
+    static void signed_magic(int32_t d, int32_t &multiplier, int &shift);
+
     // Convertit un registre IR ou une variable en format assembleur
-    string IR_reg_to_asm(string reg);
+    static string IR_reg_to_asm(string reg);
 
 private:
     BasicBlock *bb; // BasicBlock auquel appartient cette instruction
     Operation op;   // Opération IR
     Type t;         // Type de l'opération
     vector<string> params; // Paramètres de l'instruction (voir commentaires)
+    bool tailCall = false; // call émis comme un saut (affiché "tail call")
 };
 
 /**  The class for a basic block */
@@ -83,21 +140,21 @@ private:
      Assembly jumps are generated as follows:
      BasicBlock::gen_asm() first calls IRInstr::gen_asm() on all its instructions, and then
             if  exit_true  is a  nullptr,
-            the epilogue is generated
+            a jump to the epilogue of the function is generated
         else if exit_false is a nullptr,
           an unconditional jmp to the exit_true branch is generated
                 else (we have two successors, hence a branch.
-                      But then we know the last code generated in this BB was the code for the test
-                            and its boolean result is in !reg)
-          an instruction comparing the value of !reg to true is generated,
+                      The boolean result of the test is in the variable test_var_name)
+          an instruction comparing the value of test_var_name to true is generated,
                     followed by a conditional branch to the exit_false branch,
                     followed by an unconditional branch to the exit_true branch
 
-Possible optimization:
-     Add a cmp_* comparison instructions.
-           If it is the last instruction of its block,
-       it generates an actual assembly comparison
-       followed by a conditional jump to the exit_false branch
+Comparaison fusionnée avec le branchement :
+     si la dernière instruction du bloc est un cmp_* qui calcule test_var_name, et que ce résultat
+     n'est lu nulle part ailleurs, aucun booléen n'est calculé : une seule comparaison est émise,
+     suivie du saut conditionnel (jcc en x86, b.cond en ARM). Sinon la valeur du test est comparée
+     à 0 (cmpl $0 en x86, cbz/cbnz en ARM). Le sens du saut est inversé quand l'une des deux
+     branches est le bloc émis juste après, qui est alors atteint sans saut.
 
 */
 
@@ -105,8 +162,18 @@ class BasicBlock
 {
 public:
     BasicBlock(CFG *cfg, string entry_label);
-
-    void gen_asm(ostream &o); /**< x86 assembly code generation for this basic block (very simple) */
+    ~BasicBlock();
+
+    /** assembly code generation for this basic block ; next : bloc émis juste après (nullptr si aucun),
+        epilogueNext : l'épilogue suit immédiatement le bloc */
+    void gen_asm(ostream &o, BasicBlock *next = nullptr, bool epilogueNext = false);
+    /** Instruction cmp_* fusionnée avec le branchement de fin de bloc (nullptr si aucune) */
+    IRInstr *get_fused_compare() const;
+    /** Instruction cmp_* fusionnée avec le select qui la suit immédiatement (nullptr si aucune) */
+    IRInstr *get_select_compare(const IRInstr *select) const;
+    /** Appel terminal "tail call f, d, args" suivi de "ret d" en fin de bloc, émis comme un saut vers f
+        après la libération du cadre (nullptr si aucun ; un call non marqué par tailrec reste un call) */
+    IRInstr *get_tail_call() const;
 
     void add_IRInstr(IRInstr::Operation op, Type t, vector<string> params);
 
@@ -116,11 +183,21 @@ public:
     string label;             /**< label of the BB, also will be the label in the generated code */
     CFG *cfg;                 /** < the CFG where this block belongs */
     vector<IRInstr *> instrs; /** < the instructions themselves. */
+    string test_var_name;     /** < when the block ends with a branch, the variable holding the value of the test */
+    int expected_branch;      /** < branche annoncée par __builtin_expect : 1 exit_true, 0 exit_false, -1 aucune */
+    bool cold;                /** < bloc froid, émis à part dans .text.unlikely (marqué par la passe layout) */
 
     // Méthodes pour accéder aux instructions
     const vector<IRInstr *> &get_instrs() const { return instrs; }
     const string &get_name() const { return label; }
 
+    /** Successeurs du bloc (exit_true puis exit_false, sans les nullptr) */
+    vector<BasicBlock *> get_successors() const;
+    /** Dans les phi du bloc, les valeurs venant du bloc from viennent désormais du bloc to */
+    void rename_phi_label(const string &from, const string &to);
+    /** Affichage textuel du bloc (label, instructions, branchement) */
+    void print(ostream &o) const;
+
 protected:
     string name;
 };
@@ -140,20 +217,68 @@ public:
     /* All this was obviously written in a time when we had an explicit AST data structure:
          to be adapted to ANTLR */
     CFG(DefFonction *ast);
+    ~CFG();
 
     DefFonction *ast; /**< The AST this CFG comes from */
 
     void add_bb(BasicBlock *bb);
-
-
+    /** Retire un bloc du CFG et le libère (les arcs vers ce bloc doivent déjà avoir été supprimés) */
+    void remove_bb(BasicBlock *bb);
+    /** Retire les blocs inatteignables depuis l'entrée ; retourne le nombre de blocs retirés */
+    int remove_unreachable_bbs();
+    /** Retire des phi les valeurs venant de blocs qui ne sont plus des prédécesseurs */
+    void prune_phis();
+    /** Copie dans ce CFG les blocs de source, dans le même ordre, sous de nouveaux labels (arcs, labels des
+        phi et consignes __builtin_expect suivent les copies). Un opérande présent dans renamed est remplacé,
+        une autre variable reçoit un nouveau temporaire (ajouté à renamed) ; retourne original -> copie */
+    map<BasicBlock *, BasicBlock *> clone_blocks(const CFG &source, map<string, string> &renamed);
+
+    /** Génère le code assembleur complet de la fonction (label, prologue, blocs, épilogue) */
+    void gen_asm(ostream &o);
     void gen_asm_prologue(ostream &o);
     void gen_asm_epilogue(ostream &o);
+    /** Libère le cadre de pile et restaure le pointeur de cadre (et l'adresse de retour sur ARM) */
+    void gen_asm_frame_release(ostream &o);
+    /** Label placé devant l'épilogue, cible des blocs qui terminent la fonction */
+    string get_epilogue_label() const;
+
+    /** Nom de la fonction dont ce CFG est issu */
+    string get_name() const;
+    /** Bloc d'entrée de la fonction (le premier bloc créé) */
+    BasicBlock *get_entry() const { return bbs.empty() ? nullptr : bbs[0]; }
+    /** Blocs atteignables depuis l'entrée, en reverse post-order */
+    vector<BasicBlock *> compute_rpo() const;
+    /** Prédécesseurs de chaque bloc atteignable */
+    map<BasicBlock *, vector<BasicBlock *>> compute_predecessors() const;
+    /** Vrai si l'IR est en forme SSA : aucun rmem/wmem et chaque variable définie au plus une fois */
+    bool is_ssa() const;
+    /** Vrai si la case var ne contient jamais qu'une constante (temporaire défini par un unique ldconst) ;
+        connu pendant gen_asm, pour la réduction de force des multiplications et divisions */
+    bool get_constant_slot(const string &var, int32_t &value) const;
+    /** Nombre de lectures de var, branchements compris (connu pendant gen_asm) : une comparaison lue
+        une seule fois peut être fusionnée avec le branchement ou le select qui la lit */
+    int get_use_count(const string &var) const;
+    /** Nombre de lectures de var dans l'IR courant, branchements compris (recompté à chaque appel, pour les passes) */
+    int count_uses(const string &var) const;
+    /** Nombre d'instructions de la fonction (taille utilisée par les modèles de coût de inline et ipcp) */
+    int count_instructions() const;
+    /** Temporaires chargés par ldconst, avec leur valeur */
+    map<string, int32_t> compute_constant_values() const;
+    /** Lectures des registres de paramètres ("copy p, %edi"...) en tête du bloc d'entrée, par rang d'argument */
+    map<size_t, IRInstr *> compute_parameter_reads() const;
+
+    /** Affichage textuel du CFG complet */
+    void print(ostream &o) const;
 
     // symbol table methods
     void add_to_symbol_table(string name, Type t);
     string create_new_tempvar(Type t);
     int get_var_index(string name);
     Type get_var_type(string name);
+    /** Renumérote les emplacements : !i devient !slot[i] dans toutes les instructions (slot[i] < 0 : !i
+        n'est plus utilisé ; slot couvre tous les opérandes, même hors de la table des symboles) ;
+        la table des symboles ne garde qu'un nom par emplacement */
+    void renumber_symbols(const vector<int> &slot);
 
     // basic block management
     string new_BB_name();
@@ -161,17 +286,30 @@ public:
 
     // Ajouter cette méthode pour accéder aux blocs de base
     const vector<BasicBlock *> &get_bbs() const { return bbs; }
+    vector<BasicBlock *> &get_bbs() { return bbs; }
 
     // Add this method to access the symbol count
     int get_symbol_count() const { return nextFreeSymbolIndex; }
+    // Accès en lecture à la table des symboles (nom -> index, nom -> type)
+    const map<string, int> &get_symbol_indices() const { return SymbolIndex; }
+    const map<string, Type> &get_symbol_types() const { return SymbolType; }
 
 protected:
     map<string, Type> SymbolType; /**< part of the symbol table  */
     map<string, int> SymbolIndex; /**< part of the symbol table  */
     int nextFreeSymbolIndex;      /**< to allocate new symbols in the symbol table */
     int nextBBnumber;             /**< just for naming */
+    std::set<string> labels;      /**< labels already used by the blocks of this CFG */
 
     vector<BasicBlock *> bbs; /**< all the basic blocks of this CFG*/
+    map<string, int32_t> constantSlots; /**< cases constantes, calculées par gen_asm */
+    map<string, int> useCounts;         /**< nombre de lectures de chaque variable, calculé par gen_asm */
 };
 
+/** Un module : l'ensemble des CFG du programme (clé = nom de fonction) */
+typedef map<string, CFG *> Module;
+
+/** Génère le code assembleur de tout le programme (section .text, puis chaque fonction) */
+void gen_asm_module(ostream &o, const Module &module);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,729 @@
+// IRSERIALIZER.CPP : Lecture et écriture de l'IR aux formats textuel et binaire
+
+#include "IRSerializer.h"
+#include "DefFonction.h"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+using std::endl;
+
+// En-tête du format binaire ; la version change si la structure du fichier change
+static const string binaryMagic = "IFCCIRB";
+static const unsigned char binaryVersion = 4;
+
+// Symboles d'un CFG triés par index (l'ordre dans lequel ils doivent être recréés)
+static vector<std::pair<int, string>> sorted_symbols(const CFG &cfg)
+{
+    vector<std::pair<int, string>> symbols;
+    for (const auto &pair : cfg.get_symbol_indices())
+    {
+        symbols.push_back({pair.second, pair.first});
+    }
+    std::sort(symbols.begin(), symbols.end());
+    return symbols;
+}
+
+// Un opérande "!N" doit désigner un emplacement de la table des symboles : les passes et la génération
+// de code indexent leurs tableaux par N
+static bool is_declared(const CFG &cfg, const string &operand)
+{
+    return !IRInstr::is_symbol(operand) ||
+           (operand.size() <= 10 && std::stoi(operand.substr(1)) < cfg.get_symbol_count());
+}
+
+// Type à partir de son nom textuel
+static bool type_from_name(const string &name, Type &t)
+{
+    if (name == "int")
+    {
+        t = Type(INT);
+        return true;
+    }
+    return false;
+}
+
+// Opération à partir de son nom textuel, éventuellement précédé de "tail " (appel terminal)
+static bool read_op_name(const string &name, IRInstr::Operation &op, bool &tail)
+{
+    tail = name.rfind("tail ", 0) == 0;
+    if (!IRInstr::op_from_name(tail ? name.substr(5) : name, op))
+        return false;
+    return !tail || op == IRInstr::call;
+}
+
+// Vrai si l'instruction a le bon nombre d'opérandes (la génération de code y accède sans vérification)
+static bool valid_param_count(IRInstr::Operation op, size_t count)
+{
+    switch (op)
+    {
+    case IRInstr::call:
+        return count >= 2;
+    case IRInstr::ret:
+        return count == 1;
+    case IRInstr::phi:
+        return count >= 1 && count % 2 == 1;
+    case IRInstr::ldconst:
+    case IRInstr::rmem:
+    case IRInstr::wmem:
+    case IRInstr::not_op:
+    case IRInstr::abs_op:
+    case IRInstr::copy:
+        return count == 2;
+    case IRInstr::select:
+        return count == 4;
+    default:
+        return count == 3;
+    }
+}
+
+// Ajoute une fonction lue au module (un nom ne peut être défini qu'une fois)
+static void add_function(Module &module, CFG *cfg)
+{
+    string name = cfg->get_name();
+    if (module.count(name))
+    {
+        delete cfg;
+        throw std::runtime_error("fonction '" + name + "' définie plusieurs fois");
+    }
+    module[name] = cfg;
+}
+
+// ---------------------------------------------------------------------------
+// Format textuel
+// ---------------------------------------------------------------------------
+
+void write_module_text(ostream &o, const Module &module)
+{
+    for (const auto &pair : module)
+    {
+        pair.second->print(o);
+    }
+}
+
+namespace
+{
+
+// Lecteur du format textuel, ligne par ligne
+class TextReader
+{
+public:
+    TextReader(std::istream &in, Module &module) : in(in), module(module) {}
+
+    void read()
+    {
+        string line;
+        while (next_line(line))
+        {
+            if (line.rfind("function ", 0) != 0)
+                fail("'function' attendu");
+            read_function(line);
+        }
+    }
+
+private:
+    std::istream &in;
+    Module &module;
+    int lineNumber = 0;
+
+    void fail(const string &msg)
+    {
+        throw std::runtime_error("IR textuel, ligne " + std::to_string(lineNumber) + " : " + msg);
+    }
+
+    static string trim(const string &s)
+    {
+        size_t begin = s.find_first_not_of(" \t\r");
+        if (begin == string::npos)
+            return "";
+        size_t end = s.find_last_not_of(" \t\r");
+        return s.substr(begin, end - begin + 1);
+    }
+
+    // Découpe "a, b, c" en {"a", "b", "c"}
+    static vector<string> split_list(const string &s)
+    {
+        vector<string> items;
+        if (trim(s).empty())
+            return items;
+        std::stringstream ss(s);
+        string item;
+        while (std::getline(ss, item, ','))
+        {
+            items.push_back(trim(item));
+        }
+        return items;
+    }
+
+    // Ligne suivante non vide et hors commentaire
+    bool next_line(string &line)
+    {
+        while (std::getline(in, line))
+        {
+            lineNumber++;
+            line = trim(line);
+            if (!line.empty() && line[0] != ';')
+                return true;
+        }
+        return false;
+    }
+
+    void read_function(const string &header)
+    {
+        size_t open = header.find('(');
+        size_t close = header.rfind(')');
+        if (open == string::npos || close == string::npos || close < open)
+            fail("signature de fonction mal formée");
+        string name = trim(header.substr(9, open - 9));
+        if (name.empty())
+            fail("nom de fonction manquant");
+
+        vector<Param> params;
+        for (const string &p : split_list(header.substr(open + 1, close - open - 1)))
+        {
+            params.push_back(Param(p, Type(INT)));
+        }
+        InlineHint hint = read_inline_hint(trim(header.substr(close + 1)));
+
+        CFG *cfg = new CFG(new DefFonction(name, Type(INT), params));
+        cfg->ast->setInlineHint(hint);
+        try
+        {
+            read_body(*cfg);
+        }
+        catch (...)
+        {
+            delete cfg;
+            throw;
+        }
+        add_function(module, cfg);
+    }
+
+    // Consigne d'intégration écrite après la signature (rien, inline, always_inline ou noinline)
+    InlineHint read_inline_hint(const string &word)
+    {
+        for (InlineHint hint : {INLINE_DEFAULT, INLINE_HINT, INLINE_ALWAYS, INLINE_NEVER})
+        {
+            if (word == inlineHintName(hint))
+                return hint;
+        }
+        fail("consigne d'intégration inconnue '" + word + "'");
+        return INLINE_DEFAULT;
+    }
+
+    // Arcs lus avant que tous les blocs soient connus : résolus à la fin de la fonction
+    struct PendingEdges
+    {
+        BasicBlock *bb;
+        string exitTrue;
+        string exitFalse;
+    };
+
+    void read_body(CFG &cfg)
+    {
+        map<string, BasicBlock *> blocks;
+        vector<PendingEdges> edges;
+        BasicBlock *current = nullptr;
+        bool terminated = false;
+        string line;
+
+        while (next_line(line))
+        {
+            if (line == "end")
+            {
+                if (current && !terminated)
+                    fail("le bloc " + current->label + " n'a pas de branchement de sortie");
+                if (cfg.get_bbs().empty())
+                    fail("la fonction " + cfg.get_name() + " n'a aucun bloc");
+                resolve_edges(blocks, edges);
+                return;
+            }
+
+            if (line.rfind("symbol ", 0) == 0)
+            {
+                if (current)
+                    fail("déclaration de symbole après le premier bloc");
+                read_symbol(cfg, line);
+            }
+            else if (line.rfind("bb ", 0) == 0)
+            {
+                if (current && !terminated)
+                    fail("le bloc " + current->label + " n'a pas de branchement de sortie");
+                // "bb L: cold" : bloc froid placé par la passe layout
+                bool cold = line.size() > 5 && line.compare(line.size() - 5, 5, " cold") == 0;
+                if (cold)
+                    line = trim(line.substr(0, line.size() - 5));
+                if (line.back() != ':')
+                    fail("':' attendu après le label du bloc");
+                string label = trim(line.substr(3, line.size() - 4));
+                if (label.empty() || blocks.count(label))
+                    fail("label de bloc vide ou déjà utilisé : " + label);
+                current = new BasicBlock(&cfg, label);
+                current->cold = cold;
+                blocks[label] = current;
+                terminated = false;
+            }
+            else
+            {
+                if (!current)
+                    fail("instruction hors d'un bloc");
+                if (terminated)
+                    fail("instruction après le branchement de sortie du bloc " + current->label);
+                terminated = read_instruction(cfg, current, line, edges);
+            }
+        }
+        fail("'end' attendu à la fin de la fonction " + cfg.get_name());
+    }
+
+    // "symbol <nom> <type> !<index>" ; les symboles doivent apparaître dans l'ordre des index
+    void read_symbol(CFG &cfg, const string &line)
+    {
+        std::istringstream ss(line.substr(7));
+        string name, typeName, index;
+        if (!(ss >> name >> typeName >> index))
+            fail("déclaration de symbole mal formée");
+        Type t;
+        if (!type_from_name(typeName, t))
+            fail("type inconnu : " + typeName);
+        if (!IRInstr::is_symbol(index) || index.size() > 9 || std::stoi(index.substr(1)) < cfg.get_symbol_count())
+            fail("index de symbole inattendu " + index + " (attendu au moins !" + std::to_string(cfg.get_symbol_count()) + ")");
+        // Un index sans nom correspond à une variable masquée par une redéclaration : on recrée son emplacement
+        while (cfg.get_symbol_count() < std::stoi(index.substr(1)))
+            cfg.create_new_tempvar(Type(INT));
+        if (cfg.get_symbol_indices().count(name))
+            fail("symbole déclaré plusieurs fois : " + name);
+        cfg.add_to_symbol_table(name, t);
+    }
+
+    // Lit une instruction ou un branchement de sortie ; retourne vrai pour un branchement
+    bool read_instruction(CFG &cfg, BasicBlock *bb, const string &line, vector<PendingEdges> &edges)
+    {
+        size_t space = line.find(' ');
+        if (line.rfind("tail ", 0) == 0)
+            space = line.find(' ', space + 1);
+        string opName = line.substr(0, space);
+        vector<string> params = space == string::npos ? vector<string>() : split_list(line.substr(space + 1));
+
+        if (opName == "exit")
+        {
+            if (!params.empty())
+                fail("'exit' n'a pas d'opérande");
+            return true;
+        }
+        if (opName == "jmp")
+        {
+            if (params.size() != 1)
+                fail("'jmp' attend un label");
+            edges.push_back({bb, params[0], ""});
+            return true;
+        }
+        if (opName == "br")
+        {
+            if (params.size() == 4 && (params[3] == "likely" || params[3] == "unlikely"))
+                bb->expected_branch = params[3] == "likely";
+            else if (params.size() != 3)
+                fail("'br' attend une variable de test et deux labels");
+            if (!is_declared(cfg, params[0]))
+                fail("variable non déclarée " + params[0]);
+            bb->test_var_name = params[0];
+            edges.push_back({bb, params[1], params[2]});
+            return true;
+        }
+
+        IRInstr::Operation op;
+        bool tail;
+        if (!read_op_name(opName, op, tail))
+            fail("opération inconnue : " + opName);
+        if (!valid_param_count(op, params.size()))
+            fail("mauvais nombre d'opérandes pour " + opName);
+        for (const string &p : params)
+        {
+            if (p.empty())
+                fail("opérande vide");
+            if (!is_declared(cfg, p))
+                fail("variable non déclarée " + p);
+        }
+        bb->add_IRInstr(op, Type(INT), params);
+        bb->instrs.back()->set_tail_call(tail);
+        return false;
+    }
+
+    void resolve_edges(const map<string, BasicBlock *> &blocks, const vector<PendingEdges> &edges)
+    {
+        for (const PendingEdges &e : edges)
+        {
+            e.bb->exit_true = find_block(blocks, e.exitTrue);
+            if (!e.exitFalse.empty())
+                e.bb->exit_false = find_block(blocks, e.exitFalse);
+        }
+    }
+
+    BasicBlock *find_block(const map<string, BasicBlock *> &blocks, const string &label)
+    {
+        auto it = blocks.find(label);
+        if (it == blocks.end())
+            fail("bloc inconnu : " + label);
+        return it->second;
+    }
+};
+
+} // namespace
+
+void read_module_text(std::istream &in, Module &module)
+{
+    TextReader reader(in, module);
+    reader.read();
+}
+
+// ---------------------------------------------------------------------------
+// Format binaire
+// ---------------------------------------------------------------------------
+// Structure :
+//   "IFCCIRB" version
+//   nbChaînes { longueur octets }*
+//   nbFonctions {
+//     nom nbParams { nom }* consigne                 (consigne d'intégration : 0 aucune, 1 inline, 2 always_inline, 3 noinline)
+//     nbSymboles { nom type }*                       (dans l'ordre des index)
+//     nbBlocs { label nbInstrs { op nbParams { param }* }* sortieVrai sortieFaux varTest attendu froid }*
+//   }*
+// Les chaînes (noms, labels, opérandes, opérations) sont des index dans la table de chaînes.
+// sortieVrai/sortieFaux valent 0 (pas de successeur) ou 1 + index du bloc ; varTest vaut 0 ou 1 + index de chaîne ;
+// attendu vaut 1 + expected_branch (0 : aucune branche annoncée par __builtin_expect) ; froid vaut 1 pour un
+// bloc froid placé par la passe layout.
+
+namespace
+{
+
+void write_varint(string &out, unsigned long value)
+{
+    while (value >= 0x80)
+    {
+        out += (char)((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += (char)value;
+}
+
+// Écrit le corps du fichier en internant les chaînes au fil de l'eau
+class BinaryWriter
+{
+public:
+    void write_function(const CFG &cfg)
+    {
+        write_string(cfg.get_name());
+        const vector<Param> &params = cfg.ast->getParams();
+        write_varint(body, params.size());
+        for (const Param &p : params)
+        {
+            write_string(p.name);
+        }
+        write_varint(body, cfg.ast->getInlineHint());
+
+        // Un emplacement par index ; ceux qui n'ont plus de nom (variable masquée par une redéclaration)
+        // sont écrits comme des temporaires "!N"
+        const map<string, Type> &types = cfg.get_symbol_types();
+        vector<string> names(cfg.get_symbol_count());
+        for (const auto &sym : sorted_symbols(cfg))
+        {
+            names[sym.first] = sym.second;
+        }
+        write_varint(body, names.size());
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            if (names[i].empty())
+                names[i] = "!" + std::to_string(i);
+            write_string(names[i]);
+            auto it = types.find(names[i]);
+            write_varint(body, it != types.end() ? it->second.getTypeEnum() : INT);
+        }
+
+        const vector<BasicBlock *> &bbs = cfg.get_bbs();
+        map<BasicBlock *, size_t> blockIndex;
+        for (size_t i = 0; i < bbs.size(); i++)
+        {
+            blockIndex[bbs[i]] = i;
+        }
+
+        write_varint(body, bbs.size());
+        for (BasicBlock *bb : bbs)
+        {
+            write_string(bb->label);
+            write_varint(body, bb->instrs.size());
+            for (IRInstr *instr : bb->instrs)
+            {
+                write_string((instr->is_tail_call() ? "tail " : "") + IRInstr::op_name(instr->get_op()));
+                write_varint(body, instr->get_params().size());
+                for (const string &p : instr->get_params())
+                {
+                    write_string(p);
+                }
+            }
+            write_varint(body, bb->exit_true ? blockIndex.at(bb->exit_true) + 1 : 0);
+            write_varint(body, bb->exit_false ? blockIndex.at(bb->exit_false) + 1 : 0);
+            write_varint(body, bb->exit_false ? intern(bb->test_var_name) + 1 : 0);
+            write_varint(body, bb->exit_false ? bb->expected_branch + 1 : 0);
+            write_varint(body, bb->cold);
+        }
+    }
+
+    void finish(ostream &o, size_t functionCount)
+    {
+        string header = binaryMagic;
+        header += (char)binaryVersion;
+        write_varint(header, strings.size());
+        for (const string &s : strings)
+        {
+            write_varint(header, s.size());
+            header += s;
+        }
+        write_varint(header, functionCount);
+        o.write(header.data(), header.size());
+        o.write(body.data(), body.size());
+    }
+
+private:
+    string body;
+    vector<string> strings;
+    map<string, size_t> stringIndex;
+
+    size_t intern(const string &s)
+    {
+        auto it = stringIndex.find(s);
+        if (it != stringIndex.end())
+            return it->second;
+        strings.push_back(s);
+        stringIndex[s] = strings.size() - 1;
+        return strings.size() - 1;
+    }
+
+    void write_string(const string &s)
+    {
+        write_varint(body, intern(s));
+    }
+};
+
+// Lecture depuis un tampon contenant tout le fichier (vérification des bornes à chaque accès)
+class BinaryReader
+{
+public:
+    BinaryReader(const string &data, Module &module) : data(data), module(module) {}
+
+    void read()
+    {
+        if (data.compare(0, binaryMagic.size(), binaryMagic) != 0)
+            fail("en-tête absent");
+        pos = binaryMagic.size();
+        if (pos >= data.size() || (unsigned char)data[pos] != binaryVersion)
+            fail("version non supportée");
+        pos++;
+
+        size_t stringCount = read_count();
+        strings.reserve(stringCount);
+        for (size_t i = 0; i < stringCount; i++)
+        {
+            size_t length = read_count();
+            if (length > data.size() - pos)
+                fail("chaîne tronquée");
+            strings.push_back(data.substr(pos, length));
+            pos += length;
+        }
+
+        size_t functionCount = read_count();
+        for (size_t i = 0; i < functionCount; i++)
+        {
+            read_function();
+        }
+        if (pos != data.size())
+            fail("données en trop après la dernière fonction");
+    }
+
+private:
+    const string &data;
+    Module &module;
+    size_t pos = 0;
+    vector<string> strings;
+
+    void fail(const string &msg)
+    {
+        throw std::runtime_error("IR binaire invalide : " + msg);
+    }
+
+    unsigned long read_varint()
+    {
+        unsigned long value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (pos >= data.size())
+                fail("fin de fichier inattendue");
+            unsigned char byte = data[pos++];
+            value |= (unsigned long)(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return value;
+        }
+        fail("entier trop long");
+        return 0;
+    }
+
+    // Un nombre d'éléments ne peut pas dépasser la taille restante du fichier
+    size_t read_count()
+    {
+        unsigned long count = read_varint();
+        if (count > data.size() - pos)
+            fail("nombre d'éléments incohérent");
+        return count;
+    }
+
+    const string &read_string()
+    {
+        unsigned long index = read_varint();
+        if (index >= strings.size())
+            fail("index de chaîne hors limites");
+        return strings[index];
+    }
+
+    void read_function()
+    {
+        string name = read_string();
+        size_t paramCount = read_count();
+        vector<Param> params;
+        for (size_t i = 0; i < paramCount; i++)
+        {
+            params.push_back(Param(read_string(), Type(INT)));
+        }
+        unsigned long hint = read_varint();
+        if (hint > INLINE_NEVER)
+            fail("consigne d'intégration inconnue");
+
+        CFG *cfg = new CFG(new DefFonction(name, Type(INT), params));
+        cfg->ast->setInlineHint((InlineHint)hint);
+        try
+        {
+            read_body(*cfg);
+        }
+        catch (...)
+        {
+            delete cfg;
+            throw;
+        }
+        add_function(module, cfg);
+    }
+
+    void read_body(CFG &cfg)
+    {
+        size_t symbolCount = read_count();
+        for (size_t i = 0; i < symbolCount; i++)
+        {
+            string symbol = read_string();
+            unsigned long typeEnum = read_varint();
+            if (typeEnum != INT)
+                fail("type inconnu");
+            if (cfg.get_symbol_indices().count(symbol))
+                fail("symbole déclaré plusieurs fois : " + symbol);
+            cfg.add_to_symbol_table(symbol, Type((TypeEnum)typeEnum));
+        }
+
+        size_t blockCount = read_count();
+        if (blockCount == 0)
+            fail("la fonction " + cfg.get_name() + " n'a aucun bloc");
+        vector<BasicBlock *> blocks;
+        vector<std::pair<unsigned long, unsigned long>> exits;
+        for (size_t i = 0; i < blockCount; i++)
+        {
+            BasicBlock *bb = new BasicBlock(&cfg, read_string());
+            blocks.push_back(bb);
+
+            size_t instrCount = read_count();
+            for (size_t j = 0; j < instrCount; j++)
+            {
+                IRInstr::Operation op;
+                bool tail;
+                const string &opName = read_string();
+                if (!read_op_name(opName, op, tail))
+                    fail("opération inconnue : " + opName);
+                size_t count = read_count();
+                vector<string> params;
+                for (size_t k = 0; k < count; k++)
+                {
+                    params.push_back(read_string());
+                    if (!is_declared(cfg, params.back()))
+                        fail("variable non déclarée " + params.back());
+                }
+                if (!valid_param_count(op, params.size()))
+                    fail("mauvais nombre d'opérandes pour " + opName);
+                bb->add_IRInstr(op, Type(INT), params);
+                bb->instrs.back()->set_tail_call(tail);
+            }
+
+            unsigned long exitTrue = read_varint();
+            unsigned long exitFalse = read_varint();
+            unsigned long testVar = read_varint();
+            if (testVar > strings.size())
+                fail("index de chaîne hors limites");
+            if (testVar)
+                bb->test_var_name = strings[testVar - 1];
+            if (!is_declared(cfg, bb->test_var_name))
+                fail("variable non déclarée " + bb->test_var_name);
+            unsigned long expected = read_varint();
+            if (expected > 2)
+                fail("branche attendue invalide");
+            bb->expected_branch = (int)expected - 1;
+            unsigned long cold = read_varint();
+            if (cold > 1)
+                fail("marque de bloc froid invalide");
+            bb->cold = cold;
+            exits.push_back({exitTrue, exitFalse});
+        }
+
+        for (size_t i = 0; i < blockCount; i++)
+        {
+            if (exits[i].first > blockCount || exits[i].second > blockCount)
+                fail("successeur hors limites");
+            if (exits[i].first)
+                blocks[i]->exit_true = blocks[exits[i].first - 1];
+            if (exits[i].second)
+                blocks[i]->exit_false = blocks[exits[i].second - 1];
+        }
+    }
+};
+
+} // namespace
+
+void write_module_binary(ostream &o, const Module &module)
+{
+    BinaryWriter writer;
+    for (const auto &pair : module)
+    {
+        writer.write_function(*pair.second);
+    }
+    writer.finish(o, module.size());
+}
+
+void read_module_binary(std::istream &in, Module &module)
+{
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    string data = buffer.str();
+    BinaryReader reader(data, module);
+    reader.read();
+}
+
+// ---------------------------------------------------------------------------
+// Détection du format
+// ---------------------------------------------------------------------------
+
+void read_module(std::istream &in, Module &module)
+{
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    string data = buffer.str();
+    if (data.compare(0, binaryMagic.size(), binaryMagic) == 0)
+    {
+        BinaryReader reader(data, module);
+        reader.read();
+    }
+    else
+    {
+        std::istringstream text(data);
+        read_module_text(text, module);
+    }
+}
@@ -0,0 +1,51 @@
+// IRSERIALIZER.H : Lecture et écriture de l'IR (CFG, BasicBlocks, IRInstr, table des symboles)
+// Deux formats, qui permettent de rejouer les passes sans repasser par le front-end ANTLR :
+//
+//   - Format textuel (stable, lisible, identique à l'affichage de --print-after) :
+//       function max(a, b)         (suivi de inline, always_inline ou noinline pour une consigne d'intégration)
+//         symbol a int !0
+//         symbol b int !1
+//         symbol !2 int !2
+//       bb max_BB_0:               (suivi de cold pour un bloc froid placé par la passe layout)
+//         wmem !0, %edi
+//         ...
+//         br !2, BB_1, BB_2        (branchement sur test_var_name : exit_true, exit_false)
+//         br !2, BB_1, BB_2, unlikely  (4e opérande facultatif, likely ou unlikely : __builtin_expect)
+//       bb BB_1:
+//         tail call f, !3, !0      (appel terminal marqué par tailrec, émis comme un saut)
+//         ret !3
+//         exit                     (fin de fonction : saut vers l'épilogue)
+//       bb BB_2:
+//         jmp BB_3                 (saut inconditionnel vers exit_true)
+//       ...
+//       end
+//     Le premier bloc est le bloc d'entrée. Les lignes vides et celles commençant par ';' sont ignorées.
+//
+//   - Format binaire compact (chargement rapide) : en-tête "IFCCIRB" + version, table de chaînes
+//     dédupliquées, puis les fonctions ; tous les entiers sont codés en varint (LEB128 non signé).
+//     Les opérations sont stockées par leur nom ("tail call" pour un appel terminal), le format ne dépend
+//     donc pas de l'ordre de l'énumération.
+//
+// En cas d'entrée mal formée, une exception std::runtime_error est levée ; c'est aussi le cas d'une variable
+// "!N" hors de la table des symboles de sa fonction, que les passes ne peuvent pas traiter.
+#ifndef IR_SERIALIZER_H
+#define IR_SERIALIZER_H
+
+#include "IR.h"
+#include <iostream>
+#include <string>
+
+/** Écrit le module au format textuel */
+void write_module_text(ostream &o, const Module &module);
+/** Lit un module au format textuel et ajoute ses fonctions à module */
+void read_module_text(std::istream &in, Module &module);
+
+/** Écrit le module au format binaire */
+void write_module_binary(ostream &o, const Module &module);
+/** Lit un module au format binaire et ajoute ses fonctions à module */
+void read_module_binary(std::istream &in, Module &module);
+
+/** Lit un module en détectant automatiquement le format (binaire si l'en-tête est présent) */
+void read_module(std::istream &in, Module &module);
+
+#endif
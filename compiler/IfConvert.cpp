@@ -0,0 +1,404 @@
+// IFCONVERT.CPP : Conversion des petits if/else en sélections sans branchement (passe "ifconvert")
+// Un if/else qui n'affecte qu'une variable, comme  if (a > b) m = a; else m = b;  coûte un
+// branchement conditionnel dont le sens dépend des données : sur des valeurs aléatoires, il est mal
+// prédit une fois sur deux et chaque erreur vide le pipeline. Sur la forme SSA, trois motifs issus de
+// visitIf_stmt sont reconnus à partir du bloc H qui se termine par le branchement sur c :
+//   - losange : les deux branches T et F n'ont que H pour prédécesseur et sautent au même bloc J
+//   - triangle : une seule branche (if sans else), qui saute directement vers l'autre successeur de H
+//   - double return : les deux branches se terminent par un return
+// Les instructions des branches sont remontées à la fin de H (elles sont toutes exécutées), puis chaque
+// phi de J reçoit depuis H la valeur "select d, c, vT, vF" ; un double return devient
+// "select r, c, rT, rF ; ret r". Le branchement de H disparaît et T, F deviennent inatteignables.
+// Seules les instructions sans effet de bord et qui ne peuvent pas échouer sont remontées (ni appel, ni
+// division ou modulo par un diviseur peut-être nul). Modèle de coût : chaque instruction remontée
+// coûte 1 (une multiplication 3), chaque select 1 ; au-delà de maxCost, le branchement est gardé.
+// Idiomes reconnus, convertis quel que soit le coût :
+//   - max/min : select dont les valeurs sont les opérandes de la comparaison ; la comparaison est
+//     placée juste avant le select, que la génération de code fusionne en cmp + cmov (csel en ARM)
+//   - valeur absolue : x < 0 ? 0 - x : x (et ses variantes) devient "abs d, x" (cmov ou cneg)
+//   - booléen : c ? 1 : 0 devient une copie de c, c ? 0 : 1 devient "not d, c"
+// Un branchement annoncé par __builtin_expect est prévisible : il est gardé.
+// Avec --remarks, le nombre de branchements supprimés et d'idiomes reconnus est affiché par fonction.
+
+#include "Passes.h"
+#include <algorithm>
+
+namespace
+{
+
+// Coût maximal (instructions remontées + select) d'une conversion sans idiome reconnu
+const int maxCost = 6;
+
+class IfConvertPass : public FunctionPass
+{
+public:
+    string get_name() const override { return "ifconvert"; }
+
+    bool run_on_function(CFG &cfg, AnalysisManager &am) override
+    {
+        if (cfg.get_bbs().empty() || !cfg.is_ssa())
+            return false;
+
+        converted = 0;
+        minMax = 0;
+        absolute = 0;
+        booleans = 0;
+        // Une conversion peut en permettre une autre (else if imbriqués) : on recommence jusqu'au point fixe
+        bool changed = false;
+        bool progress = true;
+        while (progress)
+        {
+            progress = false;
+            collect_definitions(cfg);
+            map<BasicBlock *, vector<BasicBlock *>> preds = cfg.compute_predecessors();
+            for (BasicBlock *bb : cfg.get_bbs())
+            {
+                if (try_convert(cfg, bb, preds))
+                {
+                    cfg.remove_unreachable_bbs();
+                    progress = changed = true;
+                    break;
+                }
+            }
+        }
+        if (!changed)
+            return false;
+
+        cfg.prune_phis();
+        am.invalidate(&cfg, false);
+        string idioms;
+        if (minMax > 0)
+            idioms += ", " + std::to_string(minMax) + " min/max";
+        if (absolute > 0)
+            idioms += ", " + std::to_string(absolute) + " valeur(s) absolue(s)";
+        if (booleans > 0)
+            idioms += ", " + std::to_string(booleans) + " booléen(s)";
+        PassManager::remark(get_name(), cfg, std::to_string(converted) + " branchement(s) remplacé(s) par des select" + idioms);
+        return true;
+    }
+
+private:
+    map<string, IRInstr *> definition; // valeur SSA -> instruction qui la définit
+    int converted = 0;
+    int minMax = 0;
+    int absolute = 0;
+    int booleans = 0;
+
+    void collect_definitions(CFG &cfg)
+    {
+        definition.clear();
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            for (IRInstr *instr : bb->instrs)
+            {
+                string dest = instr->get_dest();
+                if (IRInstr::is_symbol(dest))
+                    definition[dest] = instr;
+            }
+        }
+    }
+
+    bool is_constant_value(const string &operand, int32_t value) const
+    {
+        if (IRInstr::is_constant(operand))
+            return IRInstr::constant_value(operand) == value;
+        auto it = definition.find(operand);
+        return it != definition.end() && it->second->get_op() == IRInstr::ldconst &&
+               IRInstr::constant_value(it->second->get_params()[1]) == value;
+    }
+
+    // Instructions d'une branche remontées dans H (sans le return final) ; faux si l'une d'elles
+    // ne peut pas être exécutée sans condition
+    static bool speculatable(BasicBlock *arm, size_t count, int &cost)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            switch (arm->instrs[i]->get_op())
+            {
+            case IRInstr::call:
+            case IRInstr::ret:
+            case IRInstr::phi:
+            case IRInstr::div:
+            case IRInstr::mod:
+            case IRInstr::rmem:
+            case IRInstr::wmem:
+                return false;
+            case IRInstr::mul:
+                cost += 3;
+                break;
+            default:
+                cost += 1;
+                break;
+            }
+        }
+        return true;
+    }
+
+    // Une sélection à créer : dest = c ? onTrue : onFalse
+    struct Selection
+    {
+        string dest, onTrue, onFalse;
+    };
+
+    // Idiome reconnu pour une sélection : compteur à incrémenter (nullptr si aucun)
+    int *idiom_of(const string &cond, const Selection &s)
+    {
+        auto it = definition.find(cond);
+        if (it == definition.end() || !IRInstr::is_comparison(it->second->get_op()))
+            return nullptr;
+        IRInstr *cmp = it->second;
+        IRInstr::Operation op = cmp->get_op();
+        const string &x = cmp->get_params()[1], &y = cmp->get_params()[2];
+        if (op != IRInstr::cmp_eq && op != IRInstr::cmp_ne &&
+            ((s.onTrue == x && s.onFalse == y) || (s.onTrue == y && s.onFalse == x)))
+            return &minMax;
+        if (absolute_operand(cmp, s) != "")
+            return &absolute;
+        if ((is_constant_value(s.onTrue, 1) && is_constant_value(s.onFalse, 0)) ||
+            (is_constant_value(s.onTrue, 0) && is_constant_value(s.onFalse, 1)))
+            return &booleans;
+        return nullptr;
+    }
+
+    // x si la sélection calcule |x| : x < 0 ? 0 - x : x, x > 0 ? x : 0 - x (et <=, >=) ; "" sinon
+    string absolute_operand(IRInstr *cmp, const Selection &s) const
+    {
+        IRInstr::Operation op = cmp->get_op();
+        const string &x = cmp->get_params()[1];
+        if (!is_constant_value(cmp->get_params()[2], 0))
+            return "";
+        string negated, positive;
+        if (op == IRInstr::cmp_lt || op == IRInstr::cmp_le)
+            negated = s.onTrue, positive = s.onFalse;
+        else if (op == IRInstr::cmp_gt || op == IRInstr::cmp_ge)
+            negated = s.onFalse, positive = s.onTrue;
+        else
+            return "";
+        auto it = definition.find(negated);
+        if (positive != x || it == definition.end() || it->second->get_op() != IRInstr::sub ||
+            !is_constant_value(it->second->get_params()[1], 0) || it->second->get_params()[2] != x)
+            return "";
+        return x;
+    }
+
+    // Opérande utilisable par un select : une constante littérale est chargée dans H
+    string as_symbol(CFG &cfg, BasicBlock *head, const string &operand, vector<IRInstr *> &out)
+    {
+        if (IRInstr::is_symbol(operand))
+            return operand;
+        string temp = cfg.create_new_tempvar(Type(INT));
+        IRInstr *load = new IRInstr(head, IRInstr::ldconst, Type(INT), {temp, operand});
+        definition[temp] = load;
+        out.push_back(load);
+        return temp;
+    }
+
+    // Instruction qui calcule s dans H : select, ou idiome réécrit
+    IRInstr *make_selection(BasicBlock *head, const string &cond, const Selection &s, int *idiom)
+    {
+        if (idiom == &absolute)
+        {
+            string x = absolute_operand(definition[cond], s);
+            return new IRInstr(head, IRInstr::abs_op, Type(INT), {s.dest, x});
+        }
+        if (idiom == &booleans)
+        {
+            IRInstr::Operation op = is_constant_value(s.onTrue, 1) ? IRInstr::copy : IRInstr::not_op;
+            return new IRInstr(head, op, Type(INT), {s.dest, cond});
+        }
+        return new IRInstr(head, IRInstr::select, Type(INT), {s.dest, cond, s.onTrue, s.onFalse});
+    }
+
+    bool try_convert(CFG &cfg, BasicBlock *head, map<BasicBlock *, vector<BasicBlock *>> &preds)
+    {
+        if (!head->exit_false || head->exit_true == head->exit_false || !IRInstr::is_symbol(head->test_var_name) ||
+            head->expected_branch >= 0)
+            return false;
+        BasicBlock *onTrue = head->exit_true, *onFalse = head->exit_false;
+        auto only_from_head = [&](BasicBlock *bb) {
+            return bb != head && preds[bb].size() == 1 && !bb->exit_false;
+        };
+        auto ends_with_ret = [](BasicBlock *bb) {
+            return !bb->exit_true && !bb->instrs.empty() && bb->instrs.back()->get_op() == IRInstr::ret &&
+                   bb->instrs.back()->get_params().size() == 1;
+        };
+
+        // Branches à remonter (nullptr : valeur venant directement de H) et bloc de jonction
+        BasicBlock *armTrue = nullptr, *armFalse = nullptr, *join = nullptr;
+        bool returns = false;
+        if (only_from_head(onTrue) && only_from_head(onFalse) && onTrue->exit_true && onTrue->exit_true == onFalse->exit_true)
+            armTrue = onTrue, armFalse = onFalse, join = onTrue->exit_true;
+        else if (only_from_head(onTrue) && onTrue->exit_true == onFalse)
+            armTrue = onTrue, join = onFalse;
+        else if (only_from_head(onFalse) && onFalse->exit_true == onTrue)
+            armFalse = onFalse, join = onTrue;
+        else if (only_from_head(onTrue) && only_from_head(onFalse) && ends_with_ret(onTrue) && ends_with_ret(onFalse))
+            armTrue = onTrue, armFalse = onFalse, returns = true;
+        else
+            return false;
+
+        int cost = 0;
+        size_t trueCount = armTrue ? armTrue->instrs.size() - (returns ? 1 : 0) : 0;
+        size_t falseCount = armFalse ? armFalse->instrs.size() - (returns ? 1 : 0) : 0;
+        if ((armTrue && !speculatable(armTrue, trueCount, cost)) || (armFalse && !speculatable(armFalse, falseCount, cost)))
+            return false;
+
+        // Valeurs à sélectionner : phi de J, ou valeurs retournées
+        string cond = head->test_var_name;
+        string trueLabel = armTrue ? armTrue->label : head->label;
+        string falseLabel = armFalse ? armFalse->label : head->label;
+        vector<Selection> selections;
+        vector<IRInstr *> phis;
+        if (returns)
+        {
+            selections.push_back({"", armTrue->instrs.back()->get_params()[0], armFalse->instrs.back()->get_params()[0]});
+        }
+        else
+        {
+            for (IRInstr *instr : join->instrs)
+            {
+                if (instr->get_op() != IRInstr::phi)
+                    break;
+                const vector<string> &p = instr->get_params();
+                Selection s;
+                bool foundTrue = false, foundFalse = false;
+                for (size_t i = 1; i + 1 < p.size(); i += 2)
+                {
+                    if (p[i + 1] == trueLabel)
+                        s.onTrue = p[i], foundTrue = true;
+                    if (p[i + 1] == falseLabel)
+                        s.onFalse = p[i], foundFalse = true;
+                }
+                if (!foundTrue || !foundFalse)
+                    return false;
+                phis.push_back(instr);
+                selections.push_back(s);
+            }
+        }
+
+        // Modèle de coût : des sélections qui sont toutes des idiomes reconnus sont toujours converties.
+        // Un registre physique (paramètre) ne peut être relu qu'en tête de fonction.
+        int selects = 0, idioms = 0;
+        for (const Selection &s : selections)
+        {
+            if (IRInstr::is_register(s.onTrue) || IRInstr::is_register(s.onFalse))
+                return false;
+            if (s.onTrue != s.onFalse)
+            {
+                selects++;
+                idioms += idiom_of(cond, s) != nullptr;
+            }
+        }
+        cost += selects;
+        if (cost > maxCost && (idioms == 0 || idioms != selects))
+            return false;
+        if (!PassManager::consume_fuel(get_name()))
+            return false;
+
+        // Remontée des branches à la fin de H
+        vector<IRInstr *> hoisted;
+        for (BasicBlock *arm : {armTrue, armFalse})
+        {
+            if (!arm)
+                continue;
+            size_t count = (arm == armTrue) ? trueCount : falseCount;
+            for (size_t i = 0; i < count; i++)
+            {
+                arm->instrs[i]->set_bb(head);
+                hoisted.push_back(arm->instrs[i]);
+            }
+            arm->instrs.erase(arm->instrs.begin(), arm->instrs.begin() + count);
+        }
+
+        // Sélections : la comparaison qui définit c est placée juste avant si elle n'a pas d'autre lecteur
+        vector<string> results;
+        for (Selection &s : selections)
+        {
+            if (s.onTrue == s.onFalse)
+            {
+                results.push_back(s.onTrue);
+                continue;
+            }
+            int *idiom = idiom_of(cond, s);
+            s.onTrue = as_symbol(cfg, head, s.onTrue, hoisted);
+            s.onFalse = as_symbol(cfg, head, s.onFalse, hoisted);
+            s.dest = cfg.create_new_tempvar(Type(INT));
+            IRInstr *selection = make_selection(head, cond, s, idiom);
+            definition[s.dest] = selection;
+            hoisted.push_back(selection);
+            results.push_back(s.dest);
+            if (idiom)
+                (*idiom)++;
+        }
+        move_compare_before_select(cfg, head, cond, hoisted);
+        head->instrs.insert(head->instrs.end(), hoisted.begin(), hoisted.end());
+
+        if (returns)
+        {
+            IRInstr *ret = armTrue->instrs.back();
+            armTrue->instrs.pop_back();
+            ret->set_bb(head);
+            ret->get_params()[0] = results[0];
+            head->instrs.push_back(ret);
+            head->exit_true = nullptr;
+        }
+        else
+        {
+            // Chaque phi de J reçoit la sélection depuis H à la place des valeurs des deux branches
+            for (size_t k = 0; k < phis.size(); k++)
+            {
+                vector<string> &p = phis[k]->get_params();
+                vector<string> kept = {p[0]};
+                for (size_t i = 1; i + 1 < p.size(); i += 2)
+                {
+                    if (p[i + 1] != trueLabel && p[i + 1] != falseLabel)
+                        kept.insert(kept.end(), {p[i], p[i + 1]});
+                }
+                kept.insert(kept.end(), {results[k], head->label});
+                p = kept;
+                if (p.size() == 3)
+                {
+                    phis[k]->set_op(IRInstr::copy);
+                    p = {p[0], p[1]};
+                }
+            }
+            head->exit_true = join;
+        }
+        head->exit_false = nullptr;
+        head->test_var_name.clear();
+        converted++;
+        return true;
+    }
+
+    // Une comparaison de H lue seulement par le select suivant est déplacée juste avant lui :
+    // la génération de code fusionne alors les deux (cmp + cmov, cmp + csel)
+    void move_compare_before_select(CFG &cfg, BasicBlock *head, const string &cond, vector<IRInstr *> &hoisted)
+    {
+        auto def = definition.find(cond);
+        if (def == definition.end() || def->second->get_bb() != head || !IRInstr::is_comparison(def->second->get_op()))
+            return;
+        IRInstr *cmp = def->second;
+        IRInstr *reader = nullptr;
+        // Le branchement de H, qui va disparaître, ne compte pas ; les instructions remontées ne sont pas encore dans H
+        int uses = cfg.count_uses(cond) - (head->exit_false && head->test_var_name == cond);
+        for (IRInstr *instr : hoisted)
+        {
+            for (size_t i : instr->get_use_indices())
+            {
+                if (instr->get_params()[i] == cond)
+                    uses++, reader = instr;
+            }
+        }
+        if (uses != 1 || !reader || reader->get_op() != IRInstr::select)
+            return;
+        head->instrs.erase(std::find(head->instrs.begin(), head->instrs.end(), cmp));
+        hoisted.insert(std::find(hoisted.begin(), hoisted.end(), reader), cmp);
+    }
+};
+
+} // namespace
+
+FunctionPass *createIfConvertPass()
+{
+    return new IfConvertPass();
+}
@@ -0,0 +1,260 @@
+// INLINE.CPP : Intégration des fonctions (passe "inline")
+// Chaque appel paie la séquence complète de gen_asm (neuf sauvegardes de registres, passage des
+// arguments, call, restaurations), souvent plus longue que le corps d'une petite fonction. Les fonctions
+// sont traitées de bas en haut selon les composantes fortement connexes du graphe d'appel : quand un
+// appelant est traité, ses appelés ont déjà reçu leurs propres intégrations.
+// Modèle de coût, en instructions IR : on intègre si la taille de l'appelé, moins le coût de l'appel
+// économisé et un bonus par utilisation d'un paramètre qui reçoit une constante (repliée ensuite par
+// sccp), reste sous le seuil (plus élevé pour une fonction déclarée inline). always_inline ignore le
+// coût, noinline interdit l'intégration ; un appel dans un bloc froid n'est pas intégré, ni un appel
+// vers une fonction récursive, et l'appelant cesse de grossir au-delà d'une taille maximale.
+// Intégration d'un site "call g, d, args" dans le bloc B :
+//   - B est coupé après l'appel : la suite passe dans un nouveau bloc S, qui reprend les sorties de B
+//   - les blocs de g sont clonés avec de nouveaux labels ; chaque variable de g devient un nouveau
+//     temporaire de l'appelant, chaque registre de paramètre l'argument correspondant, et les arcs
+//     comme les labels des phi sont renvoyés vers les clones
+//   - B saute vers le clone de l'entrée de g ; chaque return devient un saut vers S, où un phi (ou
+//     une copie, hors SSA : une copie par return) donne à d la valeur retournée
+// Appelant et appelé doivent être tous deux en SSA ou tous deux hors SSA. Avec --remarks, les appels
+// intégrés sont listés pour chaque appelant.
+
+#include "Passes.h"
+#include "DefFonction.h"
+#include <algorithm>
+
+namespace
+{
+
+// Seuils du modèle de coût, en instructions IR
+const int inlineThreshold = 25;      // fonction sans consigne
+const int inlineHintThreshold = 80;  // fonction déclarée inline
+const int callCost = 12;             // séquence d'appel économisée (sauvegardes, arguments, call, résultat)
+const int constantArgumentBonus = 4; // par utilisation d'un paramètre qui reçoit une constante
+const int maxCallerSize = 2000;      // taille au-delà de laquelle l'appelant ne reçoit plus d'intégration
+
+class InlinePass : public ModulePass
+{
+public:
+    string get_name() const override { return "inline"; }
+
+    bool run_on_module(Module &module, AnalysisManager &am) override
+    {
+        // Intégrer g dans f ne crée que des arcs f -> appelés de g, déjà atteignables depuis f :
+        // les composantes ne changent pas pendant la passe
+        CallGraph &callGraph = am.get_call_graph();
+        bool changed = false;
+        for (const vector<string> &scc : callGraph.get_sccs_bottom_up())
+        {
+            for (const string &name : scc)
+            {
+                CFG &caller = *module.at(name);
+                vector<string> inlined;
+                if (!inline_calls(module, callGraph, am, caller, inlined))
+                    continue;
+                changed = true;
+                string list;
+                for (const string &callee : inlined)
+                    list += (list.empty() ? "" : ", ") + callee;
+                PassManager::remark(get_name(), caller, std::to_string(inlined.size()) + " appel(s) intégré(s) : " + list);
+            }
+        }
+        return changed;
+    }
+
+private:
+    // Intègre les appels de caller retenus par le modèle de coût ; les appels ajoutés par les clones
+    // ont déjà été examinés dans l'appelé
+    bool inline_calls(Module &module, const CallGraph &callGraph, AnalysisManager &am, CFG &caller, vector<string> &inlined)
+    {
+        vector<IRInstr *> sites;
+        std::set<IRInstr *> cold;
+        BranchProbability &probability = am.get_branch_probability(&caller);
+        map<string, int32_t> constants = caller.compute_constant_values();
+        for (BasicBlock *bb : caller.get_bbs())
+        {
+            for (IRInstr *instr : bb->instrs)
+            {
+                if (instr->get_op() != IRInstr::call || !callGraph.is_defined(instr->get_params()[0]))
+                    continue;
+                sites.push_back(instr);
+                if (probability.is_cold(bb))
+                    cold.insert(instr);
+            }
+        }
+
+        int callerSize = caller.count_instructions();
+        for (IRInstr *call : sites)
+        {
+            const string &name = call->get_params()[0];
+            CFG &callee = *module.at(name);
+            if (!can_inline(callGraph, caller, *call, callee))
+                continue;
+            int calleeSize = callee.count_instructions();
+            if (callee.ast->getInlineHint() != INLINE_ALWAYS)
+            {
+                int threshold = callee.ast->getInlineHint() == INLINE_HINT ? inlineHintThreshold : inlineThreshold;
+                int cost = calleeSize - callCost - constant_bonus(*call, callee, constants);
+                if (cold.count(call) || callerSize + calleeSize > maxCallerSize || cost > threshold)
+                    continue;
+            }
+            if (!PassManager::consume_fuel(get_name()))
+                continue;
+            inlined.push_back(name);
+            inline_call(caller, call, callee);
+            callerSize += calleeSize;
+        }
+        if (inlined.empty())
+            return false;
+        caller.remove_unreachable_bbs();
+        caller.prune_phis();
+        return true;
+    }
+
+    // Conditions de validité, indépendantes du coût
+    static bool can_inline(const CallGraph &callGraph, const CFG &caller, const IRInstr &call, const CFG &callee)
+    {
+        if (callee.ast->getInlineHint() == INLINE_NEVER || callGraph.same_scc(caller.get_name(), callee.get_name()) ||
+            callGraph.is_recursive(callee.get_name()) || callee.get_bbs().empty())
+            return false;
+        if (call.get_params().size() - 2 != callee.ast->getParams().size() || caller.is_ssa() != callee.is_ssa())
+            return false;
+        // L'entrée clonée ne doit être atteinte que depuis le site d'appel
+        return callee.compute_predecessors()[callee.get_entry()].empty();
+    }
+
+    // Bonus des arguments constants : chaque utilisation du paramètre dans l'appelé pourra être repliée
+    static int constant_bonus(const IRInstr &call, const CFG &callee, const map<string, int32_t> &constants)
+    {
+        const vector<string> &args = call.get_params();
+        std::set<string> constantParams;
+        for (BasicBlock *bb : callee.get_bbs())
+        {
+            for (IRInstr *instr : bb->instrs)
+            {
+                for (size_t i : instr->get_use_indices())
+                {
+                    int arg = IRInstr::argument_index(instr->get_params()[i]);
+                    if (arg < 0 || (size_t)arg + 2 >= args.size())
+                        continue;
+                    const string &value = args[arg + 2];
+                    if (IRInstr::is_constant(value) || constants.count(value))
+                        constantParams.insert(instr->get_dest());
+                }
+            }
+        }
+
+        int bonus = 0;
+        for (BasicBlock *bb : callee.get_bbs())
+        {
+            for (IRInstr *instr : bb->instrs)
+            {
+                for (size_t i : instr->get_use_indices())
+                    bonus += constantParams.count(instr->get_params()[i]) * constantArgumentBonus;
+            }
+            if (bb->exit_false && constantParams.count(bb->test_var_name))
+                bonus += constantArgumentBonus;
+        }
+        return bonus;
+    }
+
+    // Charge un littéral dans un nouveau temporaire à la fin de bb (les opérandes restent des variables)
+    static string materialize(CFG &cfg, BasicBlock *bb, const string &value)
+    {
+        if (IRInstr::is_symbol(value))
+            return value;
+        string loaded = cfg.create_new_tempvar(Type::INT_TYPE);
+        bb->add_IRInstr(IRInstr::ldconst, Type::INT_TYPE, {loaded, value});
+        return loaded;
+    }
+
+    void inline_call(CFG &caller, IRInstr *call, CFG &callee)
+    {
+        BasicBlock *bb = call->get_bb();
+        string dest = call->get_params()[1];
+
+        // La suite de bb après l'appel passe dans un nouveau bloc, qui reprend ses sorties
+        BasicBlock *rest = new BasicBlock(&caller, caller.new_BB_name());
+        auto pos = std::find(bb->instrs.begin(), bb->instrs.end(), call);
+        rest->instrs.assign(pos + 1, bb->instrs.end());
+        for (IRInstr *instr : rest->instrs)
+            instr->set_bb(rest);
+        bb->instrs.erase(pos, bb->instrs.end());
+        rest->exit_true = bb->exit_true;
+        rest->exit_false = bb->exit_false;
+        rest->test_var_name = bb->test_var_name;
+        rest->expected_branch = bb->expected_branch;
+        for (BasicBlock *succ : rest->get_successors())
+            succ->rename_phi_label(bb->label, rest->label);
+        bb->exit_false = nullptr;
+        bb->test_var_name.clear();
+        bb->expected_branch = -1;
+
+        vector<string> args;
+        for (size_t i = 2; i < call->get_params().size(); i++)
+            args.push_back(materialize(caller, bb, call->get_params()[i]));
+        delete call;
+
+        // Clonage des blocs de l'appelé : chaque registre de paramètre devient l'argument correspondant
+        map<string, string> renamed;
+        for (BasicBlock *original : callee.get_bbs())
+        {
+            for (IRInstr *instr : original->instrs)
+            {
+                for (size_t i : instr->get_use_indices())
+                {
+                    const string &operand = instr->get_params()[i];
+                    int arg = IRInstr::argument_index(operand);
+                    if (arg >= 0)
+                        renamed[operand] = (size_t)arg < args.size() ? args[arg] : materialize(caller, bb, "0");
+                }
+            }
+        }
+        map<BasicBlock *, BasicBlock *> clones = caller.clone_blocks(callee, renamed);
+
+        // Un return devient un saut vers la suite de l'appelant (une fin sans return vaut 0)
+        vector<std::pair<string, BasicBlock *>> results;
+        for (BasicBlock *original : callee.get_bbs())
+        {
+            BasicBlock *clone = clones.at(original);
+            if (clone->exit_true != nullptr)
+                continue;
+            string value = "0";
+            if (!clone->instrs.empty() && clone->instrs.back()->get_op() == IRInstr::ret)
+            {
+                value = clone->instrs.back()->get_params()[0];
+                delete clone->instrs.back();
+                clone->instrs.pop_back();
+            }
+            results.push_back({materialize(caller, clone, value), clone});
+            clone->exit_true = rest;
+        }
+        bb->exit_true = clones.at(callee.get_entry());
+
+        // Valeur retournée : phi dans la suite (SSA), ou copie à la fin de chaque return
+        if (results.empty())
+            return;
+        if (!caller.is_ssa())
+        {
+            for (const auto &result : results)
+                result.second->add_IRInstr(IRInstr::copy, Type::INT_TYPE, {dest, result.first});
+            return;
+        }
+        IRInstr *merge;
+        if (results.size() == 1)
+            merge = new IRInstr(rest, IRInstr::copy, Type::INT_TYPE, {dest, results[0].first});
+        else
+        {
+            merge = new IRInstr(rest, IRInstr::phi, Type::INT_TYPE, {dest});
+            for (const auto &result : results)
+                merge->get_params().insert(merge->get_params().end(), {result.first, result.second->label});
+        }
+        rest->instrs.insert(rest->instrs.begin(), merge);
+    }
+};
+
+} // namespace
+
+ModulePass *createInlinePass()
+{
+    return new InlinePass();
+}
@@ -0,0 +1,329 @@
+// INSTCOMBINE.CPP : Simplifications algébriques et forme canonique des instructions (passe "instcombine")
+// Travaille sur la forme SSA : la définition unique de chaque valeur permet de savoir qu'un opérande
+// est une constante (ldconst) ou le résultat d'une autre opération, en traversant les copy.
+//   - forme canonique : la constante d'une opération commutative passe à droite
+//     (c < x devient x > c), et "x - c" devient "x + (-c)"
+//   - éléments neutres et absorbants : x+0, x*1, x/1, x|0, x^0, x&-1 -> x ; x*0, x&0, x%1 -> 0
+//   - opérandes identiques : x-x, x^x -> 0 ; x&x, x|x -> x ; x==x -> 1 ; x<x -> 0...
+//   - négations : !(a < b) -> a >= b (pour toutes les comparaisons), !!x -> x != 0 (x si x vaut déjà 0 ou 1)
+//   - réassociation des chaînes de constantes : (x + 1) + 2 -> x + 3 (de même pour *, &, |, ^)
+//   - une opération dont les deux opérandes sont devenus constants est repliée
+// Une instruction simplifiée devient un copy ou un ldconst ; les instructions qui ne sont plus
+// utilisées restent en place pour la passe d'élimination du code mort.
+// Les blocs sont parcourus en reverse post-order jusqu'au point fixe : une définition est
+// simplifiée avant ses utilisations (hors phi).
+
+#include "Passes.h"
+
+namespace
+{
+
+class InstCombinePass : public FunctionPass
+{
+public:
+    string get_name() const override { return "instcombine"; }
+    bool preserves_cfg() const override { return true; }
+
+    bool run_on_function(CFG &cfg, AnalysisManager &am) override
+    {
+        if (cfg.get_bbs().empty() || !cfg.is_ssa())
+            return false;
+
+        definition.clear();
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            for (IRInstr *instr : bb->instrs)
+            {
+                string dest = instr->get_dest();
+                if (IRInstr::is_symbol(dest))
+                    definition[dest] = instr;
+            }
+        }
+
+        bool changed = false;
+        bool progress = true;
+        while (progress)
+        {
+            progress = false;
+            for (BasicBlock *bb : cfg.compute_rpo())
+            {
+                for (size_t i = 0; i < bb->instrs.size(); i++)
+                {
+                    vector<IRInstr *> inserted;
+                    if (!simplify(cfg, bb->instrs[i], inserted))
+                        continue;
+                    progress = true;
+                    bb->instrs.insert(bb->instrs.begin() + i, inserted.begin(), inserted.end());
+                    i += inserted.size();
+                }
+            }
+            changed |= progress;
+        }
+        return changed;
+    }
+
+private:
+    map<string, IRInstr *> definition; // valeur SSA -> instruction qui la définit
+
+    // Remonte les copies : la valeur dont operand n'est qu'un autre nom
+    string resolve(const string &operand) const
+    {
+        string v = operand;
+        for (size_t steps = 0; steps <= definition.size(); steps++)
+        {
+            auto it = definition.find(v);
+            if (it == definition.end() || it->second->get_op() != IRInstr::copy)
+                break;
+            v = it->second->get_params()[1];
+        }
+        return v;
+    }
+
+    // Instruction qui calcule la valeur (après les copies), nullptr pour un paramètre ou une constante littérale
+    IRInstr *defining(const string &operand) const
+    {
+        auto it = definition.find(resolve(operand));
+        return it == definition.end() ? nullptr : it->second;
+    }
+
+    bool constant_of(const string &operand, int32_t &value) const
+    {
+        string v = resolve(operand);
+        if (IRInstr::is_constant(v))
+        {
+            value = IRInstr::constant_value(v);
+            return true;
+        }
+        IRInstr *def = defining(v);
+        if (!def || def->get_op() != IRInstr::ldconst)
+            return false;
+        value = IRInstr::constant_value(def->get_params()[1]);
+        return true;
+    }
+
+    static bool is_associative(IRInstr::Operation op)
+    {
+        return op == IRInstr::add || op == IRInstr::mul || op == IRInstr::bit_and || op == IRInstr::bit_or ||
+               op == IRInstr::bit_xor;
+    }
+
+    // a op b  <=>  b mirror(op) a
+    static IRInstr::Operation mirror(IRInstr::Operation op)
+    {
+        switch (op)
+        {
+        case IRInstr::cmp_lt: return IRInstr::cmp_gt;
+        case IRInstr::cmp_gt: return IRInstr::cmp_lt;
+        case IRInstr::cmp_le: return IRInstr::cmp_ge;
+        case IRInstr::cmp_ge: return IRInstr::cmp_le;
+        default: return op;
+        }
+    }
+
+    // !(a op b)  <=>  a inverse(op) b
+    static IRInstr::Operation inverse(IRInstr::Operation op)
+    {
+        switch (op)
+        {
+        case IRInstr::cmp_eq: return IRInstr::cmp_ne;
+        case IRInstr::cmp_ne: return IRInstr::cmp_eq;
+        case IRInstr::cmp_lt: return IRInstr::cmp_ge;
+        case IRInstr::cmp_ge: return IRInstr::cmp_lt;
+        case IRInstr::cmp_gt: return IRInstr::cmp_le;
+        default: return IRInstr::cmp_gt; // cmp_le
+        }
+    }
+
+    // Vrai si la valeur vaut toujours 0 ou 1
+    bool is_boolean(const string &operand) const
+    {
+        int32_t c;
+        if (constant_of(operand, c))
+            return c == 0 || c == 1;
+        IRInstr *def = defining(operand);
+        if (!def)
+            return false;
+        IRInstr::Operation op = def->get_op();
+        return IRInstr::is_comparison(op) || op == IRInstr::not_op || op == IRInstr::logical_and || op == IRInstr::logical_or;
+    }
+
+    // Nouvelle constante, chargée juste avant l'instruction en cours
+    string new_constant(CFG &cfg, BasicBlock *bb, int32_t value, vector<IRInstr *> &inserted)
+    {
+        string temp = cfg.create_new_tempvar(Type(INT));
+        IRInstr *load = new IRInstr(bb, IRInstr::ldconst, Type(INT), {temp, std::to_string(value)});
+        definition[temp] = load;
+        inserted.push_back(load);
+        return temp;
+    }
+
+    // Remplacements (chacun consomme une unité de carburant)
+    bool replace_by_copy(IRInstr *instr, const string &source)
+    {
+        if (!PassManager::consume_fuel(get_name()))
+            return false;
+        instr->set_op(IRInstr::copy);
+        instr->get_params() = {instr->get_params()[0], source};
+        return true;
+    }
+
+    bool replace_by_constant(IRInstr *instr, int32_t value)
+    {
+        if (!PassManager::consume_fuel(get_name()))
+            return false;
+        instr->set_op(IRInstr::ldconst);
+        instr->get_params() = {instr->get_params()[0], std::to_string(value)};
+        return true;
+    }
+
+    bool simplify(CFG &cfg, IRInstr *instr, vector<IRInstr *> &inserted)
+    {
+        IRInstr::Operation op = instr->get_op();
+        vector<string> &p = instr->get_params();
+        if (op == IRInstr::not_op)
+            return simplify_not(cfg, instr, inserted);
+        if (op == IRInstr::ldconst || op == IRInstr::copy || op == IRInstr::call || op == IRInstr::ret ||
+            op == IRInstr::phi || p.size() != 3)
+            return false;
+
+        int32_t cx, cy;
+        bool constX = constant_of(p[1], cx);
+        bool constY = constant_of(p[2], cy);
+
+        // Deux constantes (apparues après une simplification) : repliement direct
+        int32_t folded;
+        if (constX && constY && IRInstr::fold(op, cx, cy, folded))
+            return replace_by_constant(instr, folded);
+
+        // La constante à droite
+        if (constX && !constY && (IRInstr::is_commutative(op) || mirror(op) != op))
+        {
+            if (!PassManager::consume_fuel(get_name()))
+                return false;
+            instr->set_op(mirror(op));
+            std::swap(p[1], p[2]);
+            return true;
+        }
+
+        bool same = resolve(p[1]) == resolve(p[2]);
+        switch (op)
+        {
+        case IRInstr::add:
+            if (constY && cy == 0)
+                return replace_by_copy(instr, p[1]);
+            break;
+        case IRInstr::sub:
+            if (same)
+                return replace_by_constant(instr, 0);
+            if (constY && cy == 0)
+                return replace_by_copy(instr, p[1]);
+            if (constY && PassManager::consume_fuel(get_name()))
+            {
+                // x - c -> x + (-c) (modulo 2^32), qui peut ensuite être réassocié
+                instr->set_op(IRInstr::add);
+                p[2] = new_constant(cfg, instr->get_bb(), (int32_t)(0u - (uint32_t)cy), inserted);
+                return true;
+            }
+            break;
+        case IRInstr::mul:
+            if (constY && cy == 0)
+                return replace_by_constant(instr, 0);
+            if (constY && cy == 1)
+                return replace_by_copy(instr, p[1]);
+            break;
+        case IRInstr::div:
+            if (constY && cy == 1)
+                return replace_by_copy(instr, p[1]);
+            break;
+        case IRInstr::mod:
+            if (constY && cy == 1)
+                return replace_by_constant(instr, 0);
+            break;
+        case IRInstr::bit_and:
+            if (same || (constY && cy == -1))
+                return replace_by_copy(instr, p[1]);
+            if (constY && cy == 0)
+                return replace_by_constant(instr, 0);
+            break;
+        case IRInstr::bit_or:
+            if (same || (constY && cy == 0))
+                return replace_by_copy(instr, p[1]);
+            if (constY && cy == -1)
+                return replace_by_constant(instr, -1);
+            break;
+        case IRInstr::bit_xor:
+            if (same)
+                return replace_by_constant(instr, 0);
+            if (constY && cy == 0)
+                return replace_by_copy(instr, p[1]);
+            break;
+        case IRInstr::cmp_eq:
+        case IRInstr::cmp_le:
+        case IRInstr::cmp_ge:
+            if (same)
+                return replace_by_constant(instr, 1);
+            break;
+        case IRInstr::cmp_ne:
+        case IRInstr::cmp_lt:
+        case IRInstr::cmp_gt:
+            if (same)
+                return replace_by_constant(instr, 0);
+            break;
+        default:
+            break;
+        }
+
+        // (x op c1) op c2 -> x op (c1 op c2)
+        IRInstr *inner = defining(p[1]);
+        int32_t c1;
+        if (constY && is_associative(op) && inner && inner->get_op() == op &&
+            constant_of(inner->get_params()[2], c1) && IRInstr::fold(op, c1, cy, folded) &&
+            PassManager::consume_fuel(get_name()))
+        {
+            p[1] = inner->get_params()[1];
+            p[2] = new_constant(cfg, instr->get_bb(), folded, inserted);
+            return true;
+        }
+        return false;
+    }
+
+    bool simplify_not(CFG &cfg, IRInstr *instr, vector<IRInstr *> &inserted)
+    {
+        vector<string> &p = instr->get_params();
+        IRInstr *inner = defining(p[1]);
+        if (!inner)
+            return false;
+        IRInstr::Operation innerOp = inner->get_op();
+        const vector<string> &q = inner->get_params();
+
+        if (IRInstr::is_comparison(innerOp))
+        {
+            // !(a < b) -> a >= b
+            if (!PassManager::consume_fuel(get_name()))
+                return false;
+            instr->set_op(inverse(innerOp));
+            p = {p[0], q[1], q[2]};
+            return true;
+        }
+        if (innerOp == IRInstr::not_op)
+        {
+            // !!x -> x != 0, ou x si x vaut déjà 0 ou 1
+            string x = q[1];
+            if (is_boolean(x))
+                return replace_by_copy(instr, x);
+            if (!PassManager::consume_fuel(get_name()))
+                return false;
+            instr->set_op(IRInstr::cmp_ne);
+            p = {p[0], x, new_constant(cfg, instr->get_bb(), 0, inserted)};
+            return true;
+        }
+        return false;
+    }
+};
+
+} // namespace
+
+FunctionPass *createInstCombinePass()
+{
+    return new InstCombinePass();
+}
@@ -0,0 +1,500 @@
+// INTERPRETER.CPP : Traduction de l'IR en bytecode et interpréteur direct-threaded (voir Interpreter.h)
+// Sémantique alignée sur le code généré :
+//   - arithmétique sur 32 bits avec débordement modulo 2^32 ; / et % tronquent vers zéro
+//     et lèvent SIGFPE sur une division par zéro ou INT_MIN / -1, comme idivl
+//   - comparaisons, !, && et || produisent 0 ou 1
+//   - ret fixe la valeur de retour, la fonction se termine à la sortie du bloc
+// Une variable lue avant d'être écrite vaut 0 (le programme compilé lirait le contenu de la pile).
+
+#include "Interpreter.h"
+#include <chrono>
+#include <climits>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+namespace
+{
+
+enum Opcode : uint8_t
+{
+    OP_LDC, // a = constante b
+    OP_MOV, // a = b
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+    OP_DIV,
+    OP_MOD,
+    OP_EQ,
+    OP_NE,
+    OP_LT,
+    OP_GT,
+    OP_LE,
+    OP_GE,
+    OP_NOT,
+    OP_AND,
+    OP_XOR,
+    OP_OR,
+    OP_LAND,
+    OP_LOR,
+    OP_ABS,
+    OP_SELECT,  // a = (b ? première : seconde valeur), valeurs rangées à l'indice c de argPool
+    OP_JMP,     // saut vers l'instruction b
+    OP_BR,      // si a, saut vers b, sinon vers c
+    OP_CALL,    // a = appel de la fonction b, arguments décrits à l'indice c de argPool
+    OP_PUTCHAR, // a = putchar(b)
+    OP_GETCHAR, // a = getchar()
+    OP_RET,     // valeur de retour = a
+    OP_EXIT     // fin de la fonction
+};
+
+struct Insn
+{
+    const void *handler; // adresse du code de l'opcode (remplie au premier appel de la fonction)
+    Opcode op;
+    int32_t a, b, c;
+};
+
+// Nombre maximal d'arguments transmis par registre (6 en x86-64, 8 en ARM64)
+static const int maxRegisterArgs = 8;
+
+struct Function
+{
+    string name;
+    vector<Insn> code;
+    vector<int32_t> argPool;      // pour chaque appel : nombre d'arguments, puis leurs registres ;
+                                  // pour chaque select : registres de ses deux valeurs
+    vector<int32_t> initialRegs;  // contenu initial du cadre : constantes à leur place, 0 ailleurs
+    int32_t paramRegs[maxRegisterArgs]; // registre recevant le i-ème argument (-1 s'il n'est pas lu)
+    const void *const *threadedWith = nullptr; // table des handlers copiés dans code (nullptr : pas encore)
+};
+
+// Pile des cadres d'activation (les registres de chaque appel sont contigus)
+static const size_t valueStackSize = 1 << 24;
+// Profondeur maximale des appels (un cadre vide ne consomme rien sur la pile des valeurs)
+static const size_t maxCallDepth = 1 << 20;
+
+// Appelant suspendu : sa fonction, l'instruction d'appel (qui reçoit le résultat) et ses registres
+struct Activation
+{
+    Function *function;
+    const Insn *callPc;
+    int32_t *regs;
+    int32_t retval;
+};
+
+struct Program
+{
+    vector<Function> functions;
+    std::unique_ptr<int32_t[]> valueStack;
+    int32_t *stackEnd = nullptr;
+    uint64_t executed = 0; // instructions exécutées (compté seulement avec --stats)
+};
+
+// ---------------------------------------------------------------------------
+// Traduction CFG -> bytecode
+// ---------------------------------------------------------------------------
+
+class Lowering
+{
+public:
+    Lowering(const map<string, int> &functionIndex, const CFG *cfg, Function &f)
+        : functionIndex(functionIndex), cfg(cfg), f(f) {}
+
+    void lower()
+    {
+        f.name = cfg->get_name();
+        for (int i = 0; i < maxRegisterArgs; i++)
+            f.paramRegs[i] = -1;
+
+        vector<BasicBlock *> blocks = cfg->compute_rpo();
+        map<BasicBlock *, int32_t> start;
+        vector<std::pair<size_t, BasicBlock *>> fixups; // (instruction, champ b ou c à corriger)
+        vector<std::pair<size_t, BasicBlock *>> fixupsFalse;
+        for (size_t i = 0; i < blocks.size(); i++)
+        {
+            BasicBlock *bb = blocks[i];
+            start[bb] = f.code.size();
+            for (IRInstr *instr : bb->instrs)
+                lower_instr(instr);
+
+            BasicBlock *next = i + 1 < blocks.size() ? blocks[i + 1] : nullptr;
+            if (!bb->exit_true)
+                emit(OP_EXIT, 0, 0, 0);
+            else if (!bb->exit_false || bb->exit_false == bb->exit_true)
+            {
+                // Pas de saut vers le bloc suivant dans l'ordre de placement
+                if (bb->exit_true != next)
+                {
+                    fixups.push_back({f.code.size(), bb->exit_true});
+                    emit(OP_JMP, 0, 0, 0);
+                }
+            }
+            else
+            {
+                fixups.push_back({f.code.size(), bb->exit_true});
+                fixupsFalse.push_back({f.code.size(), bb->exit_false});
+                emit(OP_BR, reg(bb->test_var_name), 0, 0);
+            }
+        }
+        for (auto &fix : fixups)
+            f.code[fix.first].b = start[fix.second];
+        for (auto &fix : fixupsFalse)
+            f.code[fix.first].c = start[fix.second];
+
+        f.initialRegs.resize(nextReg, 0);
+        for (auto &pair : constants)
+            f.initialRegs[pair.second] = pair.first;
+    }
+
+private:
+    const map<string, int> &functionIndex;
+    const CFG *cfg;
+    Function &f;
+    int32_t nextReg = 0;
+    map<string, int32_t> symbolRegs;
+    map<int32_t, int32_t> constants; // valeur -> registre qui la contient
+
+    void emit(Opcode op, int32_t a, int32_t b, int32_t c)
+    {
+        f.code.push_back({nullptr, op, a, b, c});
+    }
+
+    [[noreturn]] void fail(const string &msg)
+    {
+        throw std::runtime_error("exécution de '" + f.name + "' : " + msg);
+    }
+
+    int32_t constant_reg(int32_t value)
+    {
+        auto it = constants.find(value);
+        if (it != constants.end())
+            return it->second;
+        return constants[value] = nextReg++;
+    }
+
+    // Registre du cadre associé à un opérande de l'IR
+    int32_t reg(const string &operand)
+    {
+        if (IRInstr::is_symbol(operand))
+        {
+            auto it = symbolRegs.find(operand);
+            if (it != symbolRegs.end())
+                return it->second;
+            return symbolRegs[operand] = nextReg++;
+        }
+        if (IRInstr::is_constant(operand))
+            return constant_reg(IRInstr::constant_value(operand));
+        int arg = IRInstr::argument_index(operand);
+        if (arg >= 0)
+        {
+            if (f.paramRegs[arg] < 0)
+                f.paramRegs[arg] = nextReg++;
+            return f.paramRegs[arg];
+        }
+        fail("opérande inconnu '" + operand + "'");
+    }
+
+    void lower_instr(IRInstr *instr)
+    {
+        static const std::pair<IRInstr::Operation, Opcode> binaryOps[] = {
+            {IRInstr::add, OP_ADD}, {IRInstr::sub, OP_SUB}, {IRInstr::mul, OP_MUL}, {IRInstr::div, OP_DIV},
+            {IRInstr::mod, OP_MOD}, {IRInstr::cmp_eq, OP_EQ}, {IRInstr::cmp_ne, OP_NE}, {IRInstr::cmp_lt, OP_LT},
+            {IRInstr::cmp_gt, OP_GT}, {IRInstr::cmp_le, OP_LE}, {IRInstr::cmp_ge, OP_GE},
+            {IRInstr::bit_and, OP_AND}, {IRInstr::bit_xor, OP_XOR}, {IRInstr::bit_or, OP_OR},
+            {IRInstr::logical_and, OP_LAND}, {IRInstr::logical_or, OP_LOR}};
+
+        const vector<string> &p = instr->get_params();
+        switch (instr->get_op())
+        {
+        case IRInstr::ldconst:
+            emit(OP_LDC, reg(p[0]), IRInstr::constant_value(p[1]), 0);
+            return;
+        case IRInstr::rmem:
+        case IRInstr::wmem:
+        case IRInstr::copy:
+            if (p[0] != p[1])
+                emit(OP_MOV, reg(p[0]), reg(p[1]), 0);
+            return;
+        case IRInstr::not_op:
+            emit(OP_NOT, reg(p[0]), reg(p[1]), 0);
+            return;
+        case IRInstr::abs_op:
+            emit(OP_ABS, reg(p[0]), reg(p[1]), 0);
+            return;
+        case IRInstr::select:
+        {
+            int32_t values = f.argPool.size();
+            f.argPool.push_back(reg(p[2]));
+            f.argPool.push_back(reg(p[3]));
+            emit(OP_SELECT, reg(p[0]), reg(p[1]), values);
+            return;
+        }
+        case IRInstr::ret:
+            emit(OP_RET, reg(p[0]), 0, 0);
+            return;
+        case IRInstr::call:
+            lower_call(p);
+            return;
+        case IRInstr::phi:
+            fail("phi non supporté (la passe out-of-ssa doit être exécutée avant)");
+        default:
+            break;
+        }
+        for (const auto &binary : binaryOps)
+        {
+            if (binary.first == instr->get_op())
+            {
+                emit(binary.second, reg(p[0]), reg(p[1]), reg(p[2]));
+                return;
+            }
+        }
+        fail("opération " + IRInstr::op_name(instr->get_op()) + " non supportée");
+    }
+
+    void lower_call(const vector<string> &p)
+    {
+        const string &callee = p[0];
+        int32_t dest = reg(p[1]);
+        if (callee == "putchar")
+        {
+            emit(OP_PUTCHAR, dest, p.size() > 2 ? reg(p[2]) : constant_reg(0), 0);
+            return;
+        }
+        if (callee == "getchar")
+        {
+            emit(OP_GETCHAR, dest, 0, 0);
+            return;
+        }
+        auto it = functionIndex.find(callee);
+        if (it == functionIndex.end())
+            fail("appel de la fonction non définie '" + callee + "'");
+        int32_t args = f.argPool.size();
+        f.argPool.push_back(p.size() - 2);
+        for (size_t i = 2; i < p.size(); i++)
+            f.argPool.push_back(reg(p[i]));
+        emit(OP_CALL, dest, it->second, args);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Interpréteur
+// ---------------------------------------------------------------------------
+
+// Exécute entry dont le cadre commence à regs ; les cadres des appelés sont alloués juste après
+// Les appels ne récursent pas sur la pile C++ : l'appelant est empilé dans calls et repris au retour,
+// si bien qu'une récursion profonde ne s'arrête que sur la limite de la pile des valeurs (SIGSEGV,
+// comme le programme compilé)
+// Count : compte les instructions exécutées dans prog.executed (une version sans compteur sert
+// à l'exécution normale, pour ne pas ralentir la boucle d'interprétation)
+template <bool Count>
+static int32_t execute(Program &prog, Function &entry, int32_t *regs)
+{
+    // Adresses du code de chaque opcode, dans l'ordre de l'énumération Opcode
+    static const void *const handlers[] = {
+        &&do_ldc, &&do_mov, &&do_add, &&do_sub, &&do_mul, &&do_div, &&do_mod,
+        &&do_eq, &&do_ne, &&do_lt, &&do_gt, &&do_le, &&do_ge, &&do_not,
+        &&do_and, &&do_xor, &&do_or, &&do_land, &&do_lor, &&do_abs, &&do_select,
+        &&do_jmp, &&do_br, &&do_call, &&do_putchar, &&do_getchar, &&do_ret, &&do_exit};
+
+    // Direct threading : l'opcode est remplacé une fois pour toutes par l'adresse de son code
+    for (Function &function : prog.functions)
+    {
+        if (function.threadedWith == handlers)
+            continue;
+        for (Insn &insn : function.code)
+            insn.handler = handlers[insn.op];
+        function.threadedWith = handlers;
+    }
+
+    Function *f = &entry;
+    const Insn *code = f->code.data();
+    const Insn *pc = code;
+    int32_t *frameEnd = regs + f->initialRegs.size();
+    int32_t retval = 0;
+    vector<Activation> calls;
+
+#define DISPATCH()          \
+    do                      \
+    {                       \
+        if (Count)          \
+            prog.executed++; \
+        goto *pc->handler;  \
+    } while (0)
+#define NEXT()     \
+    do             \
+    {              \
+        ++pc;      \
+        DISPATCH(); \
+    } while (0)
+#define BINARY(expr)                                 \
+    do                                               \
+    {                                                \
+        uint32_t x = regs[pc->b], y = regs[pc->c];   \
+        regs[pc->a] = (int32_t)(expr);               \
+        NEXT();                                      \
+    } while (0)
+
+    DISPATCH();
+
+do_ldc:
+    regs[pc->a] = pc->b;
+    NEXT();
+do_mov:
+    regs[pc->a] = regs[pc->b];
+    NEXT();
+do_add:
+    BINARY(x + y);
+do_sub:
+    BINARY(x - y);
+do_mul:
+    BINARY(x * y);
+do_div:
+do_mod:
+{
+    // Même comportement que idivl : SIGFPE sur une division par zéro ou un débordement
+    int32_t x = regs[pc->b], y = regs[pc->c];
+    if (y == 0 || (x == INT_MIN && y == -1))
+        std::raise(SIGFPE);
+    regs[pc->a] = (pc->op == OP_DIV) ? x / y : x % y;
+    NEXT();
+}
+do_eq:
+    BINARY(x == y);
+do_ne:
+    BINARY(x != y);
+do_lt:
+    BINARY((int32_t)x < (int32_t)y);
+do_gt:
+    BINARY((int32_t)x > (int32_t)y);
+do_le:
+    BINARY((int32_t)x <= (int32_t)y);
+do_ge:
+    BINARY((int32_t)x >= (int32_t)y);
+do_not:
+    regs[pc->a] = regs[pc->b] == 0;
+    NEXT();
+do_and:
+    BINARY(x & y);
+do_xor:
+    BINARY(x ^ y);
+do_or:
+    BINARY(x | y);
+do_land:
+    BINARY(x != 0 && y != 0);
+do_lor:
+    BINARY(x != 0 || y != 0);
+do_abs:
+{
+    uint32_t x = regs[pc->b];
+    regs[pc->a] = (int32_t)x < 0 ? (int32_t)(0u - x) : (int32_t)x;
+    NEXT();
+}
+do_select:
+    regs[pc->a] = regs[f->argPool[pc->c + (regs[pc->b] ? 0 : 1)]];
+    NEXT();
+do_jmp:
+    pc = code + pc->b;
+    DISPATCH();
+do_br:
+    pc = code + (regs[pc->a] ? pc->b : pc->c);
+    DISPATCH();
+do_call:
+{
+    Function &callee = prog.functions[pc->b];
+    size_t size = callee.initialRegs.size();
+    // Débordement de la pile : le programme compilé s'arrêterait sur SIGSEGV
+    if (frameEnd + size > prog.stackEnd || calls.size() == maxCallDepth)
+        std::raise(SIGSEGV);
+    std::memcpy(frameEnd, callee.initialRegs.data(), size * sizeof(int32_t));
+    const int32_t *args = &f->argPool[pc->c];
+    for (int32_t i = 0; i < args[0] && i < maxRegisterArgs; i++)
+    {
+        if (callee.paramRegs[i] >= 0)
+            frameEnd[callee.paramRegs[i]] = regs[args[i + 1]];
+    }
+    calls.push_back({f, pc, regs, retval});
+    f = &callee;
+    code = f->code.data();
+    pc = code;
+    regs = frameEnd;
+    frameEnd = regs + size;
+    retval = 0;
+    DISPATCH();
+}
+do_putchar:
+    regs[pc->a] = std::putchar(regs[pc->b]);
+    NEXT();
+do_getchar:
+    regs[pc->a] = std::getchar();
+    NEXT();
+do_ret:
+    retval = regs[pc->a];
+    NEXT();
+do_exit:
+{
+    if (calls.empty())
+        return retval;
+    // Retour à l'appelant : le résultat va dans la destination de son instruction d'appel
+    const Activation &caller = calls.back();
+    int32_t result = retval;
+    f = caller.function;
+    code = f->code.data();
+    pc = caller.callPc;
+    regs = caller.regs;
+    frameEnd = regs + f->initialRegs.size();
+    retval = caller.retval;
+    calls.pop_back();
+    regs[pc->a] = result;
+    NEXT();
+}
+
+#undef BINARY
+#undef NEXT
+#undef DISPATCH
+}
+
+} // namespace
+
+int run_module(const Module &module, ostream *stats)
+{
+    auto start = std::chrono::steady_clock::now();
+    Program prog;
+    map<string, int> functionIndex;
+    for (const auto &pair : module)
+    {
+        functionIndex[pair.first] = prog.functions.size();
+        prog.functions.emplace_back();
+    }
+    auto mainIt = functionIndex.find("main");
+    if (mainIt == functionIndex.end())
+        throw std::runtime_error("exécution impossible : pas de fonction main");
+    for (const auto &pair : module)
+    {
+        Lowering(functionIndex, pair.second, prog.functions[functionIndex[pair.first]]).lower();
+    }
+
+    prog.valueStack.reset(new int32_t[valueStackSize]);
+    prog.stackEnd = prog.valueStack.get() + valueStackSize;
+    Function &mainFunction = prog.functions[mainIt->second];
+    if (stats)
+    {
+        size_t instructions = 0;
+        for (const Function &f : prog.functions)
+            instructions += f.code.size();
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        *stats << "interpréteur : " << prog.functions.size() << " fonctions, " << instructions
+               << " instructions de bytecode, " << elapsed.count() << " µs avant la première instruction" << std::endl;
+    }
+    std::memcpy(prog.valueStack.get(), mainFunction.initialRegs.data(), mainFunction.initialRegs.size() * sizeof(int32_t));
+    if (!stats)
+        return execute<false>(prog, mainFunction, prog.valueStack.get());
+
+    // Nombre d'instructions exécutées : permet de mesurer l'effet d'une passe indépendamment de la machine
+    int32_t result = execute<true>(prog, mainFunction, prog.valueStack.get());
+    *stats << "interpréteur : " << prog.executed << " instructions de bytecode exécutées" << std::endl;
+    return result;
+}
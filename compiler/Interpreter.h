@@ -0,0 +1,20 @@
+// INTERPRETER.H : Exécution directe de l'IR, sans assembleur ni éditeur de liens (ifcc --run)
+// Chaque CFG est traduit en un bytecode compact à registres : une instruction = un opcode et trois
+// opérandes entiers (registres, constante ou cible de saut), les variables "!N" et les constantes
+// devenant des registres d'un cadre d'activation. Le bytecode est exécuté par un interpréteur
+// "direct-threaded" : chaque instruction contient l'adresse du code qui l'exécute, et l'on passe
+// d'une instruction à la suivante par un goto calculé (extension GNU, supportée par gcc et clang).
+// putchar et getchar sont ceux de la bibliothèque C de l'hôte : la sortie est identique à celle
+// du programme compilé, y compris l'arrêt par SIGFPE sur une division par zéro.
+#ifndef INTERPRETER_H
+#define INTERPRETER_H
+
+#include "IR.h"
+
+/** Exécute la fonction main du module et retourne sa valeur de retour (le code de sortie du programme)
+    Si stats n'est pas nul, y écrit la taille du bytecode et le temps de traduction avant l'exécution,
+    puis le nombre d'instructions exécutées.
+    Lève std::runtime_error si le module ne peut pas être exécuté (pas de main, appel d'une fonction inconnue, phi) */
+int run_module(const Module &module, ostream *stats = nullptr);
+
+#endif
@@ -0,0 +1,461 @@
+// JIT.CPP : Traduction de l'IR en code machine x86-64 et exécution en mémoire (voir JIT.h)
+// Conventions du code produit :
+//   - cadre classique (push %rbp ; mov %rsp, %rbp ; sub $N, %rsp), N multiple de 16 : la pile reste
+//     alignée aux appels comme l'exige l'ABI System V
+//   - le cadre est mis à zéro au prologue (rep stosq) : une variable lue avant d'être écrite vaut 0,
+//     comme dans l'interpréteur, ce qui rend les deux moteurs comparables même sur ce cas indéfini
+//   - case 0 du cadre = valeur de retour (écrite par ret, relue à la sortie)
+//   - les paramètres reçus dans %edi... (ou w0-w7 pour l'IR produit en mode ARM) sont rangés dans
+//     leur case dès le prologue ; à partir du 7e, ils sont lus sur la pile de l'appelant
+//   - / et % utilisent idivl : même SIGFPE que le programme compilé sur une division par zéro
+
+#include "JIT.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__linux__) || defined(__APPLE__))
+#include <sys/mman.h>
+#include <unistd.h>
+#define JIT_SUPPORTED 1
+#endif
+
+namespace
+{
+
+// Numéros des registres dans l'encodage x86-64
+enum Reg : uint8_t
+{
+    EAX = 0,
+    ECX = 1,
+    EDX = 2,
+    ESI = 6,
+    EDI = 7,
+    R8 = 8,
+    R9 = 9,
+    R10 = 10,
+    R11 = 11
+};
+
+// Registres des 6 premiers arguments (System V)
+static const Reg argumentRegs[] = {EDI, ESI, EDX, ECX, R8, R9};
+
+// Code machine de tout le module, avec les références à résoudre une fois les adresses connues
+class CodeBuffer
+{
+public:
+    vector<uint8_t> bytes;
+
+    size_t pos() const { return bytes.size(); }
+
+    void emit(std::initializer_list<uint8_t> list) { bytes.insert(bytes.end(), list); }
+
+    void emit_u32(uint32_t v)
+    {
+        for (int i = 0; i < 4; i++)
+            bytes.push_back((v >> (8 * i)) & 0xff);
+    }
+
+    void emit_u64(uint64_t v)
+    {
+        for (int i = 0; i < 8; i++)
+            bytes.push_back((v >> (8 * i)) & 0xff);
+    }
+
+    // Écrit le déplacement relatif (rel32) situé en at pour qu'il désigne target
+    void patch_rel32(size_t at, size_t target)
+    {
+        int32_t rel = (int32_t)((int64_t)target - (int64_t)(at + 4));
+        std::memcpy(&bytes[at], &rel, 4);
+    }
+};
+
+struct CallFixup
+{
+    size_t at;      // position du rel32
+    string callee;  // fonction appelée
+};
+
+class FunctionCompiler
+{
+public:
+    FunctionCompiler(const CFG *cfg, const Module &module, CodeBuffer &buf, vector<CallFixup> &calls)
+        : cfg(cfg), module(module), buf(buf), calls(calls) {}
+
+    void compile()
+    {
+        vector<BasicBlock *> blocks = cfg->compute_rpo();
+        assign_slots(blocks);
+        emit_prologue();
+
+        map<BasicBlock *, size_t> start;
+        vector<std::pair<size_t, BasicBlock *>> jumps;
+        for (size_t i = 0; i < blocks.size(); i++)
+        {
+            BasicBlock *bb = blocks[i];
+            start[bb] = buf.pos();
+            for (IRInstr *instr : bb->instrs)
+                compile_instr(instr);
+
+            BasicBlock *next = i + 1 < blocks.size() ? blocks[i + 1] : nullptr;
+            if (!bb->exit_true)
+            {
+                emit_epilogue();
+                continue;
+            }
+            if (bb->exit_false && bb->exit_false != bb->exit_true)
+            {
+                // test %eax, %eax ; jne vrai ; jmp faux (omis si faux est le bloc suivant)
+                load(EAX, bb->test_var_name);
+                buf.emit({0x85, 0xC0, 0x0F, 0x85});
+                jumps.push_back({buf.pos(), bb->exit_true});
+                buf.emit_u32(0);
+                if (bb->exit_false != next)
+                {
+                    buf.emit({0xE9});
+                    jumps.push_back({buf.pos(), bb->exit_false});
+                    buf.emit_u32(0);
+                }
+            }
+            else if (bb->exit_true != next)
+            {
+                buf.emit({0xE9});
+                jumps.push_back({buf.pos(), bb->exit_true});
+                buf.emit_u32(0);
+            }
+        }
+        for (auto &jump : jumps)
+            buf.patch_rel32(jump.first, start[jump.second]);
+    }
+
+private:
+    const CFG *cfg;
+    const Module &module;
+    CodeBuffer &buf;
+    vector<CallFixup> &calls;
+    map<string, int> slots;        // opérande (symbole ou registre de paramètre) -> case du cadre
+    map<int, int> parameterSlots;  // rang du paramètre -> case
+    int slotCount = 1;             // la case 0 est la valeur de retour
+
+    [[noreturn]] void fail(const string &msg)
+    {
+        throw std::runtime_error("JIT de '" + cfg->get_name() + "' : " + msg);
+    }
+
+    static int32_t disp(int slot) { return -4 * (slot + 1); }
+
+    void assign_slot(const string &operand)
+    {
+        if (operand.empty() || IRInstr::is_constant(operand) || slots.count(operand))
+            return;
+        if (IRInstr::is_symbol(operand))
+        {
+            slots[operand] = slotCount++;
+            return;
+        }
+        int arg = IRInstr::argument_index(operand);
+        if (arg < 0)
+            fail("opérande inconnu '" + operand + "'");
+        slots[operand] = slotCount;
+        parameterSlots[arg] = slotCount++;
+    }
+
+    // Toutes les cases sont connues avant le prologue (taille du cadre, paramètres à ranger)
+    void assign_slots(const vector<BasicBlock *> &blocks)
+    {
+        for (BasicBlock *bb : blocks)
+        {
+            for (IRInstr *instr : bb->instrs)
+            {
+                const vector<string> &params = instr->get_params();
+                size_t first = instr->get_op() == IRInstr::call ? 1 : 0;
+                for (size_t i = first; i < params.size(); i++)
+                    assign_slot(params[i]);
+            }
+            if (bb->exit_false)
+                assign_slot(bb->test_var_name);
+        }
+    }
+
+    // mov <disp32>(%rbp), %reg
+    void load_slot(Reg reg, int slot)
+    {
+        if (reg >= R8)
+            buf.emit({0x44});
+        buf.emit({0x8B, (uint8_t)(0x85 | ((reg & 7) << 3))});
+        buf.emit_u32(disp(slot));
+    }
+
+    // mov %reg, <disp32>(%rbp)
+    void store_slot(int slot, Reg reg)
+    {
+        if (reg >= R8)
+            buf.emit({0x44});
+        buf.emit({0x89, (uint8_t)(0x85 | ((reg & 7) << 3))});
+        buf.emit_u32(disp(slot));
+    }
+
+    void load(Reg reg, const string &operand)
+    {
+        if (IRInstr::is_constant(operand))
+        {
+            // mov $imm32, %reg
+            if (reg >= R8)
+                buf.emit({0x41});
+            buf.emit({(uint8_t)(0xB8 + (reg & 7))});
+            buf.emit_u32(IRInstr::constant_value(operand));
+            return;
+        }
+        load_slot(reg, slots.at(operand));
+    }
+
+    void store(const string &operand, Reg reg) { store_slot(slots.at(operand), reg); }
+
+    void emit_prologue()
+    {
+        int frameSize = (slotCount * 4 + 15) & ~15;
+        buf.emit({0x55, 0x48, 0x89, 0xE5});          // push %rbp ; mov %rsp, %rbp
+        buf.emit({0x48, 0x81, 0xEC});                // sub $frameSize, %rsp
+        buf.emit_u32(frameSize);
+
+        // Mise à zéro du cadre ; rep stosq utilise %rdi et %rcx, sauvegardés dans %r10 et %r11
+        buf.emit({0x41, 0x89, 0xFA, 0x41, 0x89, 0xCB}); // mov %edi, %r10d ; mov %ecx, %r11d
+        buf.emit({0x48, 0x89, 0xE7, 0xB9});             // mov %rsp, %rdi ; mov $n, %ecx
+        buf.emit_u32(frameSize / 8);
+        buf.emit({0x31, 0xC0, 0xF3, 0x48, 0xAB});       // xor %eax, %eax ; rep stosq
+
+        for (auto &pair : parameterSlots)
+        {
+            if (pair.first < 6)
+            {
+                Reg reg = argumentRegs[pair.first];
+                store_slot(pair.second, reg == EDI ? R10 : reg == ECX ? R11 : reg);
+                continue;
+            }
+            // Paramètres suivants : empilés par l'appelant, au-dessus de l'adresse de retour
+            buf.emit({0x8B, 0x85});                  // mov 16+8k(%rbp), %eax
+            buf.emit_u32(16 + 8 * (pair.first - 6));
+            store_slot(pair.second, EAX);
+        }
+    }
+
+    void emit_epilogue()
+    {
+        load_slot(EAX, 0);
+        buf.emit({0xC9, 0xC3}); // leave ; ret
+    }
+
+    // %eax = (%eax <cc> %ecx) ; cc = second octet de setcc
+    void emit_compare(uint8_t setcc)
+    {
+        buf.emit({0x39, 0xC8, 0x0F, setcc, 0xC0, 0x0F, 0xB6, 0xC0}); // cmp ; setcc %al ; movzbl %al, %eax
+    }
+
+    void compile_instr(IRInstr *instr)
+    {
+        const vector<string> &p = instr->get_params();
+        switch (instr->get_op())
+        {
+        case IRInstr::ldconst:
+            buf.emit({0xC7, 0x85}); // movl $imm32, disp(%rbp)
+            buf.emit_u32(disp(slots.at(p[0])));
+            buf.emit_u32(IRInstr::constant_value(p[1]));
+            return;
+        case IRInstr::rmem:
+        case IRInstr::wmem:
+        case IRInstr::copy:
+            if (p[0] != p[1])
+            {
+                load(EAX, p[1]);
+                store(p[0], EAX);
+            }
+            return;
+        case IRInstr::not_op:
+            load(EAX, p[1]);
+            buf.emit({0x85, 0xC0, 0x0F, 0x94, 0xC0, 0x0F, 0xB6, 0xC0}); // test ; sete %al ; movzbl
+            store(p[0], EAX);
+            return;
+        case IRInstr::abs_op:
+            load(EAX, p[1]);
+            buf.emit({0x89, 0xC1, 0xF7, 0xD8, 0x0F, 0x4C, 0xC1}); // mov %eax, %ecx ; neg %eax ; cmovl %ecx, %eax
+            store(p[0], EAX);
+            return;
+        case IRInstr::select:
+            load(EAX, p[3]);
+            load(ECX, p[1]);
+            buf.emit({0x85, 0xC9}); // test %ecx, %ecx (mov ne touche pas aux drapeaux)
+            load(ECX, p[2]);
+            buf.emit({0x0F, 0x45, 0xC1}); // cmovne %ecx, %eax
+            store(p[0], EAX);
+            return;
+        case IRInstr::ret:
+            load(EAX, p[0]);
+            store_slot(0, EAX);
+            return;
+        case IRInstr::call:
+            compile_call(p);
+            return;
+        case IRInstr::phi:
+            fail("phi non supporté (la passe out-of-ssa doit être exécutée avant)");
+        default:
+            break;
+        }
+
+        load(EAX, p[1]);
+        load(ECX, p[2]);
+        switch (instr->get_op())
+        {
+        case IRInstr::add:
+            buf.emit({0x01, 0xC8});
+            break;
+        case IRInstr::sub:
+            buf.emit({0x29, 0xC8});
+            break;
+        case IRInstr::mul:
+            buf.emit({0x0F, 0xAF, 0xC1});
+            break;
+        case IRInstr::div:
+            buf.emit({0x99, 0xF7, 0xF9}); // cltd ; idivl %ecx
+            break;
+        case IRInstr::mod:
+            buf.emit({0x99, 0xF7, 0xF9, 0x89, 0xD0}); // cltd ; idivl %ecx ; mov %edx, %eax
+            break;
+        case IRInstr::bit_and:
+            buf.emit({0x21, 0xC8});
+            break;
+        case IRInstr::bit_or:
+            buf.emit({0x09, 0xC8});
+            break;
+        case IRInstr::bit_xor:
+            buf.emit({0x31, 0xC8});
+            break;
+        case IRInstr::cmp_eq:
+            emit_compare(0x94);
+            break;
+        case IRInstr::cmp_ne:
+            emit_compare(0x95);
+            break;
+        case IRInstr::cmp_lt:
+            emit_compare(0x9C);
+            break;
+        case IRInstr::cmp_gt:
+            emit_compare(0x9F);
+            break;
+        case IRInstr::cmp_le:
+            emit_compare(0x9E);
+            break;
+        case IRInstr::cmp_ge:
+            emit_compare(0x9D);
+            break;
+        case IRInstr::logical_and:
+            // test ; setne %al ; test ; setne %cl ; and %cl, %al ; movzbl %al, %eax
+            buf.emit({0x85, 0xC0, 0x0F, 0x95, 0xC0, 0x85, 0xC9, 0x0F, 0x95, 0xC1, 0x20, 0xC8, 0x0F, 0xB6, 0xC0});
+            break;
+        case IRInstr::logical_or:
+            // or %ecx, %eax ; setne %al ; movzbl %al, %eax
+            buf.emit({0x09, 0xC8, 0x0F, 0x95, 0xC0, 0x0F, 0xB6, 0xC0});
+            break;
+        default:
+            fail("opération " + IRInstr::op_name(instr->get_op()) + " non supportée");
+        }
+        store(p[0], EAX);
+    }
+
+    void compile_call(const vector<string> &p)
+    {
+        const string &callee = p[0];
+        size_t argc = p.size() - 2;
+
+        // Arguments au-delà du 6e : empilés du dernier au premier, pile réalignée sur 16 octets
+        size_t stacked = argc > 6 ? argc - 6 : 0;
+        size_t stackBytes = 8 * (stacked + stacked % 2);
+        if (stacked % 2)
+            buf.emit({0x48, 0x83, 0xEC, 0x08}); // sub $8, %rsp
+        for (size_t i = argc; i > 6; i--)
+        {
+            load(EAX, p[i + 1]);
+            buf.emit({0x50}); // push %rax
+        }
+        for (size_t i = 0; i < argc && i < 6; i++)
+            load(argumentRegs[i], p[i + 2]);
+
+        if (module.count(callee))
+        {
+            buf.emit({0xE8}); // call rel32, résolu une fois toutes les fonctions placées
+            calls.push_back({buf.pos(), callee});
+            buf.emit_u32(0);
+        }
+        else
+        {
+            void *address = nullptr;
+            if (callee == "putchar")
+                address = (void *)&std::putchar;
+            else if (callee == "getchar")
+                address = (void *)&std::getchar;
+            else
+                fail("appel de la fonction non définie '" + callee + "'");
+            buf.emit({0x48, 0xB8}); // movabs $adresse, %rax ; call *%rax
+            buf.emit_u64((uint64_t)(uintptr_t)address);
+            buf.emit({0xFF, 0xD0});
+        }
+
+        if (stackBytes)
+        {
+            buf.emit({0x48, 0x81, 0xC4}); // add $stackBytes, %rsp
+            buf.emit_u32(stackBytes);
+        }
+        store(p[1], EAX);
+    }
+};
+
+} // namespace
+
+int jit_run_module(const Module &module, ostream *stats)
+{
+#ifdef JIT_SUPPORTED
+    auto start = std::chrono::steady_clock::now();
+    if (!module.count("main"))
+        throw std::runtime_error("exécution impossible : pas de fonction main");
+
+    CodeBuffer buf;
+    vector<CallFixup> calls;
+    map<string, size_t> entry;
+    for (const auto &pair : module)
+    {
+        entry[pair.first] = buf.pos();
+        FunctionCompiler(pair.second, module, buf, calls).compile();
+    }
+    for (const CallFixup &call : calls)
+        buf.patch_rel32(call.at, entry[call.callee]);
+
+    // Zone écrite puis rendue exécutable : jamais inscriptible et exécutable à la fois
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+    size_t size = (buf.bytes.size() + pageSize - 1) / pageSize * pageSize;
+    void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+        throw std::runtime_error("JIT : allocation de la mémoire exécutable impossible");
+    std::memcpy(memory, buf.bytes.data(), buf.bytes.size());
+    if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0)
+    {
+        munmap(memory, size);
+        throw std::runtime_error("JIT : la mémoire ne peut pas être rendue exécutable");
+    }
+
+    auto mainFunction = (int (*)())((uint8_t *)memory + entry["main"]);
+    if (stats)
+    {
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        *stats << "jit : " << module.size() << " fonctions, " << buf.bytes.size() << " octets de code, "
+               << elapsed.count() << " µs avant la première instruction" << std::endl;
+    }
+    int status = mainFunction();
+    munmap(memory, size);
+    return status;
+#else
+    (void)module;
+    (void)stats;
+    throw std::runtime_error("le JIT n'est disponible que sur un hôte x86-64 (utiliser --run)");
+#endif
+}
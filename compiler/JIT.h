@@ -0,0 +1,19 @@
+// JIT.H : Compilation à la volée de l'IR en code machine x86-64 (ifcc --run=jit)
+// Chaque CFG est traduit directement en octets de code machine, sans passer par l'assembleur :
+// même modèle que gen_asm (une case de pile par variable, calculs dans %eax et %ecx), mais encodé
+// en mémoire. Le code de toutes les fonctions est copié dans une zone obtenue par mmap, rendue
+// exécutable (et non inscriptible) avant l'appel de main. Les appels entre fonctions sont des
+// call relatifs résolus après l'émission ; putchar et getchar sont appelés à leur adresse dans
+// le processus. Aucun fichier temporaire, ni assembleur, ni éditeur de liens.
+#ifndef JIT_H
+#define JIT_H
+
+#include "IR.h"
+
+/** Compile le module, exécute main et retourne sa valeur de retour (le code de sortie du programme)
+    Si stats n'est pas nul, y écrit la taille du code et le temps écoulé jusqu'à la première instruction.
+    Lève std::runtime_error si le module ne peut pas être compilé (pas de main, fonction inconnue, phi,
+    hôte autre que x86-64) */
+int jit_run_module(const Module &module, ostream *stats = nullptr);
+
+#endif
@@ -0,0 +1,251 @@
+// LLVMEMITTER.CPP : Traduction de l'IR en LLVM IR textuel (voir LLVMEmitter.h)
+// L'IR arrive en SSA (passe mem2reg) : chaque valeur "!N" devient le registre LLVM %vN, sans aucun
+// accès mémoire, ce qui rend le .ll indépendant de la syntaxe des pointeurs (typés ou opaques)
+// selon la version de LLVM.
+//   - copy (et rmem/wmem restants) et ldconst ne produisent rien : la destination est remplacée
+//     par sa source ou par la constante partout où elle est lue
+//   - les comparaisons, !, && et || produisent un i1 (icmp) étendu en i32 (zext)
+//   - / et % deviennent sdiv et srem : une division par zéro est un comportement indéfini pour
+//     LLVM comme en C (le back-end natif, lui, lève SIGFPE)
+//   - ret fixe la valeur renvoyée par le bloc de sortie qui le contient (0 s'il n'y en a pas)
+//   - les fonctions appelées mais non définies (putchar, getchar) sont déclarées à la fin
+
+#include "LLVMEmitter.h"
+#include "DefFonction.h"
+#include <set>
+#include <stdexcept>
+
+using std::endl;
+
+namespace
+{
+
+class FunctionEmitter
+{
+public:
+    FunctionEmitter(const CFG *cfg, const Module &module, ostream &o, map<string, size_t> &externals)
+        : cfg(cfg), module(module), o(o), externals(externals) {}
+
+    void emit()
+    {
+        blocks = cfg->compute_rpo();
+        for (BasicBlock *bb : blocks)
+            emitted.insert(bb->label);
+        collect_values();
+
+        paramCount = cfg->ast ? cfg->ast->getParams().size() : 0;
+        o << "define i32 @" << cfg->get_name() << "(";
+        for (size_t i = 0; i < paramCount; i++)
+            o << (i ? ", " : "") << "i32 %arg" << i;
+        o << ") {" << endl;
+
+        for (size_t i = 0; i < blocks.size(); i++)
+        {
+            if (i)
+                o << endl;
+            emit_block(blocks[i]);
+        }
+        o << "}" << endl;
+    }
+
+private:
+    const CFG *cfg;
+    const Module &module;
+    ostream &o;
+    map<string, size_t> &externals; // fonction externe -> nombre d'arguments
+    vector<BasicBlock *> blocks;
+    std::set<string> emitted;       // étiquettes des blocs atteignables
+    std::set<string> defined;       // valeurs définies dans la fonction
+    map<string, string> alias;      // valeur -> opérande qui la remplace (copies, constantes)
+    size_t paramCount = 0;
+
+    [[noreturn]] void fail(const string &msg)
+    {
+        throw std::runtime_error("LLVM IR de '" + cfg->get_name() + "' : " + msg);
+    }
+
+    void collect_values()
+    {
+        for (BasicBlock *bb : blocks)
+        {
+            for (IRInstr *instr : bb->instrs)
+            {
+                string dest = instr->get_dest();
+                if (!IRInstr::is_symbol(dest))
+                    continue;
+                if (!defined.insert(dest).second)
+                    fail(dest + " est défini plusieurs fois (l'IR doit être en SSA, voir la passe mem2reg)");
+                IRInstr::Operation op = instr->get_op();
+                if (op == IRInstr::copy || op == IRInstr::rmem || op == IRInstr::wmem || op == IRInstr::ldconst)
+                    alias[dest] = instr->get_params()[1];
+            }
+        }
+    }
+
+    // Opérande LLVM correspondant à un opérande de l'IR
+    string value(const string &operand)
+    {
+        string v = operand;
+        for (size_t steps = 0; alias.count(v); steps++)
+        {
+            if (steps > alias.size())
+                fail("cycle de copies sur " + operand);
+            v = alias[v];
+        }
+        if (IRInstr::is_constant(v))
+            return std::to_string(IRInstr::constant_value(v));
+        if (IRInstr::is_symbol(v))
+            return defined.count(v) ? "%v" + v.substr(1) : "0"; // jamais écrite : 0, comme mem2reg
+        int arg = IRInstr::argument_index(v);
+        if (arg >= 0)
+            return arg < (int)paramCount ? "%arg" + std::to_string(arg) : "0";
+        fail("opérande inconnu '" + operand + "'");
+    }
+
+    static string reg(const string &symbol) { return "%v" + symbol.substr(1); }
+
+    void emit_block(BasicBlock *bb)
+    {
+        o << bb->label << ":" << endl;
+        string retval;
+        for (IRInstr *instr : bb->instrs)
+        {
+            const vector<string> &p = instr->get_params();
+            switch (instr->get_op())
+            {
+            case IRInstr::ldconst:
+            case IRInstr::copy:
+            case IRInstr::rmem:
+            case IRInstr::wmem:
+                break;
+            case IRInstr::phi:
+                emit_phi(p);
+                break;
+            case IRInstr::ret:
+                if (bb->exit_true)
+                    fail("ret hors d'un bloc de sortie (" + bb->label + ")");
+                retval = value(p[0]);
+                break;
+            case IRInstr::call:
+                emit_call(p);
+                break;
+            default:
+                emit_operation(instr->get_op(), p);
+                break;
+            }
+        }
+
+        if (!bb->exit_true)
+            o << "  ret i32 " << (retval.empty() ? "0" : retval) << endl;
+        else if (bb->exit_false && bb->exit_false != bb->exit_true)
+        {
+            o << "  %br." << bb->label << " = icmp ne i32 " << value(bb->test_var_name) << ", 0" << endl;
+            o << "  br i1 %br." << bb->label << ", label %" << bb->exit_true->label
+              << ", label %" << bb->exit_false->label << endl;
+        }
+        else
+            o << "  br label %" << bb->exit_true->label << endl;
+    }
+
+    // Une entrée par prédécesseur atteignable (un arc vrai/faux vers le même bloc n'en fait qu'un)
+    void emit_phi(const vector<string> &p)
+    {
+        o << "  " << reg(p[0]) << " = phi i32 ";
+        std::set<string> seen;
+        bool first = true;
+        for (size_t i = 1; i + 1 < p.size(); i += 2)
+        {
+            if (!emitted.count(p[i + 1]) || !seen.insert(p[i + 1]).second)
+                continue;
+            o << (first ? "" : ", ") << "[ " << value(p[i]) << ", %" << p[i + 1] << " ]";
+            first = false;
+        }
+        o << endl;
+    }
+
+    void emit_call(const vector<string> &p)
+    {
+        const string &callee = p[0];
+        if (!module.count(callee) && !externals.count(callee))
+            externals[callee] = p.size() - 2;
+        o << "  " << reg(p[1]) << " = call i32 @" << callee << "(";
+        for (size_t i = 2; i < p.size(); i++)
+            o << (i > 2 ? ", " : "") << "i32 " << value(p[i]);
+        o << ")" << endl;
+    }
+
+    void emit_operation(IRInstr::Operation op, const vector<string> &p)
+    {
+        static const map<IRInstr::Operation, string> arithmetic = {
+            {IRInstr::add, "add"}, {IRInstr::sub, "sub"}, {IRInstr::mul, "mul"}, {IRInstr::div, "sdiv"},
+            {IRInstr::mod, "srem"}, {IRInstr::bit_and, "and"}, {IRInstr::bit_or, "or"}, {IRInstr::bit_xor, "xor"}};
+        static const map<IRInstr::Operation, string> predicates = {
+            {IRInstr::cmp_eq, "eq"}, {IRInstr::cmp_ne, "ne"}, {IRInstr::cmp_lt, "slt"},
+            {IRInstr::cmp_gt, "sgt"}, {IRInstr::cmp_le, "sle"}, {IRInstr::cmp_ge, "sge"}};
+
+        string dest = reg(p[0]);
+        auto it = arithmetic.find(op);
+        if (it != arithmetic.end())
+        {
+            o << "  " << dest << " = " << it->second << " i32 " << value(p[1]) << ", " << value(p[2]) << endl;
+            return;
+        }
+        if (op == IRInstr::select)
+        {
+            o << "  " << dest << ".c = icmp ne i32 " << value(p[1]) << ", 0" << endl;
+            o << "  " << dest << " = select i1 " << dest << ".c, i32 " << value(p[2]) << ", i32 " << value(p[3]) << endl;
+            return;
+        }
+        if (op == IRInstr::abs_op)
+        {
+            o << "  " << dest << ".n = sub i32 0, " << value(p[1]) << endl;
+            o << "  " << dest << ".c = icmp slt i32 " << value(p[1]) << ", 0" << endl;
+            o << "  " << dest << " = select i1 " << dest << ".c, i32 " << dest << ".n, i32 " << value(p[1]) << endl;
+            return;
+        }
+        auto pred = predicates.find(op);
+        if (pred != predicates.end())
+            o << "  " << dest << ".c = icmp " << pred->second << " i32 " << value(p[1]) << ", " << value(p[2]) << endl;
+        else if (op == IRInstr::not_op)
+            o << "  " << dest << ".c = icmp eq i32 " << value(p[1]) << ", 0" << endl;
+        else if (op == IRInstr::logical_and)
+        {
+            o << "  " << dest << ".a = icmp ne i32 " << value(p[1]) << ", 0" << endl;
+            o << "  " << dest << ".b = icmp ne i32 " << value(p[2]) << ", 0" << endl;
+            o << "  " << dest << ".c = and i1 " << dest << ".a, " << dest << ".b" << endl;
+        }
+        else if (op == IRInstr::logical_or)
+        {
+            o << "  " << dest << ".o = or i32 " << value(p[1]) << ", " << value(p[2]) << endl;
+            o << "  " << dest << ".c = icmp ne i32 " << dest << ".o, 0" << endl;
+        }
+        else
+            fail("opération " + IRInstr::op_name(op) + " non supportée");
+        o << "  " << dest << " = zext i1 " << dest << ".c to i32" << endl;
+    }
+};
+
+} // namespace
+
+void gen_llvm_module(ostream &o, const Module &module)
+{
+    o << "; ModuleID = 'ifcc'" << endl;
+    o << "source_filename = \"ifcc\"" << endl;
+
+    map<string, size_t> externals;
+    for (const auto &pair : module)
+    {
+        o << endl;
+        FunctionEmitter(pair.second, module, o, externals).emit();
+    }
+
+    if (!externals.empty())
+        o << endl;
+    for (const auto &pair : externals)
+    {
+        o << "declare i32 @" << pair.first << "(";
+        for (size_t i = 0; i < pair.second; i++)
+            o << (i ? ", " : "") << "i32";
+        o << ")" << endl;
+    }
+}
@@ -0,0 +1,16 @@
+// LLVMEMITTER.H : Back-end LLVM IR textuel (ifcc --emit=llvm)
+// Traduit le module en un fichier .ll que clang (ou opt + llc) peut optimiser et compiler :
+//   ifcc --emit=llvm prog.c > prog.ll && clang -O2 prog.ll -o prog
+// Les générateurs x86/ARM restent le back-end par défaut ; celui-ci sert quand on préfère la
+// performance du code produit à l'autonomie de la chaîne de compilation.
+#ifndef LLVM_EMITTER_H
+#define LLVM_EMITTER_H
+
+#include "IR.h"
+
+/** Écrit le module en LLVM IR textuel. L'IR doit être en forme SSA (le driver ajoute la passe mem2reg)
+    et chaque ret doit terminer un bloc de sortie, comme le produit VisitorIR.
+    Lève std::runtime_error si ce n'est pas le cas. */
+void gen_llvm_module(ostream &o, const Module &module);
+
+#endif
@@ -0,0 +1,212 @@
+// LVN.CPP : Numérotation locale des valeurs (passe "lvn")
+// Dans chaque BasicBlock, chaque valeur calculée reçoit un numéro : deux opérations identiques sur
+// les mêmes numéros (a*b puis a*b, ou b*a : les opérandes des opérations commutatives sont triés)
+// calculent la même valeur. La seconde est remplacée par une copie du premier résultat, et les
+// instructions suivantes du bloc lisent directement ce premier résultat.
+// Fonctionne sur l'IR construit par VisitorIR comme sur la forme SSA :
+//   - "wmem !v, x" donne à la variable v le numéro de x ; une relecture "rmem t, !v" d'une variable
+//     non modifiée entre-temps réutilise la valeur déjà lue ou écrite
+//   - un appel de fonction est une barrière : les valeurs connues des variables sont oubliées après
+//     lui, et un appel n'est jamais considéré comme redondant
+//   - sauf l'appel d'une fonction pure (voir Purity) : il ne touche pas à la mémoire, et un second
+//     appel avec les mêmes arguments devient une copie du premier résultat
+// Les copies devenues inutiles sont laissées à l'élimination du code mort.
+
+#include "Passes.h"
+#include <set>
+
+namespace
+{
+
+class LVNPass : public FunctionPass
+{
+public:
+    string get_name() const override { return "lvn"; }
+    bool preserves_cfg() const override { return true; }
+
+    bool run_on_function(CFG &cfg, AnalysisManager &am) override
+    {
+        purity = &am.get_purity();
+        bool changed = false;
+        for (BasicBlock *bb : cfg.get_bbs())
+            changed |= number_block(bb);
+        return changed;
+    }
+
+private:
+    int nextNumber = 0;
+    map<string, int> numberOf;      // opérande -> numéro de sa valeur actuelle
+    map<string, int> expressions;   // "op n1 n2" -> numéro de la valeur calculée
+    map<int, string> holder;        // numéro -> premier opérande qui contient cette valeur
+    map<string, string> forward;    // résultat remplacé -> opérande qui contient la même valeur
+    std::set<string> memory;        // variables lues ou écrites par rmem/wmem
+    const Purity *purity = nullptr;
+
+    int fresh() { return nextNumber++; }
+
+    // Numéro actuel d'un opérande, -1 s'il n'en a pas (ou plus, après un appel)
+    int current(const string &operand) const
+    {
+        auto it = numberOf.find(operand);
+        return it == numberOf.end() ? -1 : it->second;
+    }
+
+    int number(const string &operand)
+    {
+        auto it = numberOf.find(operand);
+        if (it != numberOf.end())
+            return it->second;
+        int n = IRInstr::is_constant(operand) ? number_of_expression("ldconst " + std::to_string(IRInstr::constant_value(operand)))
+                                               : fresh();
+        numberOf[operand] = n;
+        return n;
+    }
+
+    int number_of_expression(const string &key)
+    {
+        auto it = expressions.find(key);
+        if (it != expressions.end())
+            return it->second;
+        int n = fresh();
+        expressions[key] = n;
+        return n;
+    }
+
+    // Opérande qui contient encore la valeur n (son numéro n'a pas changé depuis), "" sinon
+    string valid_holder(int n)
+    {
+        auto it = holder.find(n);
+        if (it == holder.end() || current(it->second) != n)
+            return "";
+        return it->second;
+    }
+
+    // dest reçoit la valeur n ; la première variable qui la contient en devient le détenteur
+    void define(const string &dest, int n)
+    {
+        numberOf[dest] = n;
+        forward.erase(dest);
+        if (valid_holder(n).empty())
+            holder[n] = dest;
+    }
+
+    // Un opérande dont l'instruction a été remplacée est lu depuis le premier résultat
+    void forward_operand(string &operand)
+    {
+        auto it = forward.find(operand);
+        if (it == forward.end())
+            return;
+        if (current(it->second) == current(operand))
+            operand = it->second;
+    }
+
+    bool number_block(BasicBlock *bb)
+    {
+        numberOf.clear();
+        expressions.clear();
+        holder.clear();
+        forward.clear();
+        memory.clear();
+
+        bool changed = false;
+        for (IRInstr *instr : bb->instrs)
+        {
+            vector<string> &p = instr->get_params();
+            IRInstr::Operation op = instr->get_op();
+
+            for (size_t i : instr->get_use_indices())
+            {
+                if (op != IRInstr::rmem && op != IRInstr::phi)
+                    forward_operand(p[i]);
+            }
+
+            switch (op)
+            {
+            case IRInstr::ret:
+                break;
+            case IRInstr::phi:
+                define(p[0], fresh());
+                break;
+            case IRInstr::call:
+                if (purity->is_pure_call(instr))
+                {
+                    string key = "call " + p[0];
+                    for (size_t i : instr->get_use_indices())
+                        key += " " + std::to_string(number(p[i]));
+                    changed |= replace_if_redundant(instr, number_of_expression(key));
+                    break;
+                }
+                define(p[1], fresh());
+                forget_memory();
+                break;
+            case IRInstr::copy:
+            case IRInstr::wmem:
+                if (op == IRInstr::wmem)
+                    memory.insert(p[0]);
+                define(p[0], number(p[1]));
+                break;
+            case IRInstr::rmem:
+                memory.insert(p[1]);
+                changed |= replace_if_redundant(instr, number(p[1]));
+                break;
+            case IRInstr::ldconst:
+                changed |= replace_if_redundant(instr, number(p[1]));
+                break;
+            default:
+            {
+                vector<size_t> uses = instr->get_use_indices();
+                vector<int> operands;
+                for (size_t i : uses)
+                    operands.push_back(number(p[i]));
+                if (IRInstr::is_commutative(op) && operands.size() == 2 && operands[0] > operands[1])
+                    std::swap(operands[0], operands[1]);
+                string key = IRInstr::op_name(op);
+                for (int n : operands)
+                    key += " " + std::to_string(n);
+                changed |= replace_if_redundant(instr, number_of_expression(key));
+                break;
+            }
+            }
+        }
+
+        if (bb->exit_false)
+            forward_operand(bb->test_var_name);
+        return changed;
+    }
+
+    // Si la valeur n est déjà dans un opérande, l'instruction devient une copie de cet opérande
+    bool replace_if_redundant(IRInstr *instr, int n)
+    {
+        string dest = instr->get_dest();
+        string existing = valid_holder(n);
+        bool reread = instr->get_op() == IRInstr::rmem && existing == instr->get_params()[1];
+        if (existing.empty() || existing == dest || reread || !PassManager::consume_fuel(get_name()))
+        {
+            define(dest, n);
+            // La valeur d'une variable est désormais aussi dans un temporaire : c'est lui que les
+            // relectures suivantes réutiliseront
+            if (reread)
+                holder[n] = dest;
+            return false;
+        }
+        instr->set_op(IRInstr::copy);
+        instr->get_params() = {dest, existing};
+        define(dest, n);
+        forward[dest] = existing;
+        return true;
+    }
+
+    // Après un appel, le contenu des variables en mémoire est inconnu
+    void forget_memory()
+    {
+        for (const string &var : memory)
+            numberOf.erase(var);
+    }
+};
+
+} // namespace
+
+FunctionPass *createLVNPass()
+{
+    return new LVNPass();
+}
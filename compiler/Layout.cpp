@@ -0,0 +1,151 @@
+// LAYOUT.CPP : Placement des blocs (passe "layout", dernière passe de -O1 et -O2)
+// gen_asm émet les blocs dans l'ordre de cfg.get_bbs() et omet le saut vers le bloc émis juste après :
+// la passe range les blocs pour que le chemin le plus probable se lise sans saut. Chaînes gloutonnes
+// guidées par BranchProbability (mise en cache par l'AnalysisManager) :
+//   - un bloc n'est prêt qu'une fois placés tous ses prédécesseurs par un arc avant (une jonction reste
+//     après ses branches) : chaque bloc compte ses arcs avant restants, décrémentés à chaque placement
+//   - après chaque bloc vient son successeur prêt le plus probable ; sinon la chaîne s'arrête et la
+//     suivante commence au bloc prêt le plus fréquent (à égalité, le premier en reverse post-order),
+//     tiré d'un tas plutôt que d'un parcours de tous les blocs
+// Les blocs froids sont placés de la même façon après les blocs chauds et marqués (bb->cold) : gen_asm
+// les émet après l'épilogue, dans la section .text.unlikely. Sans cette passe (-O0), les blocs sont
+// émis dans l'ordre de construction. Avec --remarks, le nombre de blocs froids est affiché.
+
+#include "Passes.h"
+#include <queue>
+#include <set>
+
+namespace
+{
+
+class LayoutPass : public FunctionPass
+{
+public:
+    string get_name() const override { return "layout"; }
+    bool preserves_cfg() const override { return true; }
+
+    bool run_on_function(CFG &cfg, AnalysisManager &am) override
+    {
+        if (cfg.get_bbs().empty())
+            return false;
+        domTree = &am.get_dominators(&cfg);
+        probability = &am.get_branch_probability(&cfg);
+        const vector<BasicBlock *> &rpo = domTree->get_rpo();
+        index.clear();
+        for (size_t i = 0; i < rpo.size(); i++)
+            index[rpo[i]] = i;
+
+        // Arcs avant, dans la même partie (chaude ou froide), venant de prédécesseurs encore à placer
+        pending.clear();
+        map<BasicBlock *, vector<BasicBlock *>> preds = cfg.compute_predecessors();
+        for (BasicBlock *bb : rpo)
+        {
+            std::set<BasicBlock *> forward;
+            for (BasicBlock *pred : preds[bb])
+            {
+                if (is_forward(pred, bb))
+                    forward.insert(pred);
+            }
+            pending[bb] = forward.size();
+        }
+
+        placed.clear();
+        vector<BasicBlock *> hot = place(false);
+        vector<BasicBlock *> cold = place(true);
+        if (hot.empty() || hot[0] != cfg.get_entry() || !PassManager::consume_fuel(get_name()))
+            return false;
+
+        // Nouvel ordre : blocs chauds, blocs froids, puis les blocs inatteignables (refusés par gen_asm)
+        vector<BasicBlock *> order = hot;
+        order.insert(order.end(), cold.begin(), cold.end());
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            if (!placed.count(bb))
+                order.push_back(bb);
+        }
+        bool changed = order != cfg.get_bbs();
+        for (BasicBlock *bb : order)
+        {
+            bool isCold = probability->is_cold(bb) && placed.count(bb);
+            changed |= bb->cold != isCold;
+            bb->cold = isCold;
+        }
+        cfg.get_bbs() = order;
+        if (!cold.empty())
+            PassManager::remark(get_name(), cfg, std::to_string(cold.size()) + " bloc(s) froid(s) placé(s) dans .text.unlikely");
+        return changed;
+    }
+
+private:
+    const DominatorTree *domTree = nullptr;
+    const BranchProbability *probability = nullptr;
+    map<BasicBlock *, size_t> index;
+    map<BasicBlock *, size_t> pending;
+    std::set<BasicBlock *> placed;
+
+    // Arc avant entre deux blocs de la même partie (un arc retour remonte vers un dominateur)
+    bool is_forward(BasicBlock *from, BasicBlock *to) const
+    {
+        return probability->is_cold(from) == probability->is_cold(to) && !domTree->dominates(to, from);
+    }
+
+    bool ready(BasicBlock *bb, bool coldPart) const
+    {
+        return !placed.count(bb) && probability->is_cold(bb) == coldPart && pending.at(bb) == 0;
+    }
+
+    vector<BasicBlock *> place(bool coldPart)
+    {
+        // Blocs prêts, le plus fréquent d'abord puis le premier en reverse post-order ; une entrée
+        // devenue obsolète (bloc déjà placé) est ignorée au dépilement
+        std::priority_queue<std::pair<double, long>> candidates;
+        auto push = [&](BasicBlock *bb) { candidates.push({probability->get_frequency(bb), -(long)index.at(bb)}); };
+        for (const auto &entry : index)
+        {
+            if (ready(entry.first, coldPart))
+                push(entry.first);
+        }
+
+        const vector<BasicBlock *> &rpo = domTree->get_rpo();
+        vector<BasicBlock *> order;
+        BasicBlock *bb = nullptr;
+        while (true)
+        {
+            while (!bb && !candidates.empty())
+            {
+                BasicBlock *top = rpo[-candidates.top().second];
+                candidates.pop();
+                if (!placed.count(top))
+                    bb = top;
+            }
+            if (!bb)
+                break;
+            placed.insert(bb);
+            order.push_back(bb);
+
+            BasicBlock *next = nullptr;
+            for (BasicBlock *succ : bb->get_successors())
+            {
+                if (!index.count(succ) || placed.count(succ))
+                    continue;
+                if (is_forward(bb, succ) && --pending[succ] == 0 && probability->is_cold(succ) == coldPart)
+                    push(succ);
+                if (!ready(succ, coldPart))
+                    continue;
+                double p = probability->get_edge_probability(bb, succ);
+                double best = next ? probability->get_edge_probability(bb, next) : -1;
+                if (p > best || (p == best && index[succ] < index[next]))
+                    next = succ;
+            }
+            bb = next;
+        }
+        return order;
+    }
+};
+
+} // namespace
+
+FunctionPass *createLayoutPass()
+{
+    return new LayoutPass();
+}
@@ -0,0 +1,281 @@
+// MEM2REG.CPP : Construction de la forme SSA (passe "mem2reg")
+// VisitorIR range chaque variable dans un emplacement de pile, lu par rmem et écrit par wmem.
+// Le langage n'a ni pointeurs ni tableaux : aucune adresse de variable ne peut fuir, donc toutes les
+// variables (paramètres compris) et tous les temporaires sont promus en valeurs SSA, définies une seule fois :
+//   - "rmem t, !v" disparaît : les lectures de t utilisent directement la valeur courante de v
+//   - "wmem !v, x" disparaît : x devient la valeur courante de v
+//     (si x est un registre physique, comme un paramètre reçu dans %edi, il est recopié par un copy)
+//   - un phi est placé sur la frontière de dominance itérée des blocs qui définissent v,
+//     seulement là où v est vivante (SSA élaguée, à l'aide de Liveness)
+//   - le renommage parcourt l'arbre des dominateurs (algorithme de Cytron et al.)
+// Une variable lue avant toute écriture vaut 0 (un ldconst ajouté au début du bloc d'entrée).
+// Les valeurs SSA restent des "!N" (un emplacement de pile chacune à la génération de code) ;
+// la passe out-of-ssa remplace les phi par des copies avant l'émission de l'assembleur.
+
+#include "Passes.h"
+#include <algorithm>
+
+namespace
+{
+
+class Mem2RegPass : public FunctionPass
+{
+public:
+    string get_name() const override { return "mem2reg"; }
+
+    bool run_on_function(CFG &cfg, AnalysisManager &am) override
+    {
+        // Une fonction déjà en SSA n'est pas reconstruite
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            for (IRInstr *instr : bb->instrs)
+            {
+                if (instr->get_op() == IRInstr::phi)
+                    return false;
+            }
+        }
+        if (cfg.get_bbs().empty() || !PassManager::consume_fuel(get_name()))
+            return false;
+
+        prepare_cfg(cfg);
+        am.invalidate(&cfg);
+
+        init_symbols(cfg);
+        place_phis(cfg, am);
+        rename(cfg, am.get_dominators(&cfg));
+        return true;
+    }
+
+private:
+    size_t symbolCount = 0;
+    vector<Type> typeOf;
+    vector<vector<string>> valueStack; // symbole d'origine -> valeurs SSA successives (sommet = valeur courante)
+    vector<bool> nameTaken;            // le nom d'origine "!N" a déjà été donné à une définition
+    map<IRInstr *, int> phiSymbol;     // phi inséré -> symbole d'origine
+    string undefValue;                 // valeur des variables lues avant d'être écrites
+
+    // Le renommage ne parcourt que les blocs atteignables, et l'entrée ne doit pas avoir de
+    // prédécesseur (un phi y serait sans valeur initiale) : on ajoute un bloc d'entrée si besoin
+    void prepare_cfg(CFG &cfg)
+    {
+        cfg.remove_unreachable_bbs();
+        BasicBlock *entry = cfg.get_entry();
+        if (cfg.compute_predecessors()[entry].empty())
+            return;
+        BasicBlock *newEntry = new BasicBlock(&cfg, cfg.new_BB_name());
+        newEntry->exit_true = entry;
+        vector<BasicBlock *> &bbs = cfg.get_bbs();
+        std::rotate(bbs.begin(), bbs.end() - 1, bbs.end());
+    }
+
+    void init_symbols(CFG &cfg)
+    {
+        symbolCount = cfg.get_symbol_count();
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            for (IRInstr *instr : bb->instrs)
+            {
+                for (const string &p : instr->get_params())
+                    symbolCount = std::max(symbolCount, (size_t)(symbol_id(p) + 1));
+            }
+            symbolCount = std::max(symbolCount, (size_t)(symbol_id(bb->test_var_name) + 1));
+        }
+
+        typeOf.assign(symbolCount, Type(INT));
+        const map<string, Type> &types = cfg.get_symbol_types();
+        for (const auto &pair : cfg.get_symbol_indices())
+        {
+            auto it = types.find(pair.first);
+            if (it != types.end())
+                typeOf[pair.second] = it->second;
+        }
+        valueStack.assign(symbolCount, {});
+        nameTaken.assign(symbolCount, false);
+        phiSymbol.clear();
+        undefValue.clear();
+    }
+
+    // Un phi pour v en tête de chaque bloc de la frontière itérée des définitions de v où v est vivante
+    void place_phis(CFG &cfg, AnalysisManager &am)
+    {
+        DominanceFrontier &frontier = am.get_dominance_frontier(&cfg);
+        Liveness &liveness = am.get_liveness(&cfg);
+
+        vector<vector<BasicBlock *>> defBlocks(symbolCount);
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            for (IRInstr *instr : bb->instrs)
+            {
+                int d = symbol_id(instr->get_dest());
+                if (d >= 0 && (defBlocks[d].empty() || defBlocks[d].back() != bb))
+                    defBlocks[d].push_back(bb);
+            }
+        }
+
+        map<BasicBlock *, vector<IRInstr *>> phis;
+        for (size_t s = 0; s < symbolCount; s++)
+        {
+            if (defBlocks[s].empty())
+                continue;
+            string var = "!" + std::to_string(s);
+            for (BasicBlock *bb : frontier.get_iterated_frontier(defBlocks[s]))
+            {
+                if (!liveness.is_live_in(bb, var))
+                    continue;
+                IRInstr *phi = new IRInstr(bb, IRInstr::phi, typeOf[s], {var});
+                phis[bb].push_back(phi);
+                phiSymbol[phi] = s;
+            }
+        }
+        for (auto &pair : phis)
+        {
+            vector<IRInstr *> &instrs = pair.first->instrs;
+            instrs.insert(instrs.begin(), pair.second.begin(), pair.second.end());
+        }
+    }
+
+    // Nouveau nom pour une définition de s : le nom d'origine pour la première, un nouveau temporaire ensuite
+    string new_name(CFG &cfg, int s)
+    {
+        if (!nameTaken[s])
+        {
+            nameTaken[s] = true;
+            return "!" + std::to_string(s);
+        }
+        return cfg.create_new_tempvar(typeOf[s]);
+    }
+
+    string current_value(CFG &cfg, int s)
+    {
+        if (!valueStack[s].empty())
+            return valueStack[s].back();
+        if (undefValue.empty())
+            undefValue = cfg.create_new_tempvar(Type(INT));
+        return undefValue;
+    }
+
+    void rename_operand(CFG &cfg, string &operand)
+    {
+        int s = symbol_id(operand);
+        if (s >= 0 && s < (int)symbolCount)
+            operand = current_value(cfg, s);
+    }
+
+    // Parcours en profondeur de l'arbre des dominateurs (itératif : les CFG peuvent être très profonds)
+    // Les valeurs empilées dans un bloc sont dépilées en quittant son sous-arbre
+    void rename(CFG &cfg, const DominatorTree &domTree)
+    {
+        vector<int> pushed; // symboles empilés, dans l'ordre
+        auto push = [&](int s, const string &value) {
+            valueStack[s].push_back(value);
+            pushed.push_back(s);
+        };
+
+        struct Frame
+        {
+            BasicBlock *bb;
+            size_t nextChild;
+            size_t pushedMark;
+        };
+        vector<Frame> stack;
+        BasicBlock *entry = cfg.get_entry();
+        stack.push_back({entry, 0, 0});
+        rename_block(cfg, entry, push);
+        while (!stack.empty())
+        {
+            Frame &frame = stack.back();
+            const vector<BasicBlock *> &children = domTree.get_children(frame.bb);
+            if (frame.nextChild < children.size())
+            {
+                BasicBlock *child = children[frame.nextChild++];
+                stack.push_back({child, 0, pushed.size()});
+                rename_block(cfg, child, push);
+                continue;
+            }
+            while (pushed.size() > frame.pushedMark)
+            {
+                valueStack[pushed.back()].pop_back();
+                pushed.pop_back();
+            }
+            stack.pop_back();
+        }
+
+        if (!undefValue.empty())
+        {
+            vector<IRInstr *> &instrs = entry->instrs;
+            instrs.insert(instrs.begin(), new IRInstr(entry, IRInstr::ldconst, Type(INT), {undefValue, "0"}));
+        }
+    }
+
+    template <typename Push>
+    void rename_block(CFG &cfg, BasicBlock *bb, Push push)
+    {
+        vector<IRInstr *> kept;
+        for (IRInstr *instr : bb->instrs)
+        {
+            vector<string> &params = instr->get_params();
+            IRInstr::Operation op = instr->get_op();
+
+            if (op == IRInstr::phi && phiSymbol.count(instr))
+            {
+                int s = phiSymbol[instr];
+                params[0] = new_name(cfg, s);
+                push(s, params[0]);
+                kept.push_back(instr);
+                continue;
+            }
+
+            for (size_t i : instr->get_use_indices())
+                rename_operand(cfg, params[i]);
+
+            if ((op == IRInstr::rmem || op == IRInstr::wmem) && IRInstr::is_symbol(params[1]))
+            {
+                // La destination prend la valeur de la source : l'accès mémoire disparaît
+                push(symbol_id(params[0]), params[1]);
+                delete instr;
+                continue;
+            }
+            if (op == IRInstr::rmem || op == IRInstr::wmem)
+            {
+                // Lecture d'un registre physique : elle reste une vraie copie
+                instr->set_op(IRInstr::copy);
+                op = IRInstr::copy;
+            }
+
+            int d = symbol_id(instr->get_dest());
+            if (d >= 0 && d < (int)symbolCount)
+            {
+                size_t destIndex = (op == IRInstr::call) ? 1 : 0;
+                params[destIndex] = new_name(cfg, d);
+                push(d, params[destIndex]);
+            }
+            kept.push_back(instr);
+        }
+        bb->instrs = kept;
+
+        if (bb->exit_false)
+            rename_operand(cfg, bb->test_var_name);
+
+        // Valeurs entrantes des phi des successeurs
+        for (BasicBlock *succ : bb->get_successors())
+        {
+            for (IRInstr *instr : succ->instrs)
+            {
+                if (instr->get_op() != IRInstr::phi)
+                    break;
+                auto it = phiSymbol.find(instr);
+                if (it == phiSymbol.end())
+                    continue;
+                instr->get_params().push_back(current_value(cfg, it->second));
+                instr->get_params().push_back(bb->label);
+            }
+        }
+    }
+};
+
+} // namespace
+
+FunctionPass *createMem2RegPass()
+{
+    return new Mem2RegPass();
+}
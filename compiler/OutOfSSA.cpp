@@ -0,0 +1,137 @@
+// OUTOFSSA.CPP : Sortie de la forme SSA (passe "out-of-ssa")
+// Le back-end ne sait pas émettre de phi : chaque "d = phi(v0 depuis P0, v1 depuis P1...)" devient
+// une copie "d = vi" à la fin de chaque prédécesseur Pi.
+//   - un arc critique (prédécesseur à deux successeurs) est coupé par un nouveau bloc qui porte
+//     les copies, sinon elles s'exécuteraient aussi sur l'autre branche ("lost copy problem")
+//   - les phi d'un même bloc forment une copie parallèle : toutes les sources sont lues avant
+//     qu'une destination ne soit écrite. La séquentialisation (Boissinot et al.) émet d'abord les
+//     copies dont la destination n'est plus lue, puis casse les cycles (a, b = b, a) avec un
+//     temporaire ("swap problem")
+// Cette transformation est nécessaire à la génération de code : elle ne consomme pas de carburant.
+
+#include "Passes.h"
+
+namespace
+{
+
+class OutOfSSAPass : public FunctionPass
+{
+public:
+    string get_name() const override { return "out-of-ssa"; }
+
+    bool run_on_function(CFG &cfg, AnalysisManager &am) override
+    {
+        map<string, BasicBlock *> blockOfLabel;
+        vector<BasicBlock *> phiBlocks;
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            blockOfLabel[bb->label] = bb;
+            if (!bb->instrs.empty() && bb->instrs[0]->get_op() == IRInstr::phi)
+                phiBlocks.push_back(bb);
+        }
+
+        for (BasicBlock *bb : phiBlocks)
+        {
+            // Copies parallèles à placer sur chaque arc entrant
+            map<BasicBlock *, vector<std::pair<string, string>>> copiesFrom;
+            vector<BasicBlock *> preds;
+            size_t firstNonPhi = 0;
+            while (firstNonPhi < bb->instrs.size() && bb->instrs[firstNonPhi]->get_op() == IRInstr::phi)
+            {
+                IRInstr *phi = bb->instrs[firstNonPhi++];
+                const vector<string> &params = phi->get_params();
+                for (size_t i = 1; i + 1 < params.size(); i += 2)
+                {
+                    auto pred = blockOfLabel.find(params[i + 1]);
+                    if (pred == blockOfLabel.end())
+                        continue;
+                    if (!copiesFrom.count(pred->second))
+                        preds.push_back(pred->second);
+                    copiesFrom[pred->second].push_back({params[0], params[i]});
+                }
+                delete phi;
+            }
+            bb->instrs.erase(bb->instrs.begin(), bb->instrs.begin() + firstNonPhi);
+
+            for (BasicBlock *pred : preds)
+            {
+                BasicBlock *target = pred;
+                if (pred->get_successors().size() > 1)
+                    target = split_edge(cfg, pred, bb);
+                sequentialize(cfg, target, copiesFrom[pred]);
+            }
+        }
+        return !phiBlocks.empty();
+    }
+
+private:
+    // Insère un bloc vide sur l'arc from -> to
+    BasicBlock *split_edge(CFG &cfg, BasicBlock *from, BasicBlock *to)
+    {
+        BasicBlock *middle = new BasicBlock(&cfg, cfg.new_BB_name());
+        middle->exit_true = to;
+        if (from->exit_true == to)
+            from->exit_true = middle;
+        if (from->exit_false == to)
+            from->exit_false = middle;
+        return middle;
+    }
+
+    // Émet à la fin de bb les copies (destination, source), qui doivent se comporter comme si elles
+    // étaient simultanées
+    void sequentialize(CFG &cfg, BasicBlock *bb, const vector<std::pair<string, string>> &copies)
+    {
+        map<string, string> loc;  // emplacement actuel de la valeur initiale d'une source
+        map<string, string> pred; // destination -> source
+        vector<string> ready, todo;
+        for (const auto &c : copies)
+        {
+            if (c.first == c.second)
+                continue;
+            loc[c.second] = c.second;
+            pred[c.first] = c.second;
+            todo.push_back(c.first);
+        }
+        for (const string &dest : todo)
+        {
+            // Une destination qui n'est pas une source peut être écrite immédiatement
+            if (!loc.count(dest))
+                ready.push_back(dest);
+        }
+
+        string temp;
+        while (!todo.empty())
+        {
+            while (!ready.empty())
+            {
+                string dest = ready.back();
+                ready.pop_back();
+                string src = pred[dest];
+                string current = loc[src];
+                bb->add_IRInstr(IRInstr::copy, Type(INT), {dest, current});
+                loc[src] = dest;
+                // La source d'origine est libérée : elle peut à son tour être écrite
+                if (src == current && pred.count(src))
+                    ready.push_back(src);
+            }
+            string dest = todo.back();
+            todo.pop_back();
+            if (loc[pred[dest]] != dest)
+            {
+                // Cycle : on sauvegarde dest dans un temporaire avant de l'écraser
+                if (temp.empty())
+                    temp = cfg.create_new_tempvar(Type(INT));
+                bb->add_IRInstr(IRInstr::copy, Type(INT), {temp, dest});
+                loc[dest] = temp;
+                ready.push_back(dest);
+            }
+        }
+    }
+};
+
+} // namespace
+
+FunctionPass *createOutOfSSAPass()
+{
+    return new OutOfSSAPass();
+}
@@ -0,0 +1,310 @@
+// PASSMANAGER.CPP : Implémentation du gestionnaire de passes et du cache d'analyses
+
+#include "PassManager.h"
+#include "Passes.h"
+#include <algorithm>
+#include <iostream>
+
+long PassManager::fuel = -1;
+bool PassManager::fuelExhaustedReported = false;
+bool PassManager::remarksEnabled = false;
+
+// ---------------------------------------------------------------------------
+// AnalysisManager
+// ---------------------------------------------------------------------------
+
+DominatorTree &AnalysisManager::get_dominators(CFG *cfg)
+{
+    std::unique_ptr<DominatorTree> &result = dominators[cfg];
+    if (!result)
+        result.reset(new DominatorTree(cfg));
+    return *result;
+}
+
+DominanceFrontier &AnalysisManager::get_dominance_frontier(CFG *cfg)
+{
+    std::unique_ptr<DominanceFrontier> &result = dominanceFrontiers[cfg];
+    if (!result)
+        result.reset(new DominanceFrontier(cfg, get_dominators(cfg)));
+    return *result;
+}
+
+Liveness &AnalysisManager::get_liveness(CFG *cfg)
+{
+    std::unique_ptr<Liveness> &result = liveness[cfg];
+    if (!result)
+        result.reset(new Liveness(cfg));
+    return *result;
+}
+
+ReachingDefinitions &AnalysisManager::get_reaching_definitions(CFG *cfg)
+{
+    std::unique_ptr<ReachingDefinitions> &result = reachingDefinitions[cfg];
+    if (!result)
+        result.reset(new ReachingDefinitions(cfg));
+    return *result;
+}
+
+AvailableExpressions &AnalysisManager::get_available_expressions(CFG *cfg)
+{
+    std::unique_ptr<AvailableExpressions> &result = availableExpressions[cfg];
+    if (!result)
+        result.reset(new AvailableExpressions(cfg));
+    return *result;
+}
+
+LoopInfo &AnalysisManager::get_loops(CFG *cfg)
+{
+    std::unique_ptr<LoopInfo> &result = loops[cfg];
+    if (!result)
+        result.reset(new LoopInfo(cfg, get_dominators(cfg)));
+    return *result;
+}
+
+BranchProbability &AnalysisManager::get_branch_probability(CFG *cfg)
+{
+    std::unique_ptr<BranchProbability> &result = branchProbabilities[cfg];
+    if (!result)
+        result.reset(new BranchProbability(cfg, get_dominators(cfg), get_loops(cfg)));
+    return *result;
+}
+
+CallGraph &AnalysisManager::get_call_graph()
+{
+    if (!callGraph)
+        callGraph.reset(new CallGraph(module));
+    return *callGraph;
+}
+
+Purity &AnalysisManager::get_purity()
+{
+    if (!purity)
+        purity.reset(new Purity(module, *this));
+    return *purity;
+}
+
+void AnalysisManager::invalidate(CFG *cfg, bool cfgPreserved)
+{
+    liveness.erase(cfg);
+    reachingDefinitions.erase(cfg);
+    availableExpressions.erase(cfg);
+    // Les heuristiques lisent aussi les instructions (comparaisons, constantes retournées)
+    branchProbabilities.erase(cfg);
+    // Une passe de fonction peut ajouter ou supprimer des appels
+    callGraph.reset();
+    // Les effets des fonctions restent valides : une passe de fonction n'ajoute pas d'appel, et la seule
+    // boucle qu'elle crée (tailrec) remplace une récursion qui avait déjà mis mayNotTerminate
+    if (!cfgPreserved)
+    {
+        dominators.erase(cfg);
+        dominanceFrontiers.erase(cfg);
+        loops.erase(cfg);
+    }
+}
+
+void AnalysisManager::invalidate_all()
+{
+    dominators.clear();
+    dominanceFrontiers.clear();
+    liveness.clear();
+    reachingDefinitions.clear();
+    availableExpressions.clear();
+    loops.clear();
+    branchProbabilities.clear();
+    callGraph.reset();
+    purity.reset();
+}
+
+// ---------------------------------------------------------------------------
+// Registre des passes et pipelines
+// ---------------------------------------------------------------------------
+
+// Crée une passe à partir de son nom
+Pass *PassManager::create_pass(const string &name)
+{
+    if (name == "verify")
+        return createVerifierPass();
+    if (name == "mem2reg")
+        return createMem2RegPass();
+    if (name == "out-of-ssa")
+        return createOutOfSSAPass();
+    if (name == "sccp")
+        return createSCCPPass();
+    if (name == "instcombine")
+        return createInstCombinePass();
+    if (name == "lvn")
+        return createLVNPass();
+    if (name == "gvn")
+        return createGVNPass();
+    if (name == "copyprop")
+        return createCopyPropPass();
+    if (name == "coalesce")
+        return createCoalescePass();
+    if (name == "ifconvert")
+        return createIfConvertPass();
+    if (name == "simplifycfg")
+        return createSimplifyCFGPass();
+    if (name == "tailrec")
+        return createTailRecPass();
+    if (name == "inline")
+        return createInlinePass();
+    if (name == "ipcp")
+        return createIPCPPass();
+    if (name == "purity")
+        return createPurityPass();
+    if (name == "layout")
+        return createLayoutPass();
+    if (name == "dce")
+        return createDCEPass();
+    if (name == "dse")
+        return createDSEPass();
+    return nullptr;
+}
+
+vector<string> PassManager::get_available_passes()
+{
+    return {"verify", "mem2reg", "out-of-ssa", "sccp", "instcombine", "lvn", "gvn", "copyprop", "ifconvert", "coalesce", "dce", "dse", "simplifycfg", "tailrec", "inline", "ipcp", "purity", "layout"};
+}
+
+// Pipelines standards
+// -O0 : aucune optimisation (l'IR construit par VisitorIR est émis tel quel)
+// -O1 : passes peu coûteuses qui ne font pas grossir le code
+// -O2 : pipeline complet
+// Les optimisations travaillent sur la forme SSA, construite par mem2reg et défaite par out-of-ssa
+// inline (-O2) intègre les appelés déjà simplifiés, ipcp propage les arguments constants des appels restants ;
+// sccp et instcombine replient ensuite ces constantes
+// purity résume les effets des fonctions (--remarks) avant que lvn/gvn et dce ne fusionnent ou suppriment les appels purs
+// simplifycfg passe deux fois : après les simplifications SSA, puis sur les blocs de copies laissés par out-of-ssa
+// layout range enfin les blocs pour l'émission (plus aucune passe ne modifie le CFG après elle)
+static const vector<string> pipelineO1 = {"mem2reg", "sccp", "instcombine", "tailrec", "purity", "lvn", "copyprop",
+                                          "dce", "simplifycfg", "out-of-ssa", "coalesce", "simplifycfg", "layout"};
+static const vector<string> pipelineO2 = {"mem2reg", "sccp", "instcombine", "tailrec", "inline", "ipcp", "sccp",
+                                          "instcombine", "purity", "gvn", "copyprop", "ifconvert", "dce", "simplifycfg",
+                                          "out-of-ssa", "coalesce", "simplifycfg", "layout"};
+
+void PassManager::build_pipeline(int optLevel)
+{
+    passes.clear();
+    if (optLevel <= 0)
+        return;
+
+    const vector<string> &pipeline = (optLevel == 1) ? pipelineO1 : pipelineO2;
+    for (const string &name : pipeline)
+    {
+        add_pass_by_name(name);
+    }
+}
+
+void PassManager::remove_pass(const string &name)
+{
+    passes.erase(std::remove_if(passes.begin(), passes.end(),
+                                [&](const std::unique_ptr<Pass> &pass) { return pass->get_name() == name; }),
+                 passes.end());
+}
+
+void PassManager::add_pass(Pass *pass)
+{
+    passes.emplace_back(pass);
+}
+
+bool PassManager::add_pass_by_name(const string &name)
+{
+    Pass *pass = create_pass(name);
+    if (!pass)
+        return false;
+    add_pass(pass);
+    return true;
+}
+
+vector<string> PassManager::get_pipeline() const
+{
+    vector<string> names;
+    for (const auto &pass : passes)
+    {
+        names.push_back(pass->get_name());
+    }
+    return names;
+}
+
+// ---------------------------------------------------------------------------
+// Exécution
+// ---------------------------------------------------------------------------
+
+void PassManager::run(Module &module)
+{
+    AnalysisManager am(module);
+
+    for (const auto &pass : passes)
+    {
+        if (FunctionPass *fp = dynamic_cast<FunctionPass *>(pass.get()))
+        {
+            for (auto &pair : module)
+            {
+                CFG *cfg = pair.second;
+                bool changed = fp->run_on_function(*cfg, am);
+                if (changed)
+                    am.invalidate(cfg, fp->preserves_cfg());
+                print_ir(fp->get_name(), module, cfg);
+            }
+        }
+        else if (ModulePass *mp = dynamic_cast<ModulePass *>(pass.get()))
+        {
+            bool changed = mp->run_on_module(module, am);
+            if (changed)
+                am.invalidate_all();
+            print_ir(mp->get_name(), module, nullptr);
+        }
+    }
+}
+
+// Affiche l'IR sur stderr (la sortie standard est réservée à l'assembleur)
+void PassManager::print_ir(const string &passName, Module &module, CFG *only)
+{
+    if (printAfter.empty() || (printAfter != "all" && printAfter != passName))
+        return;
+
+    for (auto &pair : module)
+    {
+        if (only && pair.second != only)
+            continue;
+        std::cerr << "; *** IR après " << passName << " (" << pair.first << ") ***" << std::endl;
+        pair.second->print(std::cerr);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Carburant d'optimisation
+// ---------------------------------------------------------------------------
+
+void PassManager::set_fuel(long f)
+{
+    fuel = f;
+    fuelExhaustedReported = false;
+}
+
+bool PassManager::consume_fuel(const string &passName)
+{
+    if (fuel < 0)
+        return true;
+    if (fuel == 0)
+    {
+        if (!fuelExhaustedReported)
+        {
+            std::cerr << "Carburant d'optimisation épuisé dans la passe '" << passName << "'" << std::endl;
+            fuelExhaustedReported = true;
+        }
+        return false;
+    }
+    fuel--;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Remarques d'optimisation
+// ---------------------------------------------------------------------------
+
+void PassManager::remark(const string &passName, const CFG &cfg, const string &message)
+{
+    if (remarksEnabled)
+        std::cerr << "remarque [" << passName << "] " << cfg.get_name() << " : " << message << std::endl;
+}
@@ -0,0 +1,131 @@
+// PASSMANAGER.H : Gestionnaire de passes d'optimisation du middle-end
+// Les passes s'exécutent entre la construction des CFG (VisitorIR) et la génération d'assembleur.
+//   - FunctionPass : transforme le CFG d'une fonction
+//   - ModulePass   : travaille sur l'ensemble des CFG du programme (inlining, propagation interprocédurale...)
+// Les analyses (dominateurs, flot de données, boucles, graphe d'appel, effets de bord des fonctions) sont
+// fournies par l'AnalysisManager, calculées à la demande, mises en cache et invalidées lorsqu'une passe modifie l'IR.
+// Le niveau d'optimisation (-O0, -O1, -O2) choisit la liste de passes exécutées (le pipeline).
+#ifndef PASS_MANAGER_H
+#define PASS_MANAGER_H
+
+#include "IR.h"
+#include "Analyses.h"
+#include "Dataflow.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Cache des analyses : chaque analyse est calculée au premier accès puis conservée
+// tant qu'aucune passe n'a modifié le CFG concerné
+class AnalysisManager
+{
+public:
+    AnalysisManager(Module &module) : module(module) {}
+
+    DominatorTree &get_dominators(CFG *cfg);
+    DominanceFrontier &get_dominance_frontier(CFG *cfg);
+    Liveness &get_liveness(CFG *cfg);
+    ReachingDefinitions &get_reaching_definitions(CFG *cfg);
+    AvailableExpressions &get_available_expressions(CFG *cfg);
+    LoopInfo &get_loops(CFG *cfg);
+    BranchProbability &get_branch_probability(CFG *cfg);
+    CallGraph &get_call_graph();
+    Purity &get_purity();
+
+    /** Invalide les analyses d'une fonction après une transformation
+        (si cfgPreserved, les arcs du CFG n'ont pas changé : dominateurs, frontières et boucles restent valides) */
+    void invalidate(CFG *cfg, bool cfgPreserved = false);
+    /** Invalide toutes les analyses (après une passe de module) */
+    void invalidate_all();
+
+private:
+    Module &module;
+    map<CFG *, std::unique_ptr<DominatorTree>> dominators;
+    map<CFG *, std::unique_ptr<DominanceFrontier>> dominanceFrontiers;
+    map<CFG *, std::unique_ptr<Liveness>> liveness;
+    map<CFG *, std::unique_ptr<ReachingDefinitions>> reachingDefinitions;
+    map<CFG *, std::unique_ptr<AvailableExpressions>> availableExpressions;
+    map<CFG *, std::unique_ptr<LoopInfo>> loops;
+    map<CFG *, std::unique_ptr<BranchProbability>> branchProbabilities;
+    std::unique_ptr<CallGraph> callGraph;
+    std::unique_ptr<Purity> purity;
+};
+
+// Classe de base de toutes les passes
+class Pass
+{
+public:
+    virtual ~Pass() {}
+    /** Nom de la passe (utilisé par --passes= et --print-after=) */
+    virtual string get_name() const = 0;
+    /** Vrai si la passe ne modifie jamais les arcs du CFG (seulement les instructions) */
+    virtual bool preserves_cfg() const { return false; }
+};
+
+// Passe qui transforme une fonction à la fois ; retourne vrai si l'IR a été modifié
+class FunctionPass : public Pass
+{
+public:
+    virtual bool run_on_function(CFG &cfg, AnalysisManager &am) = 0;
+};
+
+// Passe qui travaille sur tout le module ; retourne vrai si l'IR a été modifié
+class ModulePass : public Pass
+{
+public:
+    virtual bool run_on_module(Module &module, AnalysisManager &am) = 0;
+};
+
+// Gestionnaire de passes : construit le pipeline et l'exécute sur le module
+class PassManager
+{
+public:
+    PassManager() {}
+
+    /** Ajoute une passe à la fin du pipeline (le PassManager en devient propriétaire) */
+    void add_pass(Pass *pass);
+    /** Ajoute une passe par son nom ; retourne faux si le nom est inconnu */
+    bool add_pass_by_name(const string &name);
+    /** Construit le pipeline standard d'un niveau d'optimisation (0, 1 ou 2) */
+    void build_pipeline(int optLevel);
+    /** Retire du pipeline toutes les occurrences d'une passe */
+    void remove_pass(const string &name);
+    /** Noms des passes du pipeline courant */
+    vector<string> get_pipeline() const;
+
+    /** Affiche l'IR sur stderr après chaque exécution de cette passe ("all" : après toutes les passes) */
+    void set_print_after(const string &passName) { printAfter = passName; }
+
+    /** Exécute le pipeline sur tout le module */
+    void run(Module &module);
+
+    /** Carburant d'optimisation : nombre maximal de transformations autorisées (-1 : illimité)
+        Permet de retrouver par dichotomie la transformation responsable d'une erreur */
+    static void set_fuel(long fuel);
+    /** À appeler par une passe avant chaque transformation : faux si le carburant est épuisé */
+    static bool consume_fuel(const string &passName);
+
+    /** Remarques d'optimisation (--remarks) : les passes décrivent sur stderr ce qu'elles ont transformé */
+    static void set_remarks(bool enabled) { remarksEnabled = enabled; }
+    static bool remarks_enabled() { return remarksEnabled; }
+    /** Écrit "remarque [passe] fonction : message" si les remarques sont activées */
+    static void remark(const string &passName, const CFG &cfg, const string &message);
+
+    /** Crée une passe à partir de son nom (nullptr si inconnu) */
+    static Pass *create_pass(const string &name);
+    /** Noms de toutes les passes disponibles */
+    static vector<string> get_available_passes();
+
+private:
+    vector<std::unique_ptr<Pass>> passes;
+    string printAfter;
+
+    void print_ir(const string &passName, Module &module, CFG *only);
+
+    static long fuel;
+    static bool fuelExhaustedReported;
+    static bool remarksEnabled;
+};
+
+#endif
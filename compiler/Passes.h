@@ -0,0 +1,46 @@
+// PASSES.H : Constructeurs des passes d'optimisation disponibles
+// Chaque passe est implémentée dans son propre fichier et enregistrée par son nom
+// dans PassManager::create_pass (PassManager.cpp).
+#ifndef PASSES_H
+#define PASSES_H
+
+#include "PassManager.h"
+
+// Vérification de la cohérence du CFG (arcs, variable de test, symboles) ; ne modifie pas l'IR
+ModulePass *createVerifierPass();
+// Construction de la forme SSA : variables promues en valeurs SSA, phi aux frontières de dominance
+FunctionPass *createMem2RegPass();
+// Sortie de SSA : phi remplacés par des copies parallèles sur les arcs entrants (obligatoire avant l'émission)
+FunctionPass *createOutOfSSAPass();
+// Propagation de constantes conditionnelle creuse (SSA) : valeurs constantes, branchements repliés, blocs morts supprimés
+FunctionPass *createSCCPPass();
+// Simplifications algébriques (x+0, x*1, x-x, !!x...), forme canonique et réassociation des constantes (SSA)
+FunctionPass *createInstCombinePass();
+// Numérotation locale des valeurs : calculs et relectures de variables redondants dans un bloc remplacés par des copies
+FunctionPass *createLVNPass();
+// Numérotation globale des valeurs (SSA) : calculs totalement redondants sur l'arbre des dominateurs remplacés par des copies
+FunctionPass *createGVNPass();
+// Propagation des copies (SSA) : les utilisations d'une copie lisent directement sa source, la copie est supprimée
+FunctionPass *createCopyPropPass();
+// Fusion des copies après out-of-ssa : source et destination sans interférence partagent le même emplacement
+FunctionPass *createCoalescePass();
+// Conversion des petits if/else (SSA) en select sans branchement (cmov, csel), idiomes min/max/abs reconnus
+FunctionPass *createIfConvertPass();
+// Simplification du CFG : blocs en chaîne fusionnés, sauts redirigés à travers les blocs vides et les conditions connues
+FunctionPass *createSimplifyCFGPass();
+// Élimination de la récursion terminale (SSA) : appels récursifs terminaux et accumulations (n * f(n - 1)) en boucle
+FunctionPass *createTailRecPass();
+// Intégration des fonctions, de bas en haut du graphe d'appel, selon la taille et les arguments constants
+ModulePass *createInlinePass();
+// Propagation interprocédurale des constantes (SSA) : paramètres constants à tous les appels, copies spécialisées des fonctions chaudes
+ModulePass *createIPCPPass();
+// Placement des blocs selon les probabilités des branchements (chemin probable sans saut, blocs froids à part)
+FunctionPass *createLayoutPass();
+// Effets de bord de chaque fonction (entrées-sorties, terminaison), affichés avec --remarks ; ne modifie pas l'IR
+ModulePass *createPurityPass();
+// Élimination du code mort : blocs inatteignables et instructions sans effet de bord dont le résultat n'est jamais lu
+FunctionPass *createDCEPass();
+// Écritures mortes et transfert écriture -> lecture sur les cases des variables (rmem/wmem, avant mem2reg)
+FunctionPass *createDSEPass();
+
+#endif
@@ -0,0 +1,35 @@
+// PURITY.CPP : Effets de bord des fonctions (passe "purity")
+// Les effets de chaque fonction sont calculés par l'analyse Purity (Analyses.h) et utilisés à la
+// demande par gvn et lvn (fusion des appels purs identiques ; gvn sort aussi des boucles les appels
+// purs invariants), dce (suppression des appels purs dont le résultat est inutilisé) et tailrec (un
+// appel pur peut être exécuté avant l'appel récursif). Cette passe ne modifie pas l'IR : placée avant
+// ces passes, elle affiche avec --remarks le résumé de chaque fonction, par exemple "pure ; termine
+// toujours" ou "effets de bord : écrit sur la sortie (putchar) ; peut ne pas terminer".
+
+#include "Passes.h"
+
+namespace
+{
+
+class PurityPass : public ModulePass
+{
+public:
+    string get_name() const override { return "purity"; }
+
+    bool run_on_module(Module &module, AnalysisManager &am) override
+    {
+        if (!PassManager::remarks_enabled())
+            return false;
+        Purity &purity = am.get_purity();
+        for (auto &pair : module)
+            PassManager::remark(get_name(), *pair.second, purity.get_effects(pair.first).describe());
+        return false;
+    }
+};
+
+} // namespace
+
+ModulePass *createPurityPass()
+{
+    return new PurityPass();
+}
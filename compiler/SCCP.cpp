@@ -0,0 +1,364 @@
+// SCCP.CPP : Propagation de constantes conditionnelle creuse (passe "sccp", Wegman et Zadeck)
+// Travaille sur la forme SSA (après mem2reg) : chaque valeur "!N" a une seule définition.
+// Chaque valeur reçoit une place dans le treillis  inconnue (haut) > constante c > variable (bas),
+// et chaque arc du CFG est supposé non exécuté tant qu'on n'a pas prouvé le contraire :
+//   - un phi ne prend en compte que les valeurs arrivant par des arcs exécutables
+//   - un branchement dont la variable de test est constante ne rend exécutable que l'arc choisi
+// Les deux listes de travail (arcs du CFG, valeurs SSA abaissées) sont vidées jusqu'au point fixe.
+// Transformations :
+//   - une instruction dont le résultat est constant devient "ldconst dest, c"
+//   - un branchement à condition constante devient un saut inconditionnel
+//   - les blocs devenus inatteignables sont supprimés, et les phi perdent les valeurs
+//     des prédécesseurs disparus
+// Les constantes sont repliées par IRInstr::fold : une division par zéro n'est jamais repliée.
+
+#include "Passes.h"
+#include <set>
+
+namespace
+{
+
+// Place d'une valeur dans le treillis
+struct LatticeValue
+{
+    enum Kind
+    {
+        Top,      // pas encore de valeur connue (définition non exécutée)
+        Constant, // toujours égale à constant
+        Bottom    // peut prendre plusieurs valeurs
+    };
+    Kind kind = Top;
+    int32_t constant = 0;
+
+    bool operator==(const LatticeValue &other) const
+    {
+        return kind == other.kind && (kind != Constant || constant == other.constant);
+    }
+};
+
+class SCCPPass : public FunctionPass
+{
+public:
+    string get_name() const override { return "sccp"; }
+
+    bool run_on_function(CFG &cfg, AnalysisManager &am) override
+    {
+        if (cfg.get_bbs().empty() || !cfg.is_ssa())
+            return false;
+
+        collect_definitions(cfg);
+
+        solve(cfg);
+
+        bool changed = rewrite_constants(cfg);
+        changed |= fold_branches(cfg);
+        if (cfg.remove_unreachable_bbs() > 0)
+            changed = true;
+        cfg.prune_phis();
+        return changed;
+    }
+
+private:
+    std::set<string> defined;                        // valeurs définies dans la fonction
+    map<string, LatticeValue> values;                // valeur SSA -> place dans le treillis
+    map<string, vector<IRInstr *>> users;            // valeur SSA -> instructions qui la lisent
+    map<string, vector<BasicBlock *>> branchUsers;   // valeur SSA -> blocs dont elle est la variable de test
+    map<string, BasicBlock *> blockOfLabel;
+    std::set<BasicBlock *> executableBlocks;
+    std::set<std::pair<BasicBlock *, BasicBlock *>> executableEdges;
+    vector<std::pair<BasicBlock *, BasicBlock *>> edgeWorklist;
+    vector<string> valueWorklist;
+
+    // Table des définitions et des utilisations
+    void collect_definitions(CFG &cfg)
+    {
+        defined.clear();
+        values.clear();
+        users.clear();
+        branchUsers.clear();
+        blockOfLabel.clear();
+        executableBlocks.clear();
+        executableEdges.clear();
+        edgeWorklist.clear();
+        valueWorklist.clear();
+
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            blockOfLabel[bb->label] = bb;
+            for (IRInstr *instr : bb->instrs)
+            {
+                string dest = instr->get_dest();
+                if (IRInstr::is_symbol(dest))
+                    defined.insert(dest);
+                for (size_t i : instr->get_use_indices())
+                {
+                    const string &operand = instr->get_params()[i];
+                    if (IRInstr::is_symbol(operand))
+                        users[operand].push_back(instr);
+                }
+            }
+            if (bb->exit_false && IRInstr::is_symbol(bb->test_var_name))
+                branchUsers[bb->test_var_name].push_back(bb);
+        }
+    }
+
+    // Valeur d'un opérande : une constante littérale, une valeur SSA, ou un registre physique (inconnu)
+    LatticeValue operand_value(const string &operand)
+    {
+        LatticeValue v;
+        if (IRInstr::is_constant(operand))
+        {
+            v.kind = LatticeValue::Constant;
+            v.constant = IRInstr::constant_value(operand);
+        }
+        else if (IRInstr::is_symbol(operand) && defined.count(operand))
+            v = values[operand];
+        else
+            v.kind = LatticeValue::Bottom;
+        return v;
+    }
+
+    // Abaisse la valeur de dest (le treillis ne fait que descendre, ce qui garantit la terminaison)
+    void lower(const string &dest, const LatticeValue &v)
+    {
+        LatticeValue &current = values[dest];
+        if (v.kind == LatticeValue::Top || current == v || current.kind == LatticeValue::Bottom)
+            return;
+        current = (current.kind == LatticeValue::Top) ? v : bottom();
+        valueWorklist.push_back(dest);
+    }
+
+    static LatticeValue bottom()
+    {
+        LatticeValue v;
+        v.kind = LatticeValue::Bottom;
+        return v;
+    }
+
+    void mark_edge(BasicBlock *from, BasicBlock *to)
+    {
+        if (executableEdges.insert({from, to}).second)
+            edgeWorklist.push_back({from, to});
+    }
+
+    void solve(CFG &cfg)
+    {
+        BasicBlock *entry = cfg.get_entry();
+        executableBlocks.insert(entry);
+        visit_block(entry);
+
+        while (!edgeWorklist.empty() || !valueWorklist.empty())
+        {
+            while (!edgeWorklist.empty())
+            {
+                BasicBlock *to = edgeWorklist.back().second;
+                edgeWorklist.pop_back();
+                if (executableBlocks.insert(to).second)
+                    visit_block(to);
+                else
+                {
+                    // Bloc déjà visité : seul un phi peut voir une nouvelle valeur entrante
+                    for (IRInstr *instr : to->instrs)
+                    {
+                        if (instr->get_op() != IRInstr::phi)
+                            break;
+                        visit_instr(instr);
+                    }
+                }
+            }
+            while (!valueWorklist.empty())
+            {
+                string value = valueWorklist.back();
+                valueWorklist.pop_back();
+                for (IRInstr *instr : users[value])
+                {
+                    if (executableBlocks.count(instr->get_bb()))
+                        visit_instr(instr);
+                }
+                for (BasicBlock *bb : branchUsers[value])
+                {
+                    if (executableBlocks.count(bb))
+                        visit_terminator(bb);
+                }
+            }
+        }
+    }
+
+    void visit_block(BasicBlock *bb)
+    {
+        for (IRInstr *instr : bb->instrs)
+            visit_instr(instr);
+        visit_terminator(bb);
+    }
+
+    void visit_terminator(BasicBlock *bb)
+    {
+        if (!bb->exit_true)
+            return;
+        if (!bb->exit_false)
+        {
+            mark_edge(bb, bb->exit_true);
+            return;
+        }
+        LatticeValue test = operand_value(bb->test_var_name);
+        if (test.kind == LatticeValue::Top)
+            return;
+        if (test.kind == LatticeValue::Bottom || test.constant != 0)
+            mark_edge(bb, bb->exit_true);
+        if (test.kind == LatticeValue::Bottom || test.constant == 0)
+            mark_edge(bb, bb->exit_false);
+    }
+
+    void visit_instr(IRInstr *instr)
+    {
+        const vector<string> &p = instr->get_params();
+        string dest = instr->get_dest();
+        if (!IRInstr::is_symbol(dest))
+            return;
+
+        switch (instr->get_op())
+        {
+        case IRInstr::call:
+            lower(dest, bottom());
+            return;
+        case IRInstr::ldconst:
+        case IRInstr::copy:
+            lower(dest, operand_value(p[1]));
+            return;
+        case IRInstr::phi:
+            visit_phi(instr);
+            return;
+        case IRInstr::select:
+            visit_select(instr);
+            return;
+        default:
+            break;
+        }
+
+        vector<size_t> uses = instr->get_use_indices();
+        if (uses.empty())
+            return;
+        LatticeValue a = operand_value(p[uses[0]]);
+        LatticeValue b = uses.size() > 1 ? operand_value(p[uses[1]]) : a;
+        if (a.kind == LatticeValue::Bottom || b.kind == LatticeValue::Bottom)
+        {
+            lower(dest, bottom());
+            return;
+        }
+        if (a.kind == LatticeValue::Top || b.kind == LatticeValue::Top)
+            return;
+
+        LatticeValue result;
+        if (IRInstr::fold(instr->get_op(), a.constant, b.constant, result.constant))
+            result.kind = LatticeValue::Constant;
+        else
+            result = bottom();
+        lower(dest, result);
+    }
+
+    // Condition constante : la valeur choisie ; sinon les deux valeurs doivent être la même constante
+    void visit_select(IRInstr *select)
+    {
+        const vector<string> &p = select->get_params();
+        LatticeValue cond = operand_value(p[1]);
+        if (cond.kind == LatticeValue::Top)
+            return;
+        if (cond.kind == LatticeValue::Constant)
+        {
+            lower(p[0], operand_value(cond.constant != 0 ? p[2] : p[3]));
+            return;
+        }
+        LatticeValue a = operand_value(p[2]), b = operand_value(p[3]);
+        if (a.kind == LatticeValue::Bottom || b.kind == LatticeValue::Bottom ||
+            (a.kind == LatticeValue::Constant && b.kind == LatticeValue::Constant && a.constant != b.constant))
+            lower(p[0], bottom());
+        else if (a.kind == LatticeValue::Constant && b.kind == LatticeValue::Constant)
+            lower(p[0], a);
+    }
+
+    // Rencontre des valeurs arrivant par les arcs exécutables
+    void visit_phi(IRInstr *phi)
+    {
+        const vector<string> &p = phi->get_params();
+        BasicBlock *bb = phi->get_bb();
+        LatticeValue merged;
+        for (size_t i = 1; i + 1 < p.size(); i += 2)
+        {
+            auto pred = blockOfLabel.find(p[i + 1]);
+            if (pred == blockOfLabel.end() || !executableEdges.count({pred->second, bb}))
+                continue;
+            LatticeValue v = operand_value(p[i]);
+            if (v.kind == LatticeValue::Top)
+                continue;
+            if (merged.kind == LatticeValue::Top)
+                merged = v;
+            else if (!(merged == v))
+                merged = bottom();
+        }
+        lower(p[0], merged);
+    }
+
+    // Les définitions de valeurs constantes deviennent des ldconst ; les phi constants sont
+    // déplacés après les phi restants, qui doivent rester en tête de bloc
+    bool rewrite_constants(CFG &cfg)
+    {
+        bool changed = false;
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            if (!executableBlocks.count(bb))
+                continue;
+            vector<IRInstr *> phis, constantPhis, others;
+            for (IRInstr *instr : bb->instrs)
+            {
+                bool isPhi = instr->get_op() == IRInstr::phi;
+                string dest = instr->get_dest();
+                LatticeValue v = IRInstr::is_symbol(dest) ? values[dest] : LatticeValue();
+                bool rewrite = v.kind == LatticeValue::Constant && instr->get_op() != IRInstr::ldconst &&
+                               PassManager::consume_fuel(get_name());
+                if (rewrite)
+                {
+                    instr->set_op(IRInstr::ldconst);
+                    instr->get_params() = {dest, std::to_string(v.constant)};
+                    changed = true;
+                }
+                if (isPhi)
+                    (rewrite ? constantPhis : phis).push_back(instr);
+                else
+                    others.push_back(instr);
+            }
+            bb->instrs = phis;
+            bb->instrs.insert(bb->instrs.end(), constantPhis.begin(), constantPhis.end());
+            bb->instrs.insert(bb->instrs.end(), others.begin(), others.end());
+        }
+        return changed;
+    }
+
+    // Un branchement dont un seul arc est exécutable devient un saut vers ce successeur
+    bool fold_branches(CFG &cfg)
+    {
+        bool changed = false;
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            if (!executableBlocks.count(bb) || !bb->exit_false)
+                continue;
+            bool takeTrue = executableEdges.count({bb, bb->exit_true}) > 0;
+            bool takeFalse = executableEdges.count({bb, bb->exit_false}) > 0;
+            if (takeTrue == takeFalse || !PassManager::consume_fuel(get_name()))
+                continue;
+            if (takeFalse)
+                bb->exit_true = bb->exit_false;
+            bb->exit_false = nullptr;
+            bb->test_var_name.clear();
+            bb->expected_branch = -1;
+            changed = true;
+        }
+        return changed;
+    }
+};
+
+} // namespace
+
+FunctionPass *createSCCPPass()
+{
+    return new SCCPPass();
+}
@@ -0,0 +1,202 @@
+// SIMPLIFYCFG.CPP : Simplification du graphe de flot de contrôle (passe "simplifycfg")
+// VisitorIR ouvre un bloc par branche et par jonction ; après les autres passes (if repliés par
+// sccp, branches vidées par copyprop ou ifconvert, copies des phi placées par out-of-ssa), il reste des
+// chaînes de blocs qui ne font que sauter au suivant, et chaque bloc coûte un saut à l'exécution.
+// Trois transformations, répétées jusqu'au point fixe :
+//   - fusion : un bloc B qui saute sans condition vers S, dont B est le seul prédécesseur, absorbe
+//     les instructions et la sortie de S (les phi de S, à une seule valeur, deviennent des copies)
+//   - saut à travers un bloc vide : un prédécesseur d'un bloc E sans instruction qui saute vers T saute
+//     directement vers T (les phi de T reçoivent depuis lui la valeur qui venait de E) ; un branchement
+//     dont les deux cibles deviennent identiques devient inconditionnel
+//   - condition connue : un bloc C qui ne fait que tester t (t est au plus un phi, lu seulement par le
+//     branchement) n'est pas traversé par un prédécesseur P qui connaît la valeur de t (constante
+//     du phi, ou dernière écriture de t dans P hors SSA) : P saute directement vers la cible choisie
+// Les blocs devenus inatteignables sont supprimés. Fonctionne sur la forme SSA comme après out-of-ssa ;
+// avec --remarks, le nombre de blocs fusionnés et de sauts redirigés est affiché pour chaque fonction.
+// La génération de code n'émet pas le saut vers le bloc placé juste après.
+
+#include "Passes.h"
+
+namespace
+{
+
+class SimplifyCFGPass : public FunctionPass
+{
+public:
+    string get_name() const override { return "simplifycfg"; }
+
+    bool run_on_function(CFG &cfg, AnalysisManager &am) override
+    {
+        if (cfg.get_bbs().empty())
+            return false;
+
+        merged = 0;
+        threaded = 0;
+        bool changed = false;
+        bool progress = true;
+        while (progress)
+        {
+            progress = false;
+            preds = cfg.compute_predecessors();
+            for (BasicBlock *bb : cfg.get_bbs())
+            {
+                if (merge_successor(cfg, bb) || thread_through_empty(bb) || thread_known_condition(cfg, bb))
+                {
+                    cfg.remove_unreachable_bbs();
+                    cfg.prune_phis();
+                    progress = changed = true;
+                    break;
+                }
+            }
+        }
+        if (changed)
+            PassManager::remark(get_name(), cfg, std::to_string(merged) + " bloc(s) fusionné(s), " +
+                                                     std::to_string(threaded) + " saut(s) redirigé(s)");
+        return changed;
+    }
+
+private:
+    map<BasicBlock *, vector<BasicBlock *>> preds;
+    int merged = 0;
+    int threaded = 0;
+
+    static bool has_phis(const BasicBlock *bb)
+    {
+        return !bb->instrs.empty() && bb->instrs[0]->get_op() == IRInstr::phi;
+    }
+
+    // Le bloc pred saute désormais vers target au lieu de via : les phi de target reçoivent depuis pred
+    // la valeur qui venait de via
+    static void redirect(BasicBlock *pred, BasicBlock *via, BasicBlock *target)
+    {
+        for (IRInstr *instr : target->instrs)
+        {
+            if (instr->get_op() != IRInstr::phi)
+                break;
+            string value = instr->get_phi_value(via->label);
+            instr->get_params().insert(instr->get_params().end(), {value, pred->label});
+        }
+        if (pred->exit_true == via)
+            pred->exit_true = target;
+        if (pred->exit_false == via)
+            pred->exit_false = target;
+        if (pred->exit_true == pred->exit_false)
+        {
+            pred->exit_false = nullptr;
+            pred->test_var_name.clear();
+            pred->expected_branch = -1;
+        }
+    }
+
+    // Fusion de bb avec son unique successeur, dont il est l'unique prédécesseur
+    bool merge_successor(CFG &cfg, BasicBlock *bb)
+    {
+        BasicBlock *succ = bb->exit_true;
+        if (bb->exit_false || !succ || succ == bb || succ == cfg.get_entry() || preds[succ].size() != 1)
+            return false;
+        if (!PassManager::consume_fuel(get_name()))
+            return false;
+        for (IRInstr *instr : succ->instrs)
+        {
+            if (instr->get_op() == IRInstr::phi)
+            {
+                vector<string> &p = instr->get_params();
+                instr->set_op(IRInstr::copy);
+                p = {p[0], p[1]};
+            }
+            instr->set_bb(bb);
+            bb->instrs.push_back(instr);
+        }
+        succ->instrs.clear();
+        bb->exit_true = succ->exit_true;
+        bb->exit_false = succ->exit_false;
+        bb->test_var_name = succ->test_var_name;
+        bb->expected_branch = succ->expected_branch;
+        for (BasicBlock *next : bb->get_successors())
+            next->rename_phi_label(succ->label, bb->label);
+        succ->exit_true = nullptr;
+        succ->exit_false = nullptr;
+        merged++;
+        return true;
+    }
+
+    // Les prédécesseurs d'un bloc vide qui saute sans condition vers target sautent directement vers target
+    bool thread_through_empty(BasicBlock *bb)
+    {
+        BasicBlock *target = bb->exit_true;
+        if (!bb->instrs.empty() || bb->exit_false || !target || target == bb)
+            return false;
+        bool changed = false;
+        for (BasicBlock *pred : preds[bb])
+        {
+            // Un phi ne peut pas recevoir deux valeurs du même prédécesseur
+            bool alreadyPred = pred->exit_true == target || pred->exit_false == target;
+            if ((alreadyPred && has_phis(target)) || !PassManager::consume_fuel(get_name()))
+                continue;
+            redirect(pred, bb, target);
+            threaded++;
+            changed = true;
+        }
+        return changed;
+    }
+
+    // Un bloc qui ne fait que tester une condition connue du prédécesseur n'est pas traversé
+    bool thread_known_condition(CFG &cfg, BasicBlock *bb)
+    {
+        if (!bb->exit_false || bb->exit_true == bb->exit_false || !IRInstr::is_symbol(bb->test_var_name))
+            return false;
+        const string &test = bb->test_var_name;
+        IRInstr *phi = nullptr;
+        if (bb->instrs.size() == 1 && bb->instrs[0]->get_op() == IRInstr::phi && bb->instrs[0]->get_dest() == test)
+            phi = bb->instrs[0];
+        else if (!bb->instrs.empty())
+            return false;
+        if (phi && cfg.count_uses(test) != 1)
+            return false;
+
+        bool changed = false;
+        for (BasicBlock *pred : preds[bb])
+        {
+            int32_t value;
+            if (pred->exit_false || !known_value(pred, phi, test, value) || !PassManager::consume_fuel(get_name()))
+                continue;
+            redirect(pred, bb, value != 0 ? bb->exit_true : bb->exit_false);
+            threaded++;
+            changed = true;
+        }
+        return changed;
+    }
+
+    // Valeur de test à la sortie de pred : constante reçue par le phi, ou dernière écriture dans pred
+    bool known_value(BasicBlock *pred, IRInstr *phi, const string &test, int32_t &value) const
+    {
+        string source = phi ? phi->get_phi_value(pred->label) : test;
+        if (IRInstr::is_constant(source))
+        {
+            value = IRInstr::constant_value(source);
+            return true;
+        }
+        for (auto it = pred->instrs.rbegin(); it != pred->instrs.rend(); ++it)
+        {
+            IRInstr *instr = *it;
+            if (instr->get_dest() != source)
+                continue;
+            const string &written = instr->get_params()[1];
+            if ((instr->get_op() == IRInstr::ldconst || instr->get_op() == IRInstr::copy) && IRInstr::is_constant(written))
+            {
+                value = IRInstr::constant_value(written);
+                return true;
+            }
+            return false;
+        }
+        return false;
+    }
+
+};
+
+} // namespace
+
+FunctionPass *createSimplifyCFGPass()
+{
+    return new SimplifyCFGPass();
+}
@@ -1,5 +1,6 @@
 // SymbolTableVisitor.cpp : Implémentation du visiteur pour la table des symboles et les analyses statiques
 #include "SymbolTableVisitor.h"
+#include "DefFonction.h"
 
 // Constructeur : initialise les structures et ajoute les fonctions externes
 SymbolTableVisitor::SymbolTableVisitor() : currentOffset(-8), hasErrors(false) {
@@ -52,6 +53,16 @@ antlrcpp::Any SymbolTableVisitor::visitFunction(ifccParser::FunctionContext *ctx
     // Ajouter la fonction à la liste des fonctions déclarées
     declaredFunctions.insert(funcName);
     
+    // Consignes d'intégration (voir readInlineSpecifiers) : seuls always_inline et noinline sont compris
+    std::vector<std::string> specifiers;
+    for (auto spec : ctx->function_spec())
+        specifiers.push_back(spec->getText());
+    InlineSpecifiers inlining = readInlineSpecifiers(specifiers);
+    for (const std::string &name : inlining.ignored)
+        std::cerr << "AVERTISSEMENT: Attribut '" << name << "' de la fonction '" << funcName << "' ignoré" << std::endl;
+    if (inlining.conflicting)
+        std::cerr << "AVERTISSEMENT: Fonction '" << funcName << "' à la fois always_inline et noinline : noinline retenu" << std::endl;
+
     // Définir la fonction courante
     currentFunction = funcName;
     
@@ -277,6 +288,12 @@ antlrcpp::Any SymbolTableVisitor::visitCallExpr(ifccParser::CallExprContext *ctx
     return 0;
 }
 
+// Visite de __builtin_expect (seule l'expression testée est à vérifier)
+antlrcpp::Any SymbolTableVisitor::visitExpectExpr(ifccParser::ExpectExprContext *ctx) {
+    this->visit(ctx->expr());
+    return 0;
+}
+
 // Visite d'une constante (rien à faire)
 antlrcpp::Any SymbolTableVisitor::visitConstExpr(ifccParser::ConstExprContext *ctx) {
     return 0;
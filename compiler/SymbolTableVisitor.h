@@ -60,6 +60,7 @@ public:
     
     // Déclarations manquantes pour la couverture complète de la grammaire
     virtual antlrcpp::Any visitCallExpr(ifccParser::CallExprContext *ctx) override;
+    virtual antlrcpp::Any visitExpectExpr(ifccParser::ExpectExprContext *ctx) override;
     virtual antlrcpp::Any visitConstExpr(ifccParser::ConstExprContext *ctx) override;
     virtual antlrcpp::Any visitCharExpr(ifccParser::CharExprContext *ctx) override;
     virtual antlrcpp::Any visitAdditiveExpr(ifccParser::AdditiveExprContext *ctx) override;
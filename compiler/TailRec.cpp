@@ -0,0 +1,346 @@
+// TAILREC.CPP : Élimination de la récursion terminale (passe "tailrec")
+// Un appel récursif coûte un cadre de pile par niveau (et la sauvegarde des registres autour du call) :
+// une récursion profonde déborde de la pile. Sur la forme SSA, deux sortes de sites sont reconnues
+// dans les blocs qui terminent la fonction f :
+//   - appel terminal : "call f, d, args" suivi de "ret d"
+//   - récursion linéaire avec accumulateur : "call f, d, args", puis "r = x op d" et "ret r", où op est
+//     associative et commutative (+, *, &, |, ^) et x ne dépend pas de d (return n * f(n - 1))
+// Le bloc d'entrée E est coupé : les lectures des registres de paramètres passent dans un nouveau bloc
+// d'entrée N qui saute vers E, et chaque paramètre p reçoit en tête de E un phi (p depuis N, l'argument
+// depuis chaque site), sauf s'il est repassé inchangé par tous les sites. Un site devient un saut vers E ; avec un accumulateur acc (phi en tête de E,
+// élément neutre de op depuis N), le site calcule "acc' = acc op x" et chaque return qui n'est pas un
+// site retourne "acc op v" au lieu de v. La récursion devient une boucle et la pile reste constante.
+// Les instructions placées entre l'appel et le return doivent pouvoir être exécutées avant lui (pas
+// de division ni de modulo, pas d'appel sauf vers une fonction pure qui termine toujours, voir Purity).
+// Un seul opérateur d'accumulation par fonction : les sites d'un autre opérateur restent des appels.
+// Avec --remarks, le nombre d'appels remplacés est affiché.
+// Les autres appels terminaux ("call g, d, args" suivi de "ret d", g quelconque) sont ensuite marqués :
+// la génération de code les émet comme un saut vers g après la libération du cadre (voir
+// BasicBlock::get_tail_call) ; un appel non marqué, comme à -O0, reste un call.
+
+#include "Passes.h"
+#include "DefFonction.h"
+#include <algorithm>
+
+namespace
+{
+
+// Site récursif : bloc, appel, instruction d'accumulation (nullptr pour un appel terminal)
+struct RecursiveSite
+{
+    BasicBlock *bb;
+    IRInstr *call;
+    IRInstr *accumulate;
+    string operand; // x dans "r = x op d"
+};
+
+class TailRecPass : public FunctionPass
+{
+public:
+    string get_name() const override { return "tailrec"; }
+
+    bool run_on_function(CFG &cfg, AnalysisManager &am) override
+    {
+        if (cfg.get_bbs().empty() || !cfg.is_ssa())
+            return false;
+        purity = &am.get_purity();
+        bool eliminated = eliminate_recursion(cfg, am);
+        return mark_tail_calls(cfg) || eliminated;
+    }
+
+private:
+    const Purity *purity = nullptr;
+
+    // Remplace les sites récursifs par des sauts vers l'en-tête
+    bool eliminate_recursion(CFG &cfg, AnalysisManager &am)
+    {
+        vector<IRInstr *> paramReads;
+        for (auto &read : cfg.compute_parameter_reads())
+            paramReads.push_back(read.second);
+        if (paramReads.size() != cfg.ast->getParams().size() || !cfg.compute_predecessors()[cfg.get_entry()].empty())
+            return false;
+
+        // Sites retenus : tous les appels terminaux, et les accumulations du premier opérateur trouvé
+        vector<RecursiveSite> sites;
+        bool hasAccumulator = false;
+        IRInstr::Operation accOp = IRInstr::add;
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            RecursiveSite site;
+            if (!match_site(cfg, bb, paramReads.size(), site))
+                continue;
+            if (site.accumulate)
+            {
+                if (hasAccumulator && site.accumulate->get_op() != accOp)
+                    continue;
+                hasAccumulator = true;
+                accOp = site.accumulate->get_op();
+            }
+            if (!PassManager::consume_fuel(get_name()))
+                continue;
+            sites.push_back(site);
+        }
+        if (sites.empty())
+            return false;
+
+        // Nouveau bloc d'entrée : lecture des registres de paramètres, élément neutre de l'accumulateur
+        BasicBlock *header = cfg.get_entry();
+        BasicBlock *entry = new BasicBlock(&cfg, cfg.new_BB_name());
+        vector<BasicBlock *> &bbs = cfg.get_bbs();
+        bbs.erase(std::find(bbs.begin(), bbs.end(), entry));
+        bbs.insert(bbs.begin(), entry);
+        entry->exit_true = header;
+        for (IRInstr *read : paramReads)
+        {
+            header->instrs.erase(std::find(header->instrs.begin(), header->instrs.end(), read));
+            read->set_bb(entry);
+            entry->instrs.push_back(read);
+        }
+
+        // Les paramètres sont désormais lus à travers les phi de l'en-tête
+        vector<string> initial, current;
+        map<string, string> renamed;
+        for (IRInstr *read : paramReads)
+        {
+            initial.push_back(read->get_dest());
+            current.push_back(cfg.create_new_tempvar(Type::INT_TYPE));
+            renamed[initial.back()] = current.back();
+        }
+        rename_uses(cfg, entry, renamed);
+
+        vector<IRInstr *> phis;
+        for (size_t i = 0; i < initial.size(); i++)
+            phis.push_back(new IRInstr(header, IRInstr::phi, Type::INT_TYPE, {current[i], initial[i], entry->label}));
+        string acc;
+        if (hasAccumulator)
+        {
+            string identity = cfg.create_new_tempvar(Type::INT_TYPE);
+            entry->add_IRInstr(IRInstr::ldconst, Type::INT_TYPE, {identity, std::to_string(identity_of(accOp))});
+            acc = cfg.create_new_tempvar(Type::INT_TYPE);
+            phis.push_back(new IRInstr(header, IRInstr::phi, Type::INT_TYPE, {acc, identity, entry->label}));
+        }
+
+        int accumulated = 0;
+        for (const RecursiveSite &site : sites)
+        {
+            BasicBlock *bb = site.bb;
+            vector<string> args(site.call->get_params().begin() + 2, site.call->get_params().end());
+            // L'appel, l'accumulation et le return disparaissent ; les instructions intermédiaires restent
+            IRInstr *ret = bb->instrs.back();
+            vector<IRInstr *> kept;
+            for (IRInstr *instr : bb->instrs)
+            {
+                if (instr == site.call || instr == site.accumulate || instr == ret)
+                    delete instr;
+                else
+                    kept.push_back(instr);
+            }
+            bb->instrs = kept;
+
+            string nextAcc = acc;
+            if (site.accumulate)
+            {
+                // x a été relevé avant que les paramètres ne soient renommés
+                auto it = renamed.find(site.operand);
+                nextAcc = cfg.create_new_tempvar(Type::INT_TYPE);
+                bb->add_IRInstr(accOp, Type::INT_TYPE, {nextAcc, acc, it != renamed.end() ? it->second : site.operand});
+                accumulated++;
+            }
+            for (size_t i = 0; i < args.size(); i++)
+                phis[i]->get_params().insert(phis[i]->get_params().end(), {args[i], bb->label});
+            if (hasAccumulator)
+                phis.back()->get_params().insert(phis.back()->get_params().end(), {nextAcc, bb->label});
+            bb->exit_true = header;
+        }
+        // Un paramètre que tous les sites repassent inchangé (scaled(n - 1, k, ...)) garde la valeur lue
+        // à l'entrée : son phi ne reçoit que lui-même, il est supprimé et le paramètre reste défini hors
+        // de la boucle (gvn peut alors en sortir un appel pur qui le lit)
+        map<string, string> unchanged;
+        for (size_t i = 0; i < initial.size(); i++)
+        {
+            const vector<string> &p = phis[i]->get_params();
+            bool trivial = true;
+            for (size_t j = 3; j < p.size(); j += 2)
+                trivial = trivial && p[j] == current[i];
+            if (!trivial)
+                continue;
+            unchanged[current[i]] = initial[i];
+            delete phis[i];
+            phis[i] = nullptr;
+        }
+        phis.erase(std::remove(phis.begin(), phis.end(), nullptr), phis.end());
+        rename_uses(cfg, entry, unchanged);
+        header->instrs.insert(header->instrs.begin(), phis.begin(), phis.end());
+
+        // Les autres return combinent leur valeur avec l'accumulateur
+        if (hasAccumulator)
+        {
+            for (BasicBlock *bb : cfg.get_bbs())
+            {
+                if (bb->exit_true || bb->instrs.empty() || bb->instrs.back()->get_op() != IRInstr::ret)
+                    continue;
+                IRInstr *ret = bb->instrs.back();
+                bb->instrs.pop_back();
+                string value = ret->get_params()[0];
+                if (!IRInstr::is_symbol(value))
+                {
+                    string loaded = cfg.create_new_tempvar(Type::INT_TYPE);
+                    bb->add_IRInstr(IRInstr::ldconst, Type::INT_TYPE, {loaded, value});
+                    value = loaded;
+                }
+                string result = cfg.create_new_tempvar(Type::INT_TYPE);
+                bb->add_IRInstr(accOp, Type::INT_TYPE, {result, acc, value});
+                ret->get_params()[0] = result;
+                bb->instrs.push_back(ret);
+            }
+        }
+
+        am.invalidate(&cfg);
+        PassManager::remark(get_name(), cfg, std::to_string(sites.size()) + " appel(s) récursif(s) remplacé(s) par un saut, dont " +
+                                                 std::to_string(accumulated) + " avec accumulateur");
+        return true;
+    }
+
+    // Marque les appels terminaux restants, que la génération de code émettra comme des sauts
+    bool mark_tail_calls(CFG &cfg)
+    {
+        int marked = 0;
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            vector<IRInstr *> &instrs = bb->instrs;
+            if (bb->exit_true || instrs.size() < 2)
+                continue;
+            IRInstr *call = instrs[instrs.size() - 2];
+            IRInstr *ret = instrs.back();
+            if (call->get_op() != IRInstr::call || call->is_tail_call() || ret->get_op() != IRInstr::ret ||
+                ret->get_params()[0] != call->get_params()[1] || !PassManager::consume_fuel(get_name()))
+                continue;
+            call->set_tail_call(true);
+            marked++;
+        }
+        if (marked > 0)
+            PassManager::remark(get_name(), cfg, std::to_string(marked) + " appel(s) terminal(aux) émis comme un saut");
+        return marked > 0;
+    }
+
+    static int32_t identity_of(IRInstr::Operation op)
+    {
+        switch (op)
+        {
+        case IRInstr::mul:
+            return 1;
+        case IRInstr::bit_and:
+            return -1;
+        default:
+            return 0;
+        }
+    }
+
+    static bool is_accumulation(IRInstr::Operation op)
+    {
+        return op == IRInstr::add || op == IRInstr::mul || op == IRInstr::bit_and || op == IRInstr::bit_or ||
+               op == IRInstr::bit_xor;
+    }
+
+    // Instruction qui peut être exécutée avant l'appel récursif sans changer le comportement
+    bool can_precede(const IRInstr *instr) const
+    {
+        switch (instr->get_op())
+        {
+        case IRInstr::call:
+            return purity->is_removable_call(instr);
+        case IRInstr::ret:
+        case IRInstr::div:
+        case IRInstr::mod:
+        case IRInstr::phi:
+            return false;
+        default:
+            return true;
+        }
+    }
+
+    static bool uses(const IRInstr *instr, const string &var)
+    {
+        for (size_t i : instr->get_use_indices())
+        {
+            if (instr->get_params()[i] == var)
+                return true;
+        }
+        return false;
+    }
+
+    // Reconnaît un site récursif à la fin de bb (bloc qui termine la fonction)
+    bool match_site(CFG &cfg, BasicBlock *bb, size_t paramCount, RecursiveSite &site)
+    {
+        vector<IRInstr *> &instrs = bb->instrs;
+        if (bb->exit_true || instrs.size() < 2 || instrs.back()->get_op() != IRInstr::ret)
+            return false;
+        const string &returned = instrs.back()->get_params()[0];
+
+        // Dernier appel récursif du bloc
+        size_t c = instrs.size() - 1;
+        while (c > 0 && !(instrs[c - 1]->get_op() == IRInstr::call && instrs[c - 1]->get_params()[0] == cfg.get_name()))
+            c--;
+        if (c == 0)
+            return false;
+        IRInstr *call = instrs[--c];
+        const string &result = call->get_params()[1];
+        if (call->get_params().size() - 2 != paramCount)
+            return false;
+
+        site.bb = bb;
+        site.call = call;
+        site.accumulate = nullptr;
+        if (c + 2 == instrs.size())
+            return returned == result;
+
+        // Accumulation : "r = x op d" juste avant "ret r", rien entre les deux qui lise d ou ne puisse précéder l'appel
+        IRInstr *acc = instrs[instrs.size() - 2];
+        const vector<string> &p = acc->get_params();
+        if (!is_accumulation(acc->get_op()) || p[0] != returned || (p[1] == result) == (p[2] == result) ||
+            !IRInstr::is_symbol(p[1] == result ? p[2] : p[1]))
+            return false;
+        for (size_t i = c + 1; i + 2 < instrs.size(); i++)
+        {
+            if (!can_precede(instrs[i]) || uses(instrs[i], result))
+                return false;
+        }
+        if (cfg.count_uses(result) != 1 || cfg.count_uses(returned) != 1)
+            return false;
+        site.accumulate = acc;
+        site.operand = p[1] == result ? p[2] : p[1];
+        return true;
+    }
+
+    // Remplace les utilisations des variables de renamed dans toute la fonction (sauf dans le bloc skip)
+    static void rename_uses(CFG &cfg, BasicBlock *skip, const map<string, string> &renamed)
+    {
+        for (BasicBlock *bb : cfg.get_bbs())
+        {
+            if (bb == skip)
+                continue;
+            for (IRInstr *instr : bb->instrs)
+            {
+                for (size_t i : instr->get_use_indices())
+                {
+                    auto it = renamed.find(instr->get_params()[i]);
+                    if (it != renamed.end())
+                        instr->get_params()[i] = it->second;
+                }
+            }
+            if (bb->exit_false)
+            {
+                auto it = renamed.find(bb->test_var_name);
+                if (it != renamed.end())
+                    bb->test_var_name = it->second;
+            }
+        }
+    }
+};
+
+} // namespace
+
+FunctionPass *createTailRecPass()
+{
+    return new TailRecPass();
+}
@@ -0,0 +1,122 @@
+// VERIFIER.CPP : Passe de vérification de la cohérence de l'IR
+// Utile après une passe d'optimisation pour détecter au plus tôt un CFG mal formé :
+//   - les successeurs d'un bloc appartiennent au même CFG
+//   - un bloc avec deux successeurs possède une variable de test
+//   - les variables "!N" utilisées existent dans la table des symboles
+//   - les phi sont en tête de bloc et ont exactement une valeur par prédécesseur
+//   - tous les blocs sont atteignables depuis l'entrée (la génération de code refuse les orphelins)
+// En cas d'erreur, une exception std::runtime_error est levée.
+
+#include "Passes.h"
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+
+class VerifierPass : public ModulePass
+{
+public:
+    string get_name() const override { return "verify"; }
+
+    bool run_on_module(Module &module, AnalysisManager &am) override
+    {
+        for (auto &pair : module)
+        {
+            verify_function(*pair.second);
+        }
+        return false;
+    }
+
+private:
+    void fail(const CFG &cfg, const string &msg)
+    {
+        throw std::runtime_error("IR invalide dans '" + cfg.get_name() + "' : " + msg);
+    }
+
+    void check_operand(const CFG &cfg, const string &op)
+    {
+        if (IRInstr::is_symbol(op) && std::stoi(op.substr(1)) >= cfg.get_symbol_count())
+            fail(cfg, "variable inconnue " + op);
+    }
+
+    // Les labels d'un phi sont exactement les prédécesseurs (atteignables) de son bloc
+    void verify_phi(const CFG &cfg, IRInstr *phi, map<BasicBlock *, vector<BasicBlock *>> &preds)
+    {
+        BasicBlock *bb = phi->get_bb();
+        if (!preds.count(bb))
+            return;
+        const vector<string> &params = phi->get_params();
+        std::set<string> expected, seen;
+        for (BasicBlock *pred : preds[bb])
+            expected.insert(pred->label);
+        for (size_t i = 2; i < params.size(); i += 2)
+        {
+            if (!expected.count(params[i]) || !seen.insert(params[i]).second)
+                fail(cfg, "phi de " + params[0] + " : " + params[i] + " n'est pas un prédécesseur distinct de " + bb->label);
+        }
+        if (seen.size() != expected.size())
+            fail(cfg, "phi de " + params[0] + " : il manque des prédécesseurs de " + bb->label);
+    }
+
+    void verify_function(const CFG &cfg)
+    {
+        const vector<BasicBlock *> &bbs = cfg.get_bbs();
+        if (bbs.empty())
+            fail(cfg, "aucun bloc");
+        map<BasicBlock *, vector<BasicBlock *>> preds = cfg.compute_predecessors();
+        vector<BasicBlock *> rpo = cfg.compute_rpo();
+        std::set<BasicBlock *> reachable(rpo.begin(), rpo.end());
+
+        for (BasicBlock *bb : bbs)
+        {
+            if (bb->cfg != &cfg)
+                fail(cfg, "le bloc " + bb->label + " appartient à un autre CFG");
+            if (!reachable.count(bb))
+                fail(cfg, "le bloc " + bb->label + " n'est pas atteignable depuis l'entrée");
+            for (BasicBlock *succ : bb->get_successors())
+            {
+                if (std::find(bbs.begin(), bbs.end(), succ) == bbs.end())
+                    fail(cfg, "le bloc " + bb->label + " saute vers un bloc hors du CFG");
+            }
+            if (bb->exit_false && !bb->exit_true)
+                fail(cfg, "le bloc " + bb->label + " a un exit_false sans exit_true");
+            if (bb->exit_false && bb->test_var_name.empty())
+                fail(cfg, "le bloc " + bb->label + " se termine par un branchement sans variable de test");
+            if (bb->exit_false)
+                check_operand(cfg, bb->test_var_name);
+
+            bool phiAllowed = true;
+            for (IRInstr *instr : bb->instrs)
+            {
+                if (instr->get_op() == IRInstr::phi)
+                {
+                    if (!phiAllowed)
+                        fail(cfg, "phi après une autre instruction dans le bloc " + bb->label);
+                    verify_phi(cfg, instr, preds);
+                }
+                else
+                    phiAllowed = false;
+                if (instr->get_bb() != bb)
+                {
+                    std::ostringstream ss;
+                    instr->print(ss);
+                    fail(cfg, "l'instruction '" + ss.str() + "' ne connaît pas son bloc " + bb->label);
+                }
+                for (const string &p : instr->get_params())
+                {
+                    check_operand(cfg, p);
+                }
+            }
+        }
+    }
+};
+
+} // namespace
+
+ModulePass *createVerifierPass()
+{
+    return new VerifierPass();
+}
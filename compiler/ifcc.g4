@@ -10,8 +10,12 @@ axiom : prog EOF ;
 // Un programme est une suite de fonctions ou de déclarations globales
 prog : (function | global_decl)* EOF ;
 
-// Définition d'une fonction (int ou void)
-function : ('int'|'void') VAR '(' param_list? ')' block_stmt ;
+// Définition d'une fonction (int ou void), avec des spécificateurs avant ou après le type de retour
+// Ex : inline int f(int a) { ... } ou int __attribute__((noinline)) g() { ... }
+function : function_spec* ('int'|'void') function_spec* VAR '(' param_list? ')' block_stmt ;
+
+// Consignes d'intégration : inline, ou attributs GCC (always_inline, noinline ; les autres sont ignorés)
+function_spec : INLINE | ATTRIBUTE '(' '(' VAR (',' VAR)* ')' ')' ;
 
 // Déclaration globale (support limité, pour extensions futures)
 // Permet de déclarer des variables globales
@@ -52,6 +56,7 @@ expr : expr ASSIGN expr                             # assignExpr
      | expr (BITOR) expr                            # bitwiseOrExpr
      | expr OR expr                                 # logicalOrExpr
      | expr AND expr                                # logicalAndExpr
+     | BUILTIN_EXPECT '(' expr ',' MINUS? CONST ')'  # expectExpr
      | VAR '(' arg_list? ')'                        # callExpr
      | VAR                                          # varExpr
      | CONST                                        # constExpr
@@ -69,6 +74,9 @@ arg_list : expr (',' expr)* ;
 IF : 'if' ;
 ELSE : 'else' ;
 RETURN : 'return' ;
+INLINE : 'inline' ;
+ATTRIBUTE : '__attribute__' ;
+BUILTIN_EXPECT : '__builtin_expect' ;  // __builtin_expect(e, c) : vaut e, annonce que e vaut probablement c
 VAR : [a-zA-Z_][a-zA-Z0-9_]* ;
 CONST : [0-9]+ ;
 CHAR_LITERAL : '\'' . '\'' ;  // Token pour les caractères
@@ -0,0 +1,90 @@
+// IFCC_OPT.CPP : Outil autonome ifcc-opt
+// Lit de l'IR (format textuel ou binaire, produit par ifcc --emit=ir ou --emit=ir-binary),
+// exécute les passes demandées puis émet de l'IR ou de l'assembleur.
+// Il ne dépend pas d'ANTLR : on peut ainsi isoler, comparer et mesurer les passes sans le front-end.
+//   ifcc --emit=ir prog.c > prog.ir
+//   ifcc-opt --passes=verify --print-after=all prog.ir > prog.s
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <stdexcept>
+#include "IRSerializer.h"
+#include "PassManager.h"
+#include "DriverOptions.h"
+
+// ifcc-opt émet de l'IR textuel par défaut
+static const char* defaultEmit = "ir";
+
+static void printUsage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [options] <input.ir|->" << std::endl;
+    std::cerr << "Lit de l'IR textuel ou binaire ('-' : entrée standard), exécute les passes et émet le résultat" << std::endl;
+    std::cerr << "Options:" << std::endl;
+    print_driver_options_usage(std::cerr, defaultEmit);
+    std::cerr << "  --list-passes          affiche les passes disponibles" << std::endl;
+}
+
+int main(int argc, const char* argv[]) {
+    // Lecture des options
+    const char* inputFile = nullptr;
+    DriverOptions options;
+    options.emit = defaultEmit;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        try {
+            if (parse_driver_option(arg, options))
+                continue;
+        } catch (const std::runtime_error& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        if (arg == "--list-passes") {
+            for (const std::string& name : PassManager::get_available_passes())
+                std::cout << name << std::endl;
+            return 0;
+        }
+        if (arg[0] == '-' && arg != "-") {
+            std::cerr << "Error: unknown option " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        inputFile = argv[i];
+    }
+    if (!inputFile) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    PassManager passManager;
+    if (!configure_pass_manager(passManager, options)) {
+        return 1;
+    }
+
+    Module module;
+    try {
+        // Lecture de l'IR (le format est détecté à partir de l'en-tête)
+        if (std::string(inputFile) == "-") {
+            read_module(std::cin, module);
+        } else {
+            std::ifstream file(inputFile, std::ios::binary);
+            if (!file) {
+                std::cerr << "Error: Could not open file " << inputFile << std::endl;
+                return 1;
+            }
+            read_module(file, module);
+        }
+
+        passManager.run(module);
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        for (auto& pair : module)
+            delete pair.second;
+        return 1;
+    }
+
+    int status = run_or_emit_module(std::cout, module, options);
+
+    for (auto& pair : module)
+        delete pair.second;
+    return status;
+}
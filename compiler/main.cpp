@@ -2,25 +2,59 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <stdexcept>
 #include "visitor_ir.h"
 #include "SymbolTableVisitor.h"
+#include "PassManager.h"
+#include "DriverOptions.h"
 #include "generated/ifccLexer.h"
 #include "generated/ifccParser.h"
 #include "antlr4-runtime.h"
 
 using namespace antlr4;
 
+static void printUsage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [options] <input_file>" << std::endl;
+    std::cerr << "Options:" << std::endl;
+    print_driver_options_usage(std::cerr, DriverOptions().emit);
+}
+
 int main(int argc, const char* argv[]) {
-    if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <input_file>" << std::endl;
+    // Lecture des options de la ligne de commande
+    const char* inputFile = nullptr;
+    DriverOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        try {
+            if (parse_driver_option(arg, options))
+                continue;
+        } catch (const std::runtime_error& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        if (arg[0] == '-') {
+            std::cerr << "Error: unknown option " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        inputFile = argv[i];
+    }
+    if (!inputFile) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // Construction du pipeline de passes d'optimisation
+    PassManager passManager;
+    if (!configure_pass_manager(passManager, options)) {
         return 1;
     }
 
     // Lecture du fichier d'entrée
     std::stringstream in;
-    std::ifstream file(argv[1]);
+    std::ifstream file(inputFile);
     if (!file) {
-        std::cerr << "Error: Could not open file " << argv[1] << std::endl;
+        std::cerr << "Error: Could not open file " << inputFile << std::endl;
         return 1;
     }
     in << file.rdbuf();
@@ -50,9 +84,19 @@ int main(int argc, const char* argv[]) {
         return 1;
     }
 
-    // PHASE 2: Génération de code avec la table des symboles
+    // PHASE 2: Construction de l'IR et des CFG avec la table des symboles
     VisitorIR visitor(symbolTableVisitor.getSymbolTable());
     visitor.visit(tree);
 
-    return 0;
+    // PHASE 3: Passes d'optimisation sur les CFG
+    try {
+        passManager.run(visitor.getCFGs());
+    } catch (const std::runtime_error& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // PHASE 4: Génération du code assembleur (ou de l'IR avec --emit=ir / --emit=ir-binary),
+    // ou exécution directe avec --run : le code de sortie est alors celui du programme
+    return run_or_emit_module(std::cout, visitor.getCFGs(), options);
 }
\ No newline at end of file
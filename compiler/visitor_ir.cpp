@@ -9,7 +9,6 @@
 #include "DefFonction.h"
 #include <sstream>
 #include <iostream>
-#include <algorithm> // Pour std::reverse
 #include <any>
 
 using std::to_string;
@@ -39,8 +38,8 @@ void VisitorIR::addInstr(IRInstr::Operation op, Type t, const vector<string> &pa
 BasicBlock *VisitorIR::createNewBB()
 {
     string bbName = "BB_" + to_string(nextBBnumber++);
+    // Le constructeur de BasicBlock enregistre déjà le bloc dans le CFG
     BasicBlock *bb = new BasicBlock(current_cfg, bbName);
-    current_cfg->add_bb(bb);
     return bb;
 }
 
@@ -51,90 +50,131 @@ void VisitorIR::setCurrentBB(BasicBlock *bb)
     current_cfg->current_bb = bb;
 }
 
-// Parcours en profondeur post-ordre pour générer les blocs dans l'ordre d'exécution
-void postOrderDFS(BasicBlock *bb, std::set<BasicBlock *> &visited, std::vector<BasicBlock *> &postOrder)
+// Les instructions n'acceptent que des variables : un littéral est chargé dans un temporaire au
+// dernier moment, quand une instruction qui ne peut pas être repliée en a besoin
+string VisitorIR::materialize(const string &operand)
 {
-    if (!bb || visited.count(bb))
+    if (!IRInstr::is_constant(operand))
+        return operand;
+    string temp = createTempVar(Type::INT_TYPE);
+    current_bb->add_IRInstr(IRInstr::Operation::ldconst, Type::INT_TYPE, {temp, operand});
+    return temp;
+}
+
+// Opération binaire : si les deux opérandes sont des littéraux, le résultat est calculé ici avec la
+// sémantique C sur 32 bits (voir IRInstr::fold) ; une division par zéro n'est pas repliée et reste
+// une erreur à l'exécution
+string VisitorIR::emitBinary(IRInstr::Operation op, const string &left, const string &right)
+{
+    int32_t value;
+    if (IRInstr::is_constant(left) && IRInstr::is_constant(right) &&
+        IRInstr::fold(op, IRInstr::constant_value(left), IRInstr::constant_value(right), value))
     {
-        return;
+        return to_string(value);
     }
-    visited.insert(bb);
-    postOrderDFS(bb->exit_true, visited, postOrder);
-    postOrderDFS(bb->exit_false, visited, postOrder);
-    postOrder.push_back(bb);
+    string leftVar = materialize(left);
+    string rightVar = materialize(right);
+    string result = createTempVar(Type::INT_TYPE);
+    current_bb->add_IRInstr(op, Type::INT_TYPE, {result, leftVar, rightVar});
+    return result;
 }
 
-// Visite du nœud racine du programme : génère le code pour toutes les fonctions
-// 1. On visite chaque fonction pour construire son CFG (et donc son IR)
-// 2. On génère ensuite le code assembleur pour chaque CFG
-antlrcpp::Any VisitorIR::visitProg(ifccParser::ProgContext *ctx)
+// Fin du bloc courant : saut conditionnel sur cond, ou saut direct si cond est une constante
+void VisitorIR::emitBranch(const string &cond, BasicBlock *trueBB, BasicBlock *falseBB)
 {
-    // Générer le prologue global (section .text)
-    std::cout << "\t.text\n";
-
-    // Visiter toutes les fonctions pour construire les CFG (et donc l'IR)
-    for (auto func : ctx->function())
+    if (IRInstr::is_constant(cond))
     {
-        this->visit(func);
+        current_bb->exit_true = IRInstr::constant_value(cond) != 0 ? trueBB : falseBB;
+        return;
     }
+    current_bb->test_var_name = cond;
+    current_bb->exit_true = trueBB;
+    current_bb->exit_false = falseBB;
+    if (unlikelyBB == falseBB)
+        current_bb->expected_branch = 1;
+    else if (unlikelyBB == trueBB)
+        current_bb->expected_branch = 0;
+}
 
-    // Générer le code assembleur pour toutes les fonctions à partir des CFG
-    for (const auto &pair : cfgs)
+// Condition d'un if ou opérande d'un && / || : chaque opérande logique branche vers sa propre cible,
+// sans calculer de booléen ; "!c" échange les deux cibles. Dans __builtin_expect(e, c), les
+// branchements de e qui peuvent mener à la cible contraire à c sont marqués (BasicBlock::expected_branch)
+void VisitorIR::emitCondition(ifccParser::ExprContext *ctx, BasicBlock *trueBB, BasicBlock *falseBB)
+{
+    if (auto parens = dynamic_cast<ifccParser::ParensExprContext *>(ctx))
     {
-        std::string funcName = pair.first;
-        CFG *cfg = pair.second;
-
-// Déclarer la fonction comme globale
-#ifdef __APPLE__
-        // Pour macOS, main doit s'appeler _main
-        if (funcName == "main")
-        {
-            std::cout << "\t.globl\t_main\n";
-            std::cout << "_main:\n";
-        }
-        else
-        {
-            std::cout << "\t.globl\t" << funcName << "\n";
-            std::cout << funcName << ":\n";
-        }
-#else
-        // Pour Linux, main reste main
-        std::cout << "\t.globl\t" << funcName << "\n";
-        std::cout << funcName << ":\n";
-#endif
-
-        // Générer le prologue de la fonction (sauvegarde des registres, allocation de la pile)
-        cfg->gen_asm_prologue(std::cout);
-
-        // Générer le code de tous les blocs de base avec un tri topologique (reverse post-order)
-        std::vector<BasicBlock *> postOrder;
-        std::set<BasicBlock *> visited_bbs;
-        if (!cfg->get_bbs().empty())
-        {
-            postOrderDFS(cfg->get_bbs()[0], visited_bbs, postOrder);
-        }
-        std::reverse(postOrder.begin(), postOrder.end());
-
-        for (auto bb : postOrder)
+        emitCondition(parens->expr(), trueBB, falseBB);
+        return;
+    }
+    if (auto expect = dynamic_cast<ifccParser::ExpectExprContext *>(ctx))
+    {
+        bool expectTrue = expect->CONST()->getText().find_first_not_of('0') != string::npos;
+        BasicBlock *saved = unlikelyBB;
+        unlikelyBB = expectTrue ? falseBB : trueBB;
+        emitCondition(expect->expr(), trueBB, falseBB);
+        unlikelyBB = saved;
+        return;
+    }
+    if (auto unary = dynamic_cast<ifccParser::UnaryExprContext *>(ctx))
+    {
+        if (unary->children[0]->getText() == "!")
         {
-            bb->gen_asm(std::cout);
+            emitCondition(unary->expr(), falseBB, trueBB);
+            return;
         }
+    }
+    if (auto land = dynamic_cast<ifccParser::LogicalAndExprContext *>(ctx))
+    {
+        // a && b : b n'est évalué que si a est vrai
+        BasicBlock *rightBB = createNewBB();
+        emitCondition(land->expr(0), rightBB, falseBB);
+        setCurrentBB(rightBB);
+        emitCondition(land->expr(1), trueBB, falseBB);
+        return;
+    }
+    if (auto lor = dynamic_cast<ifccParser::LogicalOrExprContext *>(ctx))
+    {
+        // a || b : b n'est évalué que si a est faux
+        BasicBlock *rightBB = createNewBB();
+        emitCondition(lor->expr(0), trueBB, rightBB);
+        setCurrentBB(rightBB);
+        emitCondition(lor->expr(1), trueBB, falseBB);
+        return;
+    }
+    emitBranch(std::any_cast<string>(visit(ctx)), trueBB, falseBB);
+}
 
-        // Générer l'épilogue de la fonction (restaure la pile, retourne)
-        cfg->gen_asm_epilogue(std::cout);
+// Résultat d'un && / || utilisé comme valeur : une case écrite à 1 ou à 0 selon le bloc atteint,
+// relue dans le bloc de jonction (mem2reg en fait un phi)
+string VisitorIR::emitBoolean(BasicBlock *trueBB, BasicBlock *falseBB)
+{
+    string result = createTempVar(Type::INT_TYPE);
+    BasicBlock *joinBB = createNewBB();
+
+    setCurrentBB(trueBB);
+    current_bb->add_IRInstr(IRInstr::Operation::wmem, Type::INT_TYPE, {result, materialize("1")});
+    current_bb->exit_true = joinBB;
+    setCurrentBB(falseBB);
+    current_bb->add_IRInstr(IRInstr::Operation::wmem, Type::INT_TYPE, {result, materialize("0")});
+    current_bb->exit_true = joinBB;
+
+    setCurrentBB(joinBB);
+    string value = createTempVar(Type::INT_TYPE);
+    current_bb->add_IRInstr(IRInstr::Operation::rmem, Type::INT_TYPE, {value, result});
+    return value;
+}
 
-        // Ajouter les directives de taille pour la fonction
-#if defined(ARM)
-        // Do NOT emit .size for ARM/clang
-#elif !defined(__APPLE__)
-        std::cout << "\t.size\t" << funcName << ", .-" << funcName << "\n";
-#endif
+// Visite du nœud racine du programme : construit le CFG (et donc l'IR) de chaque fonction
+// Les passes d'optimisation puis la génération du code assembleur sont lancées ensuite par le driver
+// (voir main.cpp, PassManager et gen_asm_module)
+antlrcpp::Any VisitorIR::visitProg(ifccParser::ProgContext *ctx)
+{
+    // Visiter toutes les fonctions pour construire les CFG (et donc l'IR)
+    for (auto func : ctx->function())
+    {
+        this->visit(func);
     }
 
-#ifndef __APPLE__
-    std::cout << "\t.section\t.note.GNU-stack,\"\",@progbits\n";
-#endif
-
     return 0;
 }
 
@@ -165,6 +205,10 @@ antlrcpp::Any VisitorIR::visitFunction(ifccParser::FunctionContext *ctx)
 
     // Création de la structure de fonction (DefFonction) et du CFG associé
     DefFonction *func = new DefFonction(funcName, Type::INT_TYPE, params);
+    vector<string> specifiers;
+    for (auto spec : ctx->function_spec())
+        specifiers.push_back(spec->getText());
+    func->setInlineHint(readInlineSpecifiers(specifiers).hint);
     current_cfg = new CFG(func);
     cfgs[funcName] = current_cfg;
     currentFunctionName = funcName;
@@ -222,6 +266,11 @@ antlrcpp::Any VisitorIR::visitFunction(ifccParser::FunctionContext *ctx)
     // Visiter le corps de la fonction (bloc d'instructions)
     visit(ctx->block_stmt());
 
+    // Les blocs ouverts après un return (et les instructions qui y ont été placées) ne sont
+    // atteignables par aucun arc : ils ne doivent pas arriver jusqu'à la génération de code
+    current_cfg->remove_unreachable_bbs();
+    current_bb = nullptr;
+
     return 0;
 }
 
@@ -238,10 +287,7 @@ antlrcpp::Any VisitorIR::visitBlock_stmt(ifccParser::Block_stmtContext *ctx)
 // Visite d'un if/else : création de blocs pour chaque branche et gestion du contrôle
 antlrcpp::Any VisitorIR::visitIf_stmt(ifccParser::If_stmtContext *ctx)
 {
-    // 1. Évaluer l'expression de la condition
-    visit(ctx->expr());
-
-    // 2. Créer les blocs de base pour les branches then, else, et pour la suite
+    // 1. Créer les blocs de base pour les branches then, else, et pour la suite
     BasicBlock *then_bb = createNewBB();
     BasicBlock *after_if_bb = createNewBB();
     BasicBlock *else_bb = after_if_bb;
@@ -251,11 +297,11 @@ antlrcpp::Any VisitorIR::visitIf_stmt(ifccParser::If_stmtContext *ctx)
         else_bb = createNewBB();
     }
 
-    // 3. Le bloc courant se termine par un saut conditionnel
-    current_bb->exit_true = then_bb;
-    current_bb->exit_false = else_bb;
+    // 2. Évaluer la condition : le bloc courant (ou le dernier bloc d'un && / ||) se termine par un
+    //    saut conditionnel vers then ou else
+    emitCondition(ctx->expr(), then_bb, else_bb);
 
-    // 4. Générer le code pour le bloc 'then'
+    // 3. Générer le code pour le bloc 'then'
     setCurrentBB(then_bb);
     visit(ctx->stmt(0));
     if (current_bb->exit_true == nullptr && current_bb->exit_false == nullptr)
@@ -263,7 +309,7 @@ antlrcpp::Any VisitorIR::visitIf_stmt(ifccParser::If_stmtContext *ctx)
         current_bb->exit_true = after_if_bb; // Saut inconditionnel vers la suite
     }
 
-    // 5. Générer le code pour le bloc 'else' s'il existe
+    // 4. Générer le code pour le bloc 'else' s'il existe
     if (ctx->ELSE())
     {
         setCurrentBB(else_bb);
@@ -274,7 +320,7 @@ antlrcpp::Any VisitorIR::visitIf_stmt(ifccParser::If_stmtContext *ctx)
         }
     }
 
-    // 6. Continuer la génération de code dans le bloc qui suit le if
+    // 5. Continuer la génération de code dans le bloc qui suit le if
     setCurrentBB(after_if_bb);
 
     return 0;
@@ -293,7 +339,8 @@ antlrcpp::Any VisitorIR::visitReturn_stmt(ifccParser::Return_stmtContext *ctx)
         antlrcpp::Any result = visit(ctx->expr());
         try
         {
-            string resultStr = std::any_cast<string>(result);
+            // Une constante est chargée dans un temporaire
+            string resultStr = materialize(std::any_cast<string>(result));
 
             // Si le résultat est déjà dans une variable temporaire, l'utiliser directement
             if (resultStr[0] == '!')
@@ -315,7 +362,8 @@ antlrcpp::Any VisitorIR::visitReturn_stmt(ifccParser::Return_stmtContext *ctx)
     }
     else
     {
-        current_bb->add_IRInstr(IRInstr::Operation::ret, Type::INT_TYPE, {"!0"});
+        // return sans valeur : la fonction peut n'avoir aucune variable, !0 n'existe pas forcément
+        current_bb->add_IRInstr(IRInstr::Operation::ret, Type::INT_TYPE, {materialize("0")});
     }
 
     // Couper le basic block après un return
@@ -328,6 +376,7 @@ antlrcpp::Any VisitorIR::visitReturn_stmt(ifccParser::Return_stmtContext *ctx)
 // Visite d'une instruction expression (ex : appel de fonction, calcul)
 antlrcpp::Any VisitorIR::visitExpr_stmt(ifccParser::Expr_stmtContext *ctx)
 {
+    // Une expression constante sans effet de bord (ex : "1 + 2;") ne produit aucune instruction
     return visit(ctx->expr());
 }
 
@@ -348,7 +397,7 @@ antlrcpp::Any VisitorIR::visitDecl_stmt(ifccParser::Decl_stmtContext *ctx)
         antlrcpp::Any result = visit(ctx->expr());
         try
         {
-            string resultStr = std::any_cast<string>(result);
+            string resultStr = materialize(std::any_cast<string>(result));
             current_bb->add_IRInstr(IRInstr::Operation::wmem, Type::INT_TYPE, {"!" + to_string(varIndex), resultStr});
         }
         catch (const std::bad_any_cast &e)
@@ -387,11 +436,8 @@ antlrcpp::Any VisitorIR::visitConstExpr(ifccParser::ConstExprContext *ctx)
         return string("0");
     }
 
-    string value = ctx->CONST()->getText();
-    string result = createTempVar(Type::INT_TYPE);
-
-    current_bb->add_IRInstr(IRInstr::Operation::ldconst, Type::INT_TYPE, {result, value});
-    return result;
+    // Littéral replié : sa valeur sur 32 bits (un ldconst ne sera émis que si une instruction en a besoin)
+    return to_string(IRInstr::constant_value(ctx->CONST()->getText()));
 }
 
 // Visite d'un caractère (stocké comme un int)
@@ -406,11 +452,7 @@ antlrcpp::Any VisitorIR::visitCharExpr(ifccParser::CharExprContext *ctx)
     string charLiteral = ctx->CHAR_LITERAL()->getText();
     // Extraire le caractère entre les guillemets simples
     char character = charLiteral[1]; // Le caractère est à l'index 1
-    string value = to_string((int)character); // Convertir en valeur ASCII
-    
-    string result = createTempVar(Type::INT_TYPE);
-    current_bb->add_IRInstr(IRInstr::Operation::ldconst, Type::INT_TYPE, {result, value});
-    return result;
+    return to_string((int)character); // Valeur ASCII, repliée comme une constante entière
 }
 
 // Visite d'une assignation (variable = expression ou assignation chaînée)
@@ -432,7 +474,7 @@ antlrcpp::Any VisitorIR::visitAssignExpr(ifccParser::AssignExprContext *ctx)
         // Cas simple : variable = expression
         string varName = varExpr->VAR()->getText();
         int varIndex = current_cfg->get_var_index(varName);
-        current_bb->add_IRInstr(IRInstr::Operation::wmem, Type::INT_TYPE, {"!" + to_string(varIndex), rightStr});
+        current_bb->add_IRInstr(IRInstr::Operation::wmem, Type::INT_TYPE, {"!" + to_string(varIndex), materialize(rightStr)});
         return rightStr;
     }
     else
@@ -457,7 +499,6 @@ antlrcpp::Any VisitorIR::visitAdditiveExpr(ifccParser::AdditiveExprContext *ctx)
         return string("0");
     }
 
-    string result = createTempVar(Type::INT_TYPE);
     antlrcpp::Any leftResult = visit(ctx->expr(0));
     antlrcpp::Any rightResult = visit(ctx->expr(1));
 
@@ -469,8 +510,7 @@ antlrcpp::Any VisitorIR::visitAdditiveExpr(ifccParser::AdditiveExprContext *ctx)
         string op = ctx->children[1]->getText();
         IRInstr::Operation operation = (op == "+") ? IRInstr::Operation::add : IRInstr::Operation::sub;
 
-        current_bb->add_IRInstr(operation, Type::INT_TYPE, {result, leftStr, rightStr});
-        return result;
+        return emitBinary(operation, leftStr, rightStr);
     }
     catch (const std::bad_any_cast &e)
     {
@@ -488,7 +528,6 @@ antlrcpp::Any VisitorIR::visitMultiplicativeExpr(ifccParser::MultiplicativeExprC
         return string("0");
     }
 
-    string result = createTempVar(Type::INT_TYPE);
     antlrcpp::Any leftResult = visit(ctx->expr(0));
     antlrcpp::Any rightResult = visit(ctx->expr(1));
 
@@ -508,8 +547,7 @@ antlrcpp::Any VisitorIR::visitMultiplicativeExpr(ifccParser::MultiplicativeExprC
         else
             throw std::runtime_error("Opération multiplicative inconnue");
 
-        current_bb->add_IRInstr(operation, Type::INT_TYPE, {result, leftStr, rightStr});
-        return result;
+        return emitBinary(operation, leftStr, rightStr);
     }
     catch (const std::bad_any_cast &e)
     {
@@ -529,27 +567,24 @@ antlrcpp::Any VisitorIR::visitUnaryExpr(ifccParser::UnaryExprContext *ctx)
 
     antlrcpp::Any operandResult = visit(ctx->expr());
     string operandVar = std::any_cast<string>(operandResult);
-    string resultVar = createTempVar(Type::INT_TYPE);
 
     string op = ctx->children[0]->getText();
-    if (op == "-")
+    if (op == "+")
     {
-        // Pour un moins unaire, on multiplie par -1
-        string constVar = createTempVar(Type::INT_TYPE);
-        current_bb->add_IRInstr(IRInstr::Operation::ldconst, Type::INT_TYPE, {constVar, "-1"});
-        current_bb->add_IRInstr(IRInstr::Operation::mul, Type::INT_TYPE, {resultVar, operandVar, constVar});
+        // Pour un plus unaire, la valeur est inchangée
+        return operandVar;
     }
-    else if (op == "+")
-    {
-        // Pour un plus unaire, on copie simplement la valeur
-        current_bb->add_IRInstr(IRInstr::Operation::rmem, Type::INT_TYPE, {resultVar, operandVar});
-    }
-    else if (op == "!")
+    if (op == "-")
     {
-        // Pour la négation logique, on utilise l'opération NOT
-        current_bb->add_IRInstr(IRInstr::Operation::not_op, Type::INT_TYPE, {resultVar, operandVar});
+        // Moins unaire : 0 - x (replié si x est constant, avec débordement modulo 2^32 comme -INT_MIN)
+        return emitBinary(IRInstr::Operation::sub, "0", operandVar);
     }
 
+    // Négation logique : opération NOT, ou 0/1 si l'opérande est constant
+    if (IRInstr::is_constant(operandVar))
+        return to_string(IRInstr::constant_value(operandVar) == 0);
+    string resultVar = createTempVar(Type::INT_TYPE);
+    current_bb->add_IRInstr(IRInstr::Operation::not_op, Type::INT_TYPE, {resultVar, operandVar});
     return resultVar;
 }
 
@@ -559,6 +594,12 @@ antlrcpp::Any VisitorIR::visitParensExpr(ifccParser::ParensExprContext *ctx)
     return visit(ctx->expr());
 }
 
+// Visite de __builtin_expect(e, c) hors d'une condition : vaut e (l'annonce ne sert qu'aux branchements)
+antlrcpp::Any VisitorIR::visitExpectExpr(ifccParser::ExpectExprContext *ctx)
+{
+    return visit(ctx->expr());
+}
+
 // Visite d'un appel de fonction
 antlrcpp::Any VisitorIR::visitCallExpr(ifccParser::CallExprContext *ctx)
 {
@@ -620,7 +661,7 @@ antlrcpp::Any VisitorIR::visitArg_list(ifccParser::Arg_listContext *ctx)
     for (auto expr : ctx->expr())
     {
         antlrcpp::Any argResult = visit(expr);
-        string argStr = std::any_cast<string>(argResult);
+        string argStr = materialize(std::any_cast<string>(argResult));
         args.push_back(argStr);
     }
 
@@ -646,9 +687,7 @@ antlrcpp::Any VisitorIR::visitEqualityExpr(ifccParser::EqualityExprContext *ctx)
     else
         throw std::runtime_error("Opérateur d'égalité inconnu");
 
-    string result = createTempVar(Type::INT_TYPE);
-    current_bb->add_IRInstr(operation, Type::INT_TYPE, {result, leftStr, rightStr});
-    return result;
+    return emitBinary(operation, leftStr, rightStr);
 }
 
 // Visite d'une comparaison (<, >, <=, >=)
@@ -674,9 +713,7 @@ antlrcpp::Any VisitorIR::visitRelationalExpr(ifccParser::RelationalExprContext *
     else
         throw std::runtime_error("Opérateur de comparaison inconnu");
 
-    string result = createTempVar(Type::INT_TYPE);
-    current_bb->add_IRInstr(operation, Type::INT_TYPE, {result, leftStr, rightStr});
-    return result;
+    return emitBinary(operation, leftStr, rightStr);
 }
 
 // Visite d'un ET binaire (&)
@@ -688,7 +725,6 @@ antlrcpp::Any VisitorIR::visitBitwiseAndExpr(ifccParser::BitwiseAndExprContext *
         return string("0");
     }
 
-    string result = createTempVar(Type::INT_TYPE);
     antlrcpp::Any leftResult = visit(ctx->expr(0));
     antlrcpp::Any rightResult = visit(ctx->expr(1));
 
@@ -697,8 +733,7 @@ antlrcpp::Any VisitorIR::visitBitwiseAndExpr(ifccParser::BitwiseAndExprContext *
         string leftStr = std::any_cast<string>(leftResult);
         string rightStr = std::any_cast<string>(rightResult);
 
-        current_bb->add_IRInstr(IRInstr::Operation::bit_and, Type::INT_TYPE, {result, leftStr, rightStr});
-        return result;
+        return emitBinary(IRInstr::Operation::bit_and, leftStr, rightStr);
     }
     catch (const std::bad_any_cast &e)
     {
@@ -716,7 +751,6 @@ antlrcpp::Any VisitorIR::visitBitwiseXorExpr(ifccParser::BitwiseXorExprContext *
         return string("0");
     }
 
-    string result = createTempVar(Type::INT_TYPE);
     antlrcpp::Any leftResult = visit(ctx->expr(0));
     antlrcpp::Any rightResult = visit(ctx->expr(1));
 
@@ -725,8 +759,7 @@ antlrcpp::Any VisitorIR::visitBitwiseXorExpr(ifccParser::BitwiseXorExprContext *
         string leftStr = std::any_cast<string>(leftResult);
         string rightStr = std::any_cast<string>(rightResult);
 
-        current_bb->add_IRInstr(IRInstr::Operation::bit_xor, Type::INT_TYPE, {result, leftStr, rightStr});
-        return result;
+        return emitBinary(IRInstr::Operation::bit_xor, leftStr, rightStr);
     }
     catch (const std::bad_any_cast &e)
     {
@@ -744,7 +777,6 @@ antlrcpp::Any VisitorIR::visitBitwiseOrExpr(ifccParser::BitwiseOrExprContext *ct
         return string("0");
     }
 
-    string result = createTempVar(Type::INT_TYPE);
     antlrcpp::Any leftResult = visit(ctx->expr(0));
     antlrcpp::Any rightResult = visit(ctx->expr(1));
 
@@ -753,8 +785,7 @@ antlrcpp::Any VisitorIR::visitBitwiseOrExpr(ifccParser::BitwiseOrExprContext *ct
         string leftStr = std::any_cast<string>(leftResult);
         string rightStr = std::any_cast<string>(rightResult);
 
-        current_bb->add_IRInstr(IRInstr::Operation::bit_or, Type::INT_TYPE, {result, leftStr, rightStr});
-        return result;
+        return emitBinary(IRInstr::Operation::bit_or, leftStr, rightStr);
     }
     catch (const std::bad_any_cast &e)
     {
@@ -763,7 +794,7 @@ antlrcpp::Any VisitorIR::visitBitwiseOrExpr(ifccParser::BitwiseOrExprContext *ct
     }
 }
 
-// Visite d'un ET logique paresseux (&&)
+// Visite d'un ET logique paresseux (&&) utilisé comme valeur
 antlrcpp::Any VisitorIR::visitLogicalAndExpr(ifccParser::LogicalAndExprContext *ctx)
 {
     if (current_cfg == nullptr)
@@ -772,27 +803,26 @@ antlrcpp::Any VisitorIR::visitLogicalAndExpr(ifccParser::LogicalAndExprContext *
         return string("0");
     }
 
-    string result = createTempVar(Type::INT_TYPE);
-    antlrcpp::Any leftResult = visit(ctx->expr(0));
-    antlrcpp::Any rightResult = visit(ctx->expr(1));
-
-    try
+    // Opérande gauche constant : 0 && b vaut 0 sans évaluer b, 1 && b vaut b != 0
+    string leftStr = std::any_cast<string>(visit(ctx->expr(0)));
+    if (IRInstr::is_constant(leftStr))
     {
-        string leftStr = std::any_cast<string>(leftResult);
-        string rightStr = std::any_cast<string>(rightResult);
-
-        // Pour l'opérateur && paresseux, on utilise l'opération logical_and
-        current_bb->add_IRInstr(IRInstr::Operation::logical_and, Type::INT_TYPE, {result, leftStr, rightStr});
-        return result;
-    }
-    catch (const std::bad_any_cast &e)
-    {
-        // Erreur de cast (ne devrait pas arriver)
-        return string("0");
+        if (IRInstr::constant_value(leftStr) == 0)
+            return string("0");
+        return emitBinary(IRInstr::Operation::cmp_ne, std::any_cast<string>(visit(ctx->expr(1))), "0");
     }
+
+    // Sinon b est évalué dans son propre bloc, atteint seulement si a est vrai
+    BasicBlock *rightBB = createNewBB();
+    BasicBlock *trueBB = createNewBB();
+    BasicBlock *falseBB = createNewBB();
+    emitBranch(leftStr, rightBB, falseBB);
+    setCurrentBB(rightBB);
+    emitCondition(ctx->expr(1), trueBB, falseBB);
+    return emitBoolean(trueBB, falseBB);
 }
 
-// Visite d'un OU logique paresseux (||)
+// Visite d'un OU logique paresseux (||) utilisé comme valeur
 antlrcpp::Any VisitorIR::visitLogicalOrExpr(ifccParser::LogicalOrExprContext *ctx)
 {
     if (current_cfg == nullptr)
@@ -801,22 +831,21 @@ antlrcpp::Any VisitorIR::visitLogicalOrExpr(ifccParser::LogicalOrExprContext *ct
         return string("0");
     }
 
-    string result = createTempVar(Type::INT_TYPE);
-    antlrcpp::Any leftResult = visit(ctx->expr(0));
-    antlrcpp::Any rightResult = visit(ctx->expr(1));
-
-    try
+    // Opérande gauche constant : 1 || b vaut 1 sans évaluer b, 0 || b vaut b != 0
+    string leftStr = std::any_cast<string>(visit(ctx->expr(0)));
+    if (IRInstr::is_constant(leftStr))
     {
-        string leftStr = std::any_cast<string>(leftResult);
-        string rightStr = std::any_cast<string>(rightResult);
-
-        // Pour l'opérateur || paresseux, on utilise l'opération logical_or
-        current_bb->add_IRInstr(IRInstr::Operation::logical_or, Type::INT_TYPE, {result, leftStr, rightStr});
-        return result;
-    }
-    catch (const std::bad_any_cast &e)
-    {
-        // Erreur de cast (ne devrait pas arriver)
-        return string("0");
+        if (IRInstr::constant_value(leftStr) != 0)
+            return string("1");
+        return emitBinary(IRInstr::Operation::cmp_ne, std::any_cast<string>(visit(ctx->expr(1))), "0");
     }
+
+    // Sinon b est évalué dans son propre bloc, atteint seulement si a est faux
+    BasicBlock *rightBB = createNewBB();
+    BasicBlock *trueBB = createNewBB();
+    BasicBlock *falseBB = createNewBB();
+    emitBranch(leftStr, trueBB, rightBB);
+    setCurrentBB(rightBB);
+    emitCondition(ctx->expr(1), trueBB, falseBB);
+    return emitBoolean(trueBB, falseBB);
 }
\ No newline at end of file
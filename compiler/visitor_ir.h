@@ -5,22 +5,13 @@
 #include "antlr4-runtime.h"
 #include "generated/ifccBaseVisitor.h"
 #include "IR.h"
+#include "DefFonction.h" // Pour la structure Param
 #include "type.h"
 #include <map>
 #include <string>
 #include <vector>
 #include <set>
 
-// Structure pour représenter un paramètre de fonction
-// Permet de stocker le nom et le type de chaque paramètre
-struct Param
-{
-    std::string name;
-    Type type;
-
-    Param(const std::string &n, Type t) : name(n), type(t) {}
-};
-
 // Visiteur ANTLR pour générer l'IR à partir de l'AST
 // Ce visiteur fait le lien entre le front-end (AST) et le middle-end (IR/CFG)
 class VisitorIR : public ifccBaseVisitor
@@ -36,6 +27,8 @@ private:
     int nextBBnumber;
     // Nom de la fonction courante
     string currentFunctionName;
+    // Cible annoncée improbable par le __builtin_expect dont la condition est en cours d'émission
+    BasicBlock *unlikelyBB;
 
     // Méthodes utilitaires internes
     std::string createTempVar(Type t); // Crée une variable temporaire dans l'IR
@@ -43,16 +36,30 @@ private:
     BasicBlock *createNewBB(); // Crée un nouveau BasicBlock
     void setCurrentBB(BasicBlock *bb); // Change le BasicBlock courant
 
+    // Repliement des constantes : une expression constante est représentée par sa valeur littérale
+    // ("42") au lieu d'un temporaire ; seul le calcul qui reste non constant est ajouté au BasicBlock
+    std::string materialize(const std::string &operand); // Charge un littéral dans un temporaire (ldconst)
+    std::string emitBinary(IRInstr::Operation op, const std::string &left, const std::string &right); // Replie ou émet "left op right"
+
+    // Évaluation paresseuse de && et || : l'opérande droit est dans un bloc à part, atteint seulement
+    // si l'opérande gauche ne suffit pas à décider ; une condition de if branche directement
+    void emitBranch(const std::string &cond, BasicBlock *trueBB, BasicBlock *falseBB); // Termine le bloc courant sur cond
+    void emitCondition(ifccParser::ExprContext *ctx, BasicBlock *trueBB, BasicBlock *falseBB); // Saute vers trueBB ou falseBB
+    std::string emitBoolean(BasicBlock *trueBB, BasicBlock *falseBB); // Valeur 1/0 selon le bloc atteint
+
 public:
     // Constructeur par défaut
-    VisitorIR() : current_cfg(nullptr), current_bb(nullptr), nextBBnumber(0) {}
+    VisitorIR() : current_cfg(nullptr), current_bb(nullptr), nextBBnumber(0), unlikelyBB(nullptr) {}
 
     // Constructeur avec paramètre (pour initialiser la table des symboles si besoin)
     VisitorIR(const map<string, int> &symbols)
-        : current_cfg(nullptr), current_bb(nullptr), nextBBnumber(0) {}
+        : current_cfg(nullptr), current_bb(nullptr), nextBBnumber(0), unlikelyBB(nullptr) {}
 
     ~VisitorIR(); // Libère la mémoire des CFGs
 
+    // Récupère tous les CFG du programme (pour les passes d'optimisation et la génération de code)
+    Module &getCFGs() { return cfgs; }
+
     // Récupère le CFG d'une fonction (pour la génération de code)
     CFG *getCFG(const std::string &functionName) const
     {
@@ -77,6 +84,7 @@ public:
     virtual antlrcpp::Any visitUnaryExpr(ifccParser::UnaryExprContext *ctx) override; // -, +, !
     virtual antlrcpp::Any visitParensExpr(ifccParser::ParensExprContext *ctx) override; // parenthèses
     virtual antlrcpp::Any visitFunction(ifccParser::FunctionContext *ctx) override; // fonction
+    virtual antlrcpp::Any visitExpectExpr(ifccParser::ExpectExprContext *ctx) override; // __builtin_expect
     virtual antlrcpp::Any visitCallExpr(ifccParser::CallExprContext *ctx) override; // appel de fonction
     virtual antlrcpp::Any visitParam_list(ifccParser::Param_listContext *ctx) override; // liste de paramètres
     virtual antlrcpp::Any visitArg_list(ifccParser::Arg_listContext *ctx) override; // liste d'arguments
@@ -0,0 +1,7 @@
+int main() {
+    int a = -7 / 2 + -7 % 2 * 10;
+    int b = 2147483647 + 1 == -2147483647 - 1;
+    int c = !(3 & 5) + (6 ^ 3) - (1 | 8);
+    int d = a * 0 + (1 < 2) + (2 >= 3) + -(-c);
+    return a + b + c + d + 'A' - 60;
+}
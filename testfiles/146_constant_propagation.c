@@ -0,0 +1,22 @@
+int pick(int x) {
+    int a = 3;
+    int b;
+    if (a > 2) {
+        b = (a * 2);
+    } else {
+        b = x;
+    }
+    if (b == 6) {
+        b = (b + x);
+    }
+    return b;
+}
+
+int main() {
+    int c = 10;
+    int d = (c / 3);
+    if (d - 3) {
+        return 1;
+    }
+    return pick(d);
+}
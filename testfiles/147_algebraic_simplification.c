@@ -0,0 +1,13 @@
+int f(int x, int y) {
+    int a = ((x + 0) * 1);
+    int b = ((a - a) + (y ^ y));
+    int c = ((((x + 1) + 2) - 5) * 2);
+    int d = (!(x < y) + !!x + !!(x == y));
+    int e = ((3 * y) | 0);
+    int g = ((x & x) + (x % 1) + (x / 1));
+    return a + b + c + d + e + g;
+}
+
+int main() {
+    return f(9, 7) + f(-3, 4);
+}
@@ -0,0 +1,15 @@
+#include <stdio.h>
+
+int f(int a, int b) {
+    int x = ((a * b) + (b * a));
+    int y = ((a - b) * (a - b));
+    putchar(48 + (x % 10));
+    int z = ((a * b) - a);
+    return x + y + z;
+}
+
+int main() {
+    int r = f(3, 4);
+    putchar(10);
+    return r;
+}
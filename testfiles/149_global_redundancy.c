@@ -0,0 +1,27 @@
+int f(int a, int b) {
+    int s = ((a * b) + 1);
+    int t = 0;
+    if (a > b) {
+        t = ((a * b) + 1);
+    } else {
+        t = ((b * a) + 2);
+    }
+    if ((a * b) == 12) {
+        t = (t + (a * b));
+    }
+    return s + t + (a * b);
+}
+
+int g(int a, int b) {
+    int t = 0;
+    if (a > b) {
+        t = ((a - b) * 2);
+    } else {
+        t = ((a - b) + 7);
+    }
+    return t + (a - b);
+}
+
+int main() {
+    return f(3, 4) + f(5, 1) + g(9, 2) + g(1, 6);
+}
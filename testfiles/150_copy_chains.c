@@ -0,0 +1,20 @@
+int order(int a, int b) {
+    int lo = a;
+    int hi = b;
+    if (a > b) {
+        int t = lo;
+        lo = hi;
+        hi = t;
+    }
+    int r = ((hi * 10) + lo);
+    int s = +r;
+    int u = s;
+    return u;
+}
+
+int main() {
+    int x = 7;
+    int y = x;
+    int z = +y;
+    return order(z, 3) + order(2, z);
+}
@@ -0,0 +1,16 @@
+int f(int a, int b) {
+    int c = (a * b);
+    a + b;
+    (a * 3) - b;
+    if (a > 100) {
+        return 1;
+        c = 5;
+    }
+    return c;
+    a = 4;
+}
+int main() {
+    int x = 2;
+    x * x;
+    return f(x, 5);
+}
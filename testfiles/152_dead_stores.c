@@ -0,0 +1,18 @@
+int pick(int x) {
+    int a = 1;
+    a = 2;
+    int b = a;
+    if (x > b) {
+        b = (x + a);
+        b = (b * 2);
+    } else {
+        a = x;
+    }
+    return b + a;
+}
+
+int main() {
+    int r = pick(5);
+    r = (r + pick(1));
+    return r;
+}
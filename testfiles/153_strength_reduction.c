@@ -0,0 +1,25 @@
+#include <stdio.h>
+
+int scale(int x) {
+    int a = x * 10;
+    int b = x * -7;
+    int c = x * 16;
+    return a + b + c;
+}
+
+int split(int x) {
+    int q = x / 7;
+    int r = x % 7;
+    int h = x / -4;
+    int m = x % 8;
+    return (q * 1000) + (r * 100) + (h * 10) + m;
+}
+
+int main() {
+    int s = scale(-3) + scale(5);
+    int t = split(-1234) + split(987);
+    int u = (t / 100) % 13;
+    putchar(48 + u);
+    putchar(10);
+    return (s + t) % 256;
+}
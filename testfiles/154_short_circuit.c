@@ -0,0 +1,25 @@
+#include <stdio.h>
+
+int g(int tag, int v) {
+    putchar(tag);
+    return v;
+}
+
+int main() {
+    int a = g(65, 0) && g(66, 1);
+    int b = g(67, 1) || g(68, 0);
+    int c = g(69, 1) && g(70, 2) && g(71, 0);
+    if (g(72, 0) || (g(73, 1) && !g(74, 0))) {
+        putchar(75);
+    } else {
+        putchar(76);
+    }
+    if (!(g(77, 1) || g(78, 1))) {
+        putchar(79);
+    }
+    int d = 0 && g(80, 1);
+    int e = 1 || g(81, 1);
+    int f = 1 && g(82, 5);
+    putchar(10);
+    return (a * 1) + (b * 2) + (c * 4) + (d * 8) + (e * 16) + (f * 32);
+}
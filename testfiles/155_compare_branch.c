@@ -0,0 +1,32 @@
+int classify(int a, int b) {
+    int r = 0;
+    if (a < b) {
+        r = (r + 1);
+    }
+    if (a <= b) {
+        r = (r + 2);
+    }
+    if (a > b) {
+        r = (r + 4);
+    }
+    if (a >= b) {
+        r = (r + 8);
+    }
+    if (a == b) {
+        r = (r + 16);
+    }
+    if (a != b) {
+        r = (r + 32);
+    } else {
+        r = (r + 64);
+    }
+    int keep = a < b;
+    if (keep) {
+        r = (r + 128);
+    }
+    return r + keep;
+}
+
+int main() {
+    return classify(1, 2) + classify(2, 2) + classify(-3, -7);
+}
@@ -0,0 +1,72 @@
+int max(int a, int b) {
+    int m;
+    if (a > b) {
+        m = a;
+    } else {
+        m = b;
+    }
+    return m;
+}
+
+int min(int a, int b) {
+    if (a <= b) {
+        return a;
+    }
+    return b;
+}
+
+int absolute(int x) {
+    if (x < 0) {
+        x = -x;
+    }
+    return x;
+}
+
+int sign(int x) {
+    int s = 0;
+    if (x > 0) {
+        s = 1;
+    }
+    if (x < 0) {
+        s = -1;
+    }
+    return s;
+}
+
+int clamp(int v, int lo, int hi) {
+    if (v < lo) {
+        v = lo;
+    }
+    if (v > hi) {
+        v = hi;
+    }
+    return v;
+}
+
+int pick(int c, int a, int b) {
+    int r;
+    if (c) {
+        r = (a * 3 + 1);
+    } else {
+        r = (b - a);
+    }
+    return r;
+}
+
+int guarded(int a, int b) {
+    int q = 0;
+    if (b != 0) {
+        q = (a / b);
+    }
+    return q;
+}
+
+int main() {
+    int r = max(3, 9) + max(-2, -5) + min(4, 4) + min(7, -1);
+    r = (r + absolute(-6) + absolute(5) + absolute(0));
+    r = (r + sign(12) * 100 + sign(-3) * 10 + sign(0));
+    r = (r + clamp(-50, 0, 10) + clamp(50, 0, 10) + clamp(4, 0, 10));
+    r = (r + pick(1, 2, 3) + pick(0, 2, 3));
+    r = (r + guarded(17, 5) + guarded(17, 0));
+    return r;
+}
@@ -0,0 +1,43 @@
+#include <stdio.h>
+
+int tick(int v) {
+    putchar(65 + v);
+    return v;
+}
+
+int chain(int a) {
+    int r = 1;
+    if (a > 0) {
+    }
+    if (a > 1) {
+        if (a > 2) {
+        }
+    } else {
+    }
+    if (1) {
+        r = (r + a);
+    }
+    if (0) {
+        r = 100;
+    }
+    return r;
+}
+
+int both(int a, int b) {
+    int x = a && b;
+    if (x) {
+        return 10;
+    }
+    int y = a || tick(b);
+    if (y) {
+        return 20;
+    }
+    return 30;
+}
+
+int main() {
+    int r = chain(5) + chain(-1);
+    r = (r + both(1, 1) + both(1, 0) + both(0, 0) + both(0, 7));
+    putchar(10);
+    return r;
+}
@@ -0,0 +1,32 @@
+#include <stdio.h>
+
+int check(int x) {
+    if (x < 0) {
+        putchar(33);
+        return -1;
+    }
+    if (__builtin_expect(x == 13, 0)) {
+        return -2;
+    }
+    return x;
+}
+
+int scale(int a, int b) {
+    int r = 0;
+    if (__builtin_expect(a > 2 && b != 0, 1)) {
+        r = (a * b);
+    } else {
+        r = (a + b);
+    }
+    if (!__builtin_expect(r, 1)) {
+        putchar(90);
+    }
+    return r + __builtin_expect(b, -1);
+}
+
+int main() {
+    int r = check(5) + check(-4) + check(13);
+    r = (r + scale(3, 4) + scale(1, 2) + scale(0, 0) + scale(5, 0));
+    putchar(10);
+    return r;
+}
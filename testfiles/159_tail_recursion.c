@@ -0,0 +1,43 @@
+#include <stdio.h>
+
+int fact(int n) {
+    if (n <= 1) {
+        return 1;
+    }
+    return n * fact(n - 1);
+}
+
+int sum(int n, int acc) {
+    if (n == 0) {
+        return acc;
+    }
+    return sum(n - 1, acc + n);
+}
+
+int count(int n) {
+    if (n == 0) {
+        return 0;
+    }
+    return 1 + count(n - 1);
+}
+
+int show(int c) {
+    putchar(c);
+    return c;
+}
+
+int last(int n) {
+    if (n > 3) {
+        return show(64 + n);
+    }
+    return show(48 + n);
+}
+
+int main() {
+    int r = (fact(5) - 100);
+    r = (r + sum(20000, 0) % 97);
+    r = (r + count(20000) % 89);
+    r = (r + last(2) + last(7));
+    putchar(10);
+    return r % 256;
+}
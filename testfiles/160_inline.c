@@ -0,0 +1,32 @@
+#include <stdio.h>
+
+inline __attribute__((always_inline)) int clamp(int v, int lo, int hi) {
+    if (v < lo) {
+        return lo;
+    }
+    if (v > hi) {
+        return hi;
+    }
+    return v;
+}
+
+int __attribute__((noinline)) twice(int v) {
+    return v + v;
+}
+
+int add(int a, int b) {
+    return a + b;
+}
+
+int mix(int a) {
+    int r = add(a, 3);
+    r = (r + twice(a));
+    return clamp(r, 0, 100);
+}
+
+int main() {
+    int s = mix(5) + mix(40) + mix(-20);
+    putchar(65 + clamp(s, 0, 25));
+    putchar(10);
+    return s;
+}
@@ -0,0 +1,37 @@
+#include <stdio.h>
+
+int __attribute__((noinline)) scale(int v, int k) {
+    if (k == 0) {
+        return v;
+    }
+    if (k > 3) {
+        return (v * k) - (k / 2);
+    }
+    return (v * k) + (k % 2);
+}
+
+int __attribute__((noinline)) shift(int v, int base, int mode) {
+    int r = v;
+    if (mode == 1) {
+        r = (r + base * 3);
+    } else {
+        if (mode == 2) {
+            r = (r - base);
+        } else {
+            r = (r * (base + mode));
+        }
+    }
+    if (r > 200) {
+        r = (r % 200);
+    }
+    return r;
+}
+
+int main() {
+    int s = scale(3, 4) + scale(10, 4) + scale(7, 4);
+    s = (s + shift(s, 2, 1) + shift(5, 7, 1) + shift(9, 1, 1));
+    s = (s + shift(4, 3, 2) + shift(s, 5, 3));
+    putchar(48 + s % 10);
+    putchar(10);
+    return s % 256;
+}
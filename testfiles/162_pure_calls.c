@@ -0,0 +1,44 @@
+#include <stdio.h>
+
+int __attribute__((noinline)) square(int x) {
+    return (x * x);
+}
+
+int show(int c) {
+    putchar(c);
+    return c;
+}
+
+int weight(int n) {
+    if (n <= 0) {
+        return 0;
+    }
+    return n + weight(n - 1);
+}
+
+int steps(int n) {
+    if (n == 0) {
+        return 0;
+    }
+    return steps(n - 1) + square(n);
+}
+
+int scaled(int n, int k, int acc) {
+    if (n == 0) {
+        return acc;
+    }
+    return scaled(n - 1, k, acc + square(k));
+}
+
+int main() {
+    int a = 7;
+    int r = (square(a) + square(a));
+    square(3);
+    show(65);
+    show(66);
+    r = (r + weight(10) + weight(10));
+    r = (r + steps(5));
+    r = (r + scaled(4, 3, 0));
+    putchar(10);
+    return r % 256;
+}
@@ -38,6 +38,9 @@ argparser.add_argument('-d', '--debug', action="count", default=0, help='debug m
 argparser.add_argument('-S', action="store_true", help='compile to assembly only')
 argparser.add_argument('-c', action="store_true", help='compile to object file only')
 argparser.add_argument('-o', '--output', metavar='OUTPUTNAME', help='name of output file')
+argparser.add_argument('--ifcc-args', metavar='ARGS', default='', help='extra arguments passed to ifcc (e.g. "-O2")')
+argparser.add_argument('--run', action="store_const", const='interp', help='run IFCC programs with "ifcc --run" (interpreter) instead of assembling and linking them')
+argparser.add_argument('--jit', dest='run', action="store_const", const='jit', help='same as --run, with the in-memory x86-64 JIT ("ifcc --run=jit")')
 
 args = argparser.parse_args()
 orig_cwd = os.getcwd()
@@ -50,6 +53,7 @@ if args.debug >= 2:
 
 pld_base_dir = os.path.abspath(os.path.join(os.path.dirname(__file__), '..'))
 IFCC = os.path.join(pld_base_dir, 'compiler', 'ifcc')
+IFCC_CMD = f'{IFCC} {args.ifcc_args}'.strip()
 
 if args.debug:
     print("Base dir =", pld_base_dir)
@@ -120,14 +124,14 @@ if args.S or args.c or args.output:
         if not args.output.endswith(".s"):
             print(RED("❌ error: output file must end with .s"))
             sys.exit(1)
-        sys.exit(run_command(f'{IFCC} {inputfile} > {args.output}', toscreen=True))
+        sys.exit(run_command(f'{IFCC_CMD} {inputfile} > {args.output}', toscreen=True))
 
     if args.c:
         if not args.output.endswith(".o"):
             print(RED("❌ error: output file must end with .o"))
             sys.exit(1)
         asm = args.output.replace(".o", ".s")
-        if run_command(f'{IFCC} {inputfile} > {asm}', toscreen=True):
+        if run_command(f'{IFCC_CMD} {inputfile} > {asm}', toscreen=True):
             sys.exit(1)
         sys.exit(run_command(f'gcc -c -o {args.output} {asm}', toscreen=True))
 
@@ -136,7 +140,7 @@ if args.S or args.c or args.output:
         sys.exit(1)
 
     asm = args.output + ".s"
-    if run_command(f'{IFCC} {inputfile} > {asm}', toscreen=True):
+    if run_command(f'{IFCC_CMD} {inputfile} > {asm}', toscreen=True):
         sys.exit(1)
     sys.exit(run_command(f'gcc -o {args.output} {asm}', toscreen=True))
 
@@ -195,7 +199,11 @@ for job in jobs:
 
     if args.verbose >= 2:
         status("Compiling with IFCC (to assembly)...", icon="🛠️", color_func=BLUE)
-    ifcc_ok = run_command(f'{IFCC} input.c > asm-ifcc.s', "ifcc-compile.txt") == 0
+    if args.run:
+        # Le programme est seulement traduit en IR : ifcc --run ne distingue pas un refus d'un code de sortie 1
+        ifcc_ok = run_command(f'{IFCC_CMD} --emit=ir input.c > ir-ifcc.txt', "ifcc-compile.txt") == 0
+    else:
+        ifcc_ok = run_command(f'{IFCC_CMD} input.c > asm-ifcc.s', "ifcc-compile.txt") == 0
 
     if not gcc_ok and not ifcc_ok:
         if args.verbose:
@@ -212,6 +220,20 @@ for job in jobs:
         num_failed += 1
         continue
 
+    if args.run:
+        if args.verbose >= 2:
+            status(f"Running with IFCC ({args.run})...", icon="▶️", color_func=BLUE)
+        run_command(f'{IFCC_CMD} --run={args.run} input.c', "ifcc-execute.txt")
+        if open("gcc-execute.txt").read() != open("ifcc-execute.txt").read():
+            print(RED(f"❌ TEST FAIL (different outputs at runtime): {job}"))
+            all_ok = False
+            num_failed += 1
+            continue
+        if args.verbose:
+            status(f"Test job passed: {job}", icon="✅", color_func=GREEN)
+        num_passed += 1
+        continue
+
     if args.verbose >= 2:
         status("Linking IFCC output with GCC...", icon="🛠️", color_func=BLUE)
     if run_command("gcc -o exe-ifcc asm-ifcc.s", "ifcc-link.txt"):
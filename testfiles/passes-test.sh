@@ -0,0 +1,217 @@
+#!/bin/bash
+# PASSES-TEST.SH : Vérifications des passes que la comparaison des sorties (ifcc-test.py) ne voit pas :
+# l'IR du front-end passe la vérification, chaque passe laisse sa marque dans l'IR ou l'assembleur
+# produit (calculs, tests, appels supprimés), et des pipelines partiels (--passes=...) compilent
+# encore les cas particuliers du front-end.
+#   make test-passes
+# Variables : IFCC (défaut compiler/ifcc, back-end x86), IFCC_OPT (défaut compiler/ifcc-opt).
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+IFCC=${IFCC:-$ROOT/compiler/ifcc}
+IFCC_OPT=${IFCC_OPT:-$ROOT/compiler/ifcc-opt}
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+status=0
+fail() {
+    echo "❌ $*" >&2
+    status=1
+}
+
+# test_path <test> : programme écrit dans le répertoire de travail, ou test de testfiles/
+test_path() {
+    if [ -f "$WORK/$1" ]; then
+        echo "$WORK/$1"
+    else
+        echo "$ROOT/testfiles/$1"
+    fi
+}
+
+# asm_count <test> <options> <instruction> <maximum> [<minimum>] : entre <minimum> (0 par défaut)
+# et <maximum> <instruction> dans l'assembleur (ou dans l'IR, avec --emit=ir)
+asm_count() {
+    if ! $IFCC $2 "$(test_path "$1")" > "$WORK/out.s"; then
+        fail "$1 ($2) : échec de la compilation"
+        return
+    fi
+    local count=$(grep -cE "^[[:space:]]+$3([[:space:]]|$)" "$WORK/out.s")
+    [ "$count" -le "$4" ] || fail "$1 ($2) : $count '$3' au lieu d'au plus $4"
+    [ "$count" -ge "${5:-0}" ] || fail "$1 ($2) : $count '$3' au lieu d'au moins $5"
+}
+
+# run_exit <test> <options> <code> : le programme compilé se termine avec le code attendu
+run_exit() {
+    if ! $IFCC $2 "$(test_path "$1")" > "$WORK/out.s" || ! gcc "$WORK/out.s" -o "$WORK/out"; then
+        fail "$1 ($2) : échec de la compilation"
+        return
+    fi
+    "$WORK/out" > /dev/null
+    local code=$?
+    [ "$code" -eq "$3" ] || fail "$1 ($2) : code de sortie $code au lieu de $3"
+}
+
+# remark <test> <options> <motif> : une des remarques des passes (--remarks) correspond au motif
+remark() {
+    if ! $IFCC $2 --remarks "$(test_path "$1")" > /dev/null 2> "$WORK/remarks.txt"; then
+        fail "$1 ($2) : échec de la compilation"
+        return
+    fi
+    grep -qE "$3" "$WORK/remarks.txt" || fail "$1 ($2) : aucune remarque '$3'"
+}
+
+# L'IR de chaque programme accepté par le front-end est valide (verify peut s'insérer entre deux passes)
+for src in "$ROOT"/testfiles/*.c; do
+    $IFCC --emit=ir "$src" > "$WORK/out.ir" 2> /dev/null || continue
+    $IFCC_OPT --passes=verify "$WORK/out.ir" > /dev/null || fail "$(basename "$src") : IR refusé par verify"
+done
+
+# Propagation de constantes : a > 2 et b == 6 dans pick, d - 3 dans main sont connus, aucun test ne reste
+asm_count 146_constant_propagation.c -O1 cmpl 0
+# Simplifications algébriques : y ^ y, (3 * y) | 0 et x & x ne sont plus calculés ; les copies
+# qu'elles laissent (x + 0, x * 1) sont propagées
+asm_count 147_algebraic_simplification.c -O1 '(xorl|orl|andl)' 0
+asm_count 147_algebraic_simplification.c "--passes=mem2reg,instcombine,copyprop --emit=ir" 'copy[[:space:]]+![0-9]+, ![0-9]+' 0
+# Numérotation locale : a * b, b * a et (a * b) après putchar ne sont calculés qu'une fois, a - b aussi
+asm_count 148_common_subexpressions.c "-O1 --emit=ir" mul 2
+asm_count 148_common_subexpressions.c "-O1 --emit=ir" sub 2
+# Numérotation globale : a * b une fois dans f ; a - b, calculé dans les deux branches de g, n'est
+# pas recalculé après la jonction
+asm_count 149_global_redundancy.c "-O2 --emit=ir" mul 2
+asm_count 149_global_redundancy.c "-O2 --emit=ir" sub 2
+# Copies : lo = a, s = +r, u = s disparaissent, il ne reste que les trois copies de l'échange de lo et hi
+asm_count 150_copy_chains.c "-O1 --emit=ir" 'copy[[:space:]]+![0-9]+, ![0-9]+' 3
+# Code mort : a * 3 dans f et x * x dans main ne sont pas calculés
+asm_count 151_dead_code.c "--passes=dce --emit=ir" mul 1
+# Écritures mortes : a = 1 et les relectures de valeurs déjà connues disparaissent sans mem2reg
+asm_count 152_dead_stores.c "--passes=dse,dce --emit=ir" wmem 5
+asm_count 152_dead_stores.c "--passes=dse,dce --emit=ir" rmem 5
+# Évaluation paresseuse : seul f = 1 && g(82, 5) produit un booléen par comparaison, les autres
+# opérandes de && et || branchent
+asm_count 154_short_circuit.c -O0 'set[a-z]+' 1
+asm_count 154_short_circuit.c "-O0 --emit=ir" 'logical_(and|or)' 0
+# Conversion des if : les petits if de max, min, sign et clamp deviennent des cmov, absolute un negl ;
+# guarded garde son branchement (guarded(17, 0) diviserait par zéro si la division était remontée)
+asm_count 156_if_conversion.c -O2 'cmov[a-z]+' 8 5
+asm_count 156_if_conversion.c -O2 negl 1 1
+asm_count 156_if_conversion.c -O2 'j(n?e|[lg]e?)' 2
+run_exit 156_if_conversion.c -O2 136
+# Simplification du CFG : les if vides ne laissent ni test ni saut, x = a && b n'est plus retesté
+asm_count 157_simplify_cfg.c -O1 jmp 2
+asm_count 157_simplify_cfg.c -O1 'j(n?e|[lg]e?)' 5
+# Placement des blocs : les retours d'erreur et les branches improbables sont émis dans .text.unlikely
+asm_count 158_branch_layout.c -O1 '\.section[[:space:]]+\.text\.unlikely,.*' 2 1
+# Diviseurs constants : multiplication par un nombre magique, sans idivl, à tous les niveaux
+# (coalesce ne doit pas partager la case d'une constante)
+for level in -O0 -O1 -O2; do
+    asm_count 153_strength_reduction.c "$level" idivl 0
+done
+# Seul 'keep' produit un booléen : les autres comparaisons sont fusionnées avec leur branchement
+for level in -O1 -O2; do
+    asm_count 155_compare_branch.c "$level" 'set[a-z]+' 1
+done
+# Intégration : clamp (always_inline) n'est plus appelée, twice (noinline) l'est toujours
+asm_count 160_inline.c -O2 '(call|jmp)[[:space:]]+clamp' 0
+asm_count 160_inline.c -O2 'call[[:space:]]+twice' 4 1
+# Récursion terminale : dix millions d'appels récursifs débordent la pile à -O0, pas une fois
+# transformés en boucle (avec un accumulateur pour 1 + count(n - 1))
+cat > "$WORK/deep_recursion.c" <<'EOF'
+int count(int n) {
+    if (n == 0) {
+        return 0;
+    }
+    return 1 + count(n - 1);
+}
+
+int skip(int n, int acc) {
+    if (n == 0) {
+        return acc;
+    }
+    return skip(n - 1, (acc + n) % 1000);
+}
+
+int main() {
+    return (count(10000000) + skip(10000000, 0)) % 256;
+}
+EOF
+for level in -O1 -O2; do
+    run_exit deep_recursion.c "$level" 128
+done
+# Appels purs : square(a) + square(a) n'appelle square qu'une fois et square(3) seul est supprimé
+# (restent un appel dans main, scaled et steps), les deux weight(10) sont fusionnés ; show écrit
+asm_count 162_pure_calls.c -O1 'call[[:space:]]+square' 3
+asm_count 162_pure_calls.c -O1 'call[[:space:]]+weight' 1 1
+asm_count 162_pure_calls.c -O1 'call[[:space:]]+show' 2 2
+# À -O2, gvn fusionne des appels purs identiques de main (square(a) + square(a), après ipcp) ;
+# square(k) ne dépend pas de la boucle créée par tailrec dans scaled : gvn le calcule avant elle
+remark 162_pure_calls.c -O2 'gvn\] main : 2 appel\(s\) pur\(s\) fusionné'
+remark 162_pure_calls.c -O2 'gvn\] scaled : 1 appel\(s\) pur\(s\) invariant'
+# Les entrées-sorties et l'appel d'une fonction qui peut ne pas terminer restent, même inutilisés
+cat > "$WORK/side_effects.c" <<'EOF'
+#include <stdio.h>
+
+int __attribute__((noinline)) spin(int n) {
+    if (n == 0) {
+        return 0;
+    }
+    return spin(n - 1);
+}
+
+int echo(int c) {
+    putchar(c);
+    return c;
+}
+
+int main() {
+    putchar(65);
+    echo(66);
+    getchar();
+    getchar();
+    spin(3);
+    return 0;
+}
+EOF
+for level in -O1 -O2; do
+    asm_count side_effects.c "$level" 'call[[:space:]]+putchar' 3 2
+    asm_count side_effects.c "$level" 'call[[:space:]]+getchar' 2 2
+    asm_count side_effects.c "$level" 'call[[:space:]]+spin' 1 1
+done
+# Propagation interprocédurale : k vaut 4 à tous les appels de scale, les trois appels de shift avec
+# mode = 1 passent par une copie spécialisée
+remark 161_ipcp.c -O2 'ipcp\] scale : même constante à tous les appels : k = 4'
+asm_count 161_ipcp.c -O2 'call[[:space:]]+shift\.constprop\.[0-9]+' 3 3
+# Trois groupes d'appels chauds, mais deux copies au plus : le troisième appelle la fonction d'origine
+cat > "$WORK/three_groups.c" <<'EOF'
+int __attribute__((noinline)) mix(int v, int mode) {
+    if (mode == 1) {
+        return v + 1;
+    }
+    if (mode == 2) {
+        return v * 2;
+    }
+    if (mode == 3) {
+        return v - 3;
+    }
+    return v;
+}
+
+int main() {
+    int s = mix(1, 1) + mix(2, 1) + mix(3, 2) + mix(4, 2);
+    s = (s + mix(5, 3) + mix(6, 3));
+    return s;
+}
+EOF
+asm_count three_groups.c -O2 'call[[:space:]]+mix\.constprop\.[01]' 4 4
+asm_count three_groups.c -O2 'call[[:space:]]+mix' 2 2
+run_exit three_groups.c -O2 24
+# Un return sans valeur lit une case que coalesce doit renuméroter comme les autres
+for passes in coalesce dce,coalesce; do
+    run_exit 88_void_function_no_param.c --passes=$passes 42
+done
+# ifcc-opt refuse une variable absente de la table des symboles au lieu de planter dans les passes
+for options in -O1 --passes=coalesce --emit=asm; do
+    printf 'function f()\nbb f_BB_0:\n  ret !0\n  exit\nend\n' | $IFCC_OPT $options - > /dev/null 2>&1
+    [ $? -eq 1 ] || fail "ifcc-opt $options : variable non déclarée acceptée"
+done
+
+[ $status -eq 0 ] && echo "✅ passes : toutes les vérifications réussies"
+exit $status